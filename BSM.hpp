@@ -41,11 +41,14 @@ namespace SiriusFM {
 
 	inline double BSMPxPut(double a_S0, double a_K, double a_TTE,
 						double a_rateA, double a_rateB, double a_sigma) {
-		
+		if (a_TTE <= 0)
+			// return payoff:
+			return std::max<double>(a_K - a_S0, 0);
+
 		// using Call-Put parity
-		double px = BSMPxCall(a_S0, a_K, a_TTE, a_rateA, a_rateB, a_sigma) - a_S0 
-													+ exp(- a_rateB * a_TTE) * a_K;
-		assert(px > 0.0);
+		double px = BSMPxCall(a_S0, a_K, a_TTE, a_rateA, a_rateB, a_sigma) 
+							- exp(- a_rateA * a_TTE) * a_S0 + exp(- a_rateB * a_TTE) * a_K;
+		assert(px >= 0.0);
 		return px;
 	}
 
@@ -60,14 +63,15 @@ namespace SiriusFM {
 		double xd = a_sigma * sqrt(a_TTE);
 		double x1 = (log(a_S0 / a_K) + 
 					(a_rateB - a_rateA + a_sigma * a_sigma / 2.0) * a_TTE) / xd;
-    	return Phi(x1);
+		return exp(- a_rateA * a_TTE) * Phi(x1);
 	}
 
 	inline double BSMDeltaPut (double a_S0, double a_K, double a_TTE,
 								double a_rateA, double a_rateB, double a_sigma) {
 
 		// from Call-Put parity:
-		return BSMDeltaCall(a_S0, a_K, a_TTE, a_rateA, a_rateB, a_sigma) - 1;
+		return BSMDeltaCall(a_S0, a_K, a_TTE, a_rateA, a_rateB, a_sigma) 
+						- exp(- a_rateA * std::max<double>(a_TTE, 0));
 	}
 
 }
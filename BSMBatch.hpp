@@ -0,0 +1,199 @@
+//==========================================================================//
+//                              "BSMBatch.hpp"                              //
+// Black-Scholes-Merton prices, Greeks and Implied Vols for arrays of       //
+// vanilla options                                                          //
+//--------------------------------------------------------------------------//
+// All inputs and outputs are SoA arrays of length a_n (the i-th option is  //
+// given by a_isCall[i], a_S0[i], a_K[i], ...; outputs must not alias the   //
+// inputs). The loop bodies are branch-free and use "FastMath.h" instead of //
+// libm, so they are vectorized by the compiler (given -fno-math-errno,     //
+// otherwise sqrt is a libm call). Conventions are the same as in           //
+// "BSM.hpp": A is the underlying ccy (rateA acts as a dividend yield),     //
+// B is the pricing ccy                                                     //
+//==========================================================================//
+
+#pragma once
+
+#include "FastMath.h"
+#include <cmath>
+#include <limits>
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// Prices:                                                                //
+	//------------------------------------------------------------------------//
+	// With w = +1 for a Call and -1 for a Put:                               //
+	// px = w (S0 DFA Phi(w x1) - K DFB Phi(w x2)), or the payoff if TTE <= 0 //
+	//------------------------------------------------------------------------//
+	inline void BSMPxBatch
+	(
+		int 						a_n,
+		bool 	 const* a_isCall,
+		double const* a_S0,
+		double const* a_K,
+		double const* a_TTE,
+		double const* a_rateA,
+		double const* a_rateB,
+		double const* a_sigma,
+		double* __restrict__ a_px
+	) {
+		// (GCC does not vectorize loads of bool, but does those of uchar):
+		unsigned char const* isCall =
+			reinterpret_cast<unsigned char const*>(a_isCall);
+
+		for (int i = 0; i < a_n; ++i) {
+			double w 		= isCall[i] ? 1.0 : -1.0;
+			double S0 	= a_S0[i];
+			double K  	= a_K[i];
+			double TTE 	= a_TTE[i];
+			double xd 	= a_sigma[i] * std::sqrt(TTE);
+			double x1 	= (FastLog(S0 / K) +
+				(a_rateB[i] - a_rateA[i]) * TTE) / xd + 0.5 * xd;
+			double x2 	= x1 - xd;
+			double SA 	= S0 * FastExp(- a_rateA[i] * TTE);
+			double KB 	= K  * FastExp(- a_rateB[i] * TTE);
+			double px 	= w * (SA * FastPhi(w * x1) - KB * FastPhi(w * x2));
+			double pay 	= std::max<double>(w * (S0 - K), 0.0);
+			a_px[i] 		= (TTE > 0) ? px : pay;
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// Greeks:                                                                //
+	//------------------------------------------------------------------------//
+	// delta = dPx/dS0, gamma = d2Px/dS0^2, vega = dPx/dsigma, and theta is   //
+	// the decay in calendar time, ie -dPx/dTTE (per year). All Greeks are    //
+	// computed in one pass, so all output ptrs must be non-NULL:             //
+	//------------------------------------------------------------------------//
+	inline void BSMGreeksBatch
+	(
+		int 						a_n,
+		bool 	 const* a_isCall,
+		double const* a_S0,
+		double const* a_K,
+		double const* a_TTE,
+		double const* a_rateA,
+		double const* a_rateB,
+		double const* a_sigma,
+		double* __restrict__ a_delta,
+		double* __restrict__ a_gamma,
+		double* __restrict__ a_vega,
+		double* __restrict__ a_theta
+	) {
+		// (GCC does not vectorize loads of bool, but does those of uchar):
+		unsigned char const* isCall =
+			reinterpret_cast<unsigned char const*>(a_isCall);
+
+		for (int i = 0; i < a_n; ++i) {
+			double w 		 = isCall[i] ? 1.0 : -1.0;
+			double S0 	 = a_S0[i];
+			double K  	 = a_K[i];
+			double TTE 	 = a_TTE[i];
+			double rateA = a_rateA[i];
+			double rateB = a_rateB[i];
+			double sigma = a_sigma[i];
+			double sqT 	 = std::sqrt(TTE);
+			double xd 	 = sigma * sqT;
+			double x1 	 = (FastLog(S0 / K) + (rateB - rateA) * TTE) / xd + 0.5 * xd;
+			double x2 	 = x1 - xd;
+			double DFA 	 = FastExp(- rateA * TTE);
+			double SAphi = S0 * DFA * FastPhiDens(x1); // == K DFB phi(x2)
+			double Px1 	 = FastPhi(w * x1);
+			double Px2 	 = FastPhi(w * x2);
+			double KB 	 = K * FastExp(- rateB * TTE);
+			double th 	 = - 0.5 * SAphi * sigma / sqT +
+										 w * (rateA * S0 * DFA * Px1 - rateB * KB * Px2);
+			bool 	 live  = (TTE > 0);
+
+			a_delta[i] 	 = live ? w * DFA * Px1 : ((w * (S0 - K) > 0) ? w : 0.0);
+			a_gamma[i] 	 = live ? SAphi / (S0 * S0 * xd) : 0.0;
+			a_vega [i] 	 = live ? SAphi * sqT 			: 0.0;
+			a_theta[i] 	 = live ? th 								: 0.0;
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// Implied Vols:                                                          //
+	//------------------------------------------------------------------------//
+	// The price is normalized by sqrt(F K) DFB (F being the Fwd) and reduced //
+	// to the OTM option via Call-Put parity; by symmetry the normalized OTM  //
+	// price b(v) depends on |x| only, x = log(F/K), v = sigma sqrt(TTE):     //
+	//   b(v) = e^{x/2} Phi(x/v + v/2) - e^{-x/2} Phi(x/v - v/2),  x <= 0.    //
+	// log b(v) - log b* = 0 is solved by a fixed number of Halley steps from //
+	// the Corrado-Miller guess, safeguarded by bisection of the bracket      //
+	// maintained on v. The result is NaN if the price violates the no-arb    //
+	// bounds or TTE <= 0; relative accuracy is ~1e-10 or better for |x|/v<4: //
+	//------------------------------------------------------------------------//
+	constexpr int BSMImplVolIters = 6;
+
+	inline void BSMImplVolBatch
+	(
+		int 						a_n,
+		bool 	 const* a_isCall,
+		double const* a_px,
+		double const* a_S0,
+		double const* a_K,
+		double const* a_TTE,
+		double const* a_rateA,
+		double const* a_rateB,
+		double* __restrict__ a_sigma
+	) {
+		constexpr double Sqrt2Pi = 2.50662827463100050242;
+		constexpr double VMax 	 = 100.0;
+		constexpr double NaN 		 = std::numeric_limits<double>::quiet_NaN();
+		unsigned char const* isCall =
+			reinterpret_cast<unsigned char const*>(a_isCall);
+
+		for (int i = 0; i < a_n; ++i) {
+			double w 	 	= isCall[i] ? 1.0 : -1.0;
+			double TTE 	= a_TTE[i];
+			double DFB 	= FastExp(- a_rateB[i] * TTE);
+			double F 	 	= a_S0[i] * FastExp((a_rateB[i] - a_rateA[i]) * TTE);
+			double K 	 	= a_K[i];
+			double sFK 	= std::sqrt(F * K);
+			double x 	 	= FastLog(F / K);
+			double bt 	= a_px[i] / (DFB * sFK);
+
+			// Reduce to the OTM option, then use the symmetry x -> -x:
+			double ex 	= FastExp(0.5 * x);
+			double emx 	= 1.0 / ex;
+			double intr = w * (ex - emx); 		// normalized intrinsic value
+			bt  				= (intr > 0) ? bt - intr : bt;
+			x 	 				= - std::fabs(x);
+			ex 	 				= std::min<double>(ex, emx);
+			emx 	 			= 1.0 / ex;
+			bool valid 	= (TTE > 0) && (bt > 0) && (bt < ex);
+			bt 					= valid ? bt : 0.5 * ex; // keep the iterations finite
+			double lbt 	= FastLog(bt);
+
+			// Corrado-Miller guess (in normalized units, F = ex, K = emx):
+			double h 		= bt - 0.5 * (ex - emx);
+			double disc = h * h - (ex - emx) * (ex - emx) / M_PI;
+			double v 		= Sqrt2Pi / (ex + emx) *
+										(h + std::sqrt(std::max<double>(disc, 0.0)));
+			v 					= (v > 1e-8) ? std::min<double>(v, VMax)
+															 : std::sqrt(2.0 * std::fabs(x)) + 1e-8;
+			double lo 	= 0.0;
+			double hi 	= VMax;
+
+#			pragma GCC unroll 8
+			for (int it = 0; it < BSMImplVolIters; ++it) {
+				double x1  = x / v + 0.5 * v;
+				double x2  = x1 - v;
+				double b 	 = ex * FastPhi(x1) - emx * FastPhi(x2);
+				double bp  = ex * FastPhiDens(x1); 	// db/dv
+				double f 	 = FastLog(b) - lbt;
+				lo 				 = (f <= 0) ? std::max<double>(lo, v) : lo;
+				hi 				 = (f >  0) ? std::min<double>(hi, v) : hi;
+				double fp  = bp / b;
+				double fpp = fp * x1 * x2 / v - fp * fp;
+				double d 	 = f / fp; 												// Newton step
+				double vn  = v - d / (1.0 - 0.5 * d * fpp / fp); // Halley step
+				bool 	 in  = (vn >= lo) && (vn <= hi) && (vn > 0);
+				v 				 = in ? vn : 0.5 * (lo + hi);
+			}
+			a_sigma[i] = valid ? v / std::sqrt(TTE) : NaN;
+		}
+	}
+}
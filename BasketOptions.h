@@ -0,0 +1,154 @@
+//==========================================================================//
+//                             "BasketOptions.h"                            //
+// Declaration of European multi-asset options: Basket, Spread and Best-Of  //
+//==========================================================================//
+
+#pragma once
+
+#include "OptionND.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// Basket Call/Put on Sum_d w_d S_d(T):                                   //
+	//------------------------------------------------------------------------//
+	template<typename AssetClassA, typename AssetClassB>
+	class BasketOption final: public OptionND<AssetClassA, AssetClassB> {
+		private:
+			double* const m_ws; // [N]: weights
+			double 	const m_K;
+			bool 		const m_isCall;
+
+		public:
+			BasketOption
+			(
+				int 							 a_N,
+				AssetClassA const* a_assetsA,
+				AssetClassB 			 a_assetB,
+				double const* 		 a_ws,
+				double 						 a_K,
+				bool 							 a_isCall,
+				time_t 						 a_expirTime
+			)
+			: OptionND<AssetClassA, AssetClassB>(a_N, a_assetsA, a_assetB,
+																					 a_expirTime, false),
+				m_ws 		(new double[a_N]),
+				m_K 		(a_K),
+				m_isCall(a_isCall)
+			{
+				if (m_K < 0 || a_ws == nullptr) {
+					delete[] m_ws;
+					throw std::invalid_argument("invalid basket");
+				}
+				for (int d = 0; d < a_N; ++d)
+					m_ws[d] = a_ws[d];
+			}
+
+			~BasketOption() override {
+				delete[] m_ws;
+			}
+
+			double Payoff(long a_L, double const* a_paths,
+										double const* a_ts = nullptr) const override
+			{
+				assert(a_L > 0 && a_paths != nullptr);
+				int N = this->m_N;
+				double const* ST = a_paths + (a_L - 1) * N;
+				double B = 0;
+				for (int d = 0; d < N; ++d)
+					B += m_ws[d] * ST[d];
+				return std::max<double>(m_isCall ? B - m_K : m_K - B, 0.0);
+			}
+	};
+
+	//------------------------------------------------------------------------//
+	// Spread Call/Put on S_0(T) - S_1(T):                                    //
+	//------------------------------------------------------------------------//
+	template<typename AssetClassA, typename AssetClassB>
+	class SpreadOption final: public OptionND<AssetClassA, AssetClassB> {
+		private:
+			double const m_K; // may be negative
+			bool 	 const m_isCall;
+
+		public:
+			SpreadOption
+			(
+				AssetClassA const* a_assetsA, // [2]
+				AssetClassB 			 a_assetB,
+				double 						 a_K,
+				bool 							 a_isCall,
+				time_t 						 a_expirTime
+			)
+			: OptionND<AssetClassA, AssetClassB>(2, a_assetsA, a_assetB,
+																					 a_expirTime, false),
+				m_K 		(a_K),
+				m_isCall(a_isCall)
+			{}
+
+			~SpreadOption() override {}
+
+			double Payoff(long a_L, double const* a_paths,
+										double const* a_ts = nullptr) const override
+			{
+				assert(a_L > 0 && a_paths != nullptr);
+				double const* ST = a_paths + (a_L - 1) * 2;
+				double X = ST[0] - ST[1];
+				return std::max<double>(m_isCall ? X - m_K : m_K - X, 0.0);
+			}
+	};
+
+	//------------------------------------------------------------------------//
+	// Best-Of Call / Worst-Of Put on Max_d S_d(T) / Min_d S_d(T):            //
+	//------------------------------------------------------------------------//
+	template<typename AssetClassA, typename AssetClassB>
+	class BestOfOption final: public OptionND<AssetClassA, AssetClassB> {
+		private:
+			double const m_K;
+			bool 	 const m_isCall; // Call on the best, or Put on the worst
+
+		public:
+			BestOfOption
+			(
+				int 							 a_N,
+				AssetClassA const* a_assetsA,
+				AssetClassB 			 a_assetB,
+				double 						 a_K,
+				bool 							 a_isCall,
+				time_t 						 a_expirTime
+			)
+			: OptionND<AssetClassA, AssetClassB>(a_N, a_assetsA, a_assetB,
+																					 a_expirTime, false),
+				m_K 		(a_K),
+				m_isCall(a_isCall)
+			{
+				if (m_K <= 0)
+					throw std::invalid_argument("K must be positive");
+			}
+
+			~BestOfOption() override {}
+
+			double Payoff(long a_L, double const* a_paths,
+										double const* a_ts = nullptr) const override
+			{
+				assert(a_L > 0 && a_paths != nullptr);
+				int N = this->m_N;
+				double const* ST = a_paths + (a_L - 1) * N;
+				double X = ST[0];
+				for (int d = 1; d < N; ++d)
+					X = m_isCall ? std::max<double>(X, ST[d])
+											 : std::min<double>(X, ST[d]);
+				return std::max<double>(m_isCall ? X - m_K : m_K - X, 0.0);
+			}
+	};
+
+	//-----------------------------------------------------------------------//
+	// Aliases:                                                              //
+	//-----------------------------------------------------------------------//
+	using BasketOptionFX = BasketOption<CcyE, CcyE>;
+	using SpreadOptionFX = SpreadOption<CcyE, CcyE>;
+	using BestOfOptionFX = BestOfOption<CcyE, CcyE>;
+}
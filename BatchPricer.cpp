@@ -0,0 +1,749 @@
+//==========================================================================//
+//                              "BatchPricer.cpp"                           //
+// Batch pricing of a portfolio of vanilla options on a work-stealing pool  //
+//--------------------------------------------------------------------------//
+// The portfolio file has one option per line ('#' starts a comment line):  //
+//   id {Call|Put} K Tdays isAmerican ccyA ccyB {MC|Grid} tauMins {P|NS}    //
+//   S0 model volParams...                                                  //
+// where P is the # of MC paths (and as many antithetic ones), NS the # of  //
+// grid S-intervals, and the models with their vol params (in the order of  //
+// "GetVolParams") are: GBM sigma; CEV sigma beta; Lipton sigma0 sigma1     //
+// sigma2; Merton sigma lambda muJ sigmaJ; Kou sigma lambda p eta1 eta2     //
+// (the jump-diffusions by MC only).                                        //
+// The options of the same model, underlying, expiry and engine params are  //
+// priced by one job: an MC job evaluates all of their payoffs on the same  //
+// paths, a grid job runs "RunBwdBatch" for all of them at once. The jobs   //
+// are run on "WorkStealingPool" in the order of their estimated costs, so  //
+// the long MC jobs do not end up at the tail of the batch. Each worker     //
+// keeps its own MC engines and grids (one per model), made on first use.   //
+// MC jobs use the fixed seed, so the results do not depend on scheduling.  //
+// With "cacheFile", the results are memoized in "PxCache" (persistent in   //
+// that file; in memory only if it is ""), so that re-pricing with the same //
+// inputs and t0 is free. The results go to a CSV file, or in the binary    //
+// format of "BatchResults.h" if the output file name ends with ".bin":     //
+//   BatchPricer portfolioFile ratesFileA ratesFileB outFile                //
+//               [nThreads=0 [cacheFile [t0=now]]]                          //
+//==========================================================================//
+
+#include "DiffusionGBM.h"
+#include "DiffusionCEV.h"
+#include "DiffusionLipton.h"
+#include "DiffusionMerton.h"
+#include "DiffusionKou.h"
+#include "DiffusionTraits.h"
+#include "IRProviderConst.h"
+#include "VanillaOption.h"
+#include "MCEngine1D.hpp"
+#include "GridNOP1D_S3_RKC1.hpp"
+#include "WorkStealingPool.h"
+#include "BatchResults.h"
+#include "PxCache.h"
+#include "Instr.h"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <tuple>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cassert>
+
+using namespace SiriusFM;
+using namespace std;
+
+namespace {
+	enum class ModelE: int {
+		GBM 		= 0,
+		CEV 		= 1,
+		Lipton 	= 2,
+		Merton 	= 3,
+		Kou 		= 4,
+		N 			= 5
+	};
+
+	constexpr char const* ModelNames[int(ModelE::N)] =
+		{"GBM", "CEV", "Lipton", "Merton", "Kou"};
+
+	constexpr int NModelParams[int(ModelE::N)] =
+	{
+		DiffusionGBM::NVolParams, 		DiffusionCEV::NVolParams,
+		DiffusionLipton::NVolParams, 	DiffusionMerton::NVolParams,
+		DiffusionKou::NVolParams
+	};
+
+	constexpr int MaxModelParams = 5;
+
+	enum class EngineE: int {
+		MC 		= 0,
+		Grid 	= 1
+	};
+
+	// Relative costs of an MC path step, an MC payoff and a grid node update
+	// (per option), as measured by "Bench"; used for the job ordering only:
+	constexpr double MCStepCost 	= 10.0;
+	constexpr double MCPayoffCost = 2.0;
+	constexpr double GridNodeCost = 1.0;
+
+	// In-memory paths of each MC engine (doubles; a power of 2, see "PriceJob"):
+	constexpr long MCPathBudget = 1L << 22;
+
+	//------------------------------------------------------------------------//
+	// "OptionSpec": a line of the portfolio file:                            //
+	//------------------------------------------------------------------------//
+	struct OptionSpec {
+		char 		m_id[BatchIDLen];
+		bool 		m_isCall;
+		double 	m_K;
+		long 		m_Tdays;
+		bool 		m_isAmerican;
+		CcyE 		m_ccyA;
+		CcyE 		m_ccyB;
+		EngineE m_engine;
+		int 		m_tauMins;
+		long 		m_PNS; 		// # of MC paths or of grid S-intervals
+		double 	m_S0;
+		ModelE 	m_model;
+		double 	m_params[MaxModelParams];
+	};
+
+	// The options are priced by the same job iff all of these are equal:
+	constexpr int JobKeyLen = 8 + MaxModelParams;
+
+	void MkJobKey(OptionSpec const& a_spec, double* a_key) {
+		a_key[0] = double(a_spec.m_model);
+		a_key[1] = double(a_spec.m_engine);
+		a_key[2] = double(a_spec.m_ccyA);
+		a_key[3] = double(a_spec.m_ccyB);
+		a_key[4] = double(a_spec.m_Tdays);
+		a_key[5] = double(a_spec.m_tauMins);
+		a_key[6] = double(a_spec.m_PNS);
+		a_key[7] = a_spec.m_S0;
+		for (int k = 0; k < MaxModelParams; ++k)
+			a_key[8 + k] = a_spec.m_params[k];
+	}
+
+	//------------------------------------------------------------------------//
+	// "BatchJob": options priced together:                                   //
+	//------------------------------------------------------------------------//
+	struct BatchJob {
+		vector<int> m_opts; // indices in the portfolio
+		double 			m_cost; // estimated
+		double 			m_secs; // wall time
+	};
+
+	// # of time steps of [0, Tdays] by "a_tauMins" (as in the engines):
+	long NSteps(long a_Tdays, int a_tauMins) {
+		long Tsec 	= a_Tdays * SEC_IN_DAY;
+		long tauSec = long(a_tauMins) * SEC_IN_MIN;
+		return (Tsec % tauSec == 0) ? Tsec / tauSec : Tsec / tauSec + 1;
+	}
+
+	double JobCost(OptionSpec const& a_spec, int a_nOpts) {
+		double M = double(NSteps(a_spec.m_Tdays, a_spec.m_tauMins));
+		double n = double(a_nOpts);
+		double P = double(a_spec.m_PNS);
+		return (a_spec.m_engine == EngineE::MC)
+					 ? 2.0 * P * ((M + 1) * MCStepCost + n * MCPayoffCost)
+					 : (P + 1) * M * (1.0 + n) * GridNodeCost;
+	}
+
+	//------------------------------------------------------------------------//
+	// "MultiOPPathEval": evaluates all options of a job on the same paths.   //
+	// Relies on the "MCEngine1D" layout of the in-memory paths: the path     //
+	// "p" < PM/2 and "PM/2 + p" are antithetic, so their mean payoff is one  //
+	// independent sample, which gives the true StdErr of the price:          //
+	//------------------------------------------------------------------------//
+	class MultiOPPathEval {
+		private:
+			OptionFX const* const* m_opts;
+			int 	 	m_n;
+			long 		m_P; 		 // # of antithetic pairs
+			double* m_sums;  // [m_n]
+			double* m_sums2; // [m_n]
+
+		public:
+			MultiOPPathEval(OptionFX const* const* a_opts, int a_n)
+			: m_opts (a_opts),
+				m_n 	 (a_n),
+				m_P 	 (0),
+				m_sums (new double[a_n]),
+				m_sums2(new double[a_n])
+			{
+				assert(m_opts != nullptr && m_n > 0);
+				for (int k = 0; k < m_n; ++k) {
+					m_sums [k] = 0;
+					m_sums2[k] = 0;
+				}
+			}
+
+			~MultiOPPathEval() {
+				delete[] m_sums;
+				delete[] m_sums2;
+			}
+
+			MultiOPPathEval(MultiOPPathEval const&) = delete;
+			MultiOPPathEval& operator=(MultiOPPathEval const&) = delete;
+
+			void operator() (long a_L, long a_PM, double const* a_paths,
+											 double const* a_ts)
+			{
+				assert(a_PM % 2 == 0);
+				long PMh = a_PM / 2;
+				for (int k = 0; k < m_n; ++k) {
+					OptionFX const* opt = m_opts[k];
+					double s = 0, s2 = 0;
+					for (long p = 0; p < PMh; ++p) {
+						double y = 0.5 * (opt->Payoff(a_L, a_paths + p * a_L, a_ts) +
+										opt->Payoff(a_L, a_paths + (PMh + p) * a_L, a_ts));
+						s  += y;
+						s2 += y * y;
+					}
+					m_sums [k] += s;
+					m_sums2[k] += s2;
+				}
+				m_P += PMh;
+				SFM_INSTR(g_instr.m_payoffs += m_n * a_PM;)
+			}
+
+			// E[payoff] and its StdErr, for the option "a_k":
+			std::tuple<double, double> GetPxErr(int a_k) const {
+				assert(0 <= a_k && a_k < m_n);
+				if (m_P < 2)
+					throw std::runtime_error("empty MultiOPPathEval");
+
+				double n 	 = double(m_P);
+				double px  = m_sums[a_k] / n;
+				double var = std::max<double>
+											 ((m_sums2[a_k] - n * px * px) / (n - 1.0), 0.0);
+				return std::make_tuple(px, sqrt(var / n));
+			}
+	};
+
+	//------------------------------------------------------------------------//
+	// Per-worker MC engine and grid of a model:                              //
+	//------------------------------------------------------------------------//
+	template<typename Diffusion1D>
+	struct ModelCtx {
+		using MCE  = MCEngine1D<Diffusion1D, IRPConst, IRPConst, CcyE, CcyE,
+														MultiOPPathEval>;
+		using Grid = GridNOP1D_S3_RKC1<Diffusion1D, IRPConst, IRPConst, CcyE,
+																	 CcyE>;
+		MCE*  m_mce  = nullptr;
+		Grid* m_grid = nullptr;
+
+		ModelCtx() = default;
+		ModelCtx(ModelCtx const&) = delete;
+		ModelCtx& operator=(ModelCtx const&) = delete;
+
+		~ModelCtx() {
+			delete m_mce;
+			delete m_grid;
+		}
+	};
+
+	using WorkerCtx = std::tuple
+	<
+		ModelCtx<DiffusionGBM>, 	ModelCtx<DiffusionCEV>,
+		ModelCtx<DiffusionLipton>,ModelCtx<DiffusionMerton>,
+		ModelCtx<DiffusionKou>
+	>;
+
+	//------------------------------------------------------------------------//
+	// "BatchCtx": the data shared (read-only) by all workers:                //
+	//------------------------------------------------------------------------//
+	struct BatchCtx {
+		char const* 			 m_ratesFileA;
+		char const* 			 m_ratesFileB;
+		IRPConst 					 m_irpA;
+		IRPConst 					 m_irpB;
+		time_t 						 m_t0;
+		long 							 m_maxL; // max MC path length over all jobs
+		vector<OptionSpec> m_specs;
+		PxCache* 					 m_cache; 		// optional
+		SpecKey 					 m_ratesKey;
+	};
+
+	//------------------------------------------------------------------------//
+	// "PriceJob": prices all options of "a_job" into "a_res" (indexed as the //
+	// portfolio); throws on failure:                                         //
+	//------------------------------------------------------------------------//
+	template<typename Diffusion1D>
+	void PriceJob(BatchCtx const& a_ctx, BatchJob const& a_job,
+								ModelCtx<Diffusion1D>& a_mc, BatchRes* a_res)
+	{
+		OptionSpec const& s0 = a_ctx.m_specs[a_job.m_opts[0]];
+		Diffusion1D diff(0.0, s0.m_params, s0.m_S0); // trend is irrelevant (RN)
+		time_t T = a_ctx.m_t0 + SEC_IN_DAY * s0.m_Tdays;
+		int 	 n = int(a_job.m_opts.size());
+
+		vector<unique_ptr<OptionFX const>> own(n);
+		vector<OptionFX const*> 					 opts(n);
+		for (int k = 0; k < n; ++k) {
+			OptionSpec const& s = a_ctx.m_specs[a_job.m_opts[k]];
+			if (s.m_isCall)
+				own[k].reset(new CallOptionFX(s.m_ccyA, s.m_ccyB, s.m_K, T,
+																			s.m_isAmerican));
+			else
+				own[k].reset(new PutOptionFX (s.m_ccyA, s.m_ccyB, s.m_K, T,
+																			s.m_isAmerican));
+			opts[k] = own[k].get();
+		}
+
+		if (s0.m_engine == EngineE::MC) {
+			for (int k = 0; k < n; ++k)
+				if (opts[k]->m_isAmerican)
+					throw std::invalid_argument("MC cannot price American options");
+
+			// the engine holds exactly "MCPathBudget" points (its max L is
+			// rounded up to a power of 2), so the # of paths per batch, and the
+			// prices, depend on the job`s own L only, not on the rest of the
+			// portfolio (through "m_maxL"), as the cache keys assume:
+			if (a_mc.m_mce == nullptr) {
+				long maxL = 1;
+				while (maxL < a_ctx.m_maxL)
+					maxL <<= 1;
+				a_mc.m_mce = new typename ModelCtx<Diffusion1D>::MCE
+					(maxL, std::max<long>(2, MCPathBudget / maxL));
+			}
+
+			// with a cache, only the missing results are simulated (the result
+			// of an option does not depend on the others priced on the paths):
+			vector<SpecKey> keys(n, SpecKey{0, 0});
+			vector<int> 		miss;
+			SpecHasher h0;
+			h0.Add("BatchPricer::MC");
+			if (a_ctx.m_cache != nullptr && HashDiffusion(h0, diff)) {
+				h0.Add(a_ctx.m_ratesKey).Add(int64_t(a_ctx.m_t0)).Add(s0.m_tauMins)
+					.Add(s0.m_PNS);
+
+				for (int k = 0; k < n; ++k) {
+					SpecHasher h = h0;
+					PxVal 		 val;
+					if (opts[k]->HashSpec(h)) {
+						keys[k] = h.GetKey();
+						if (a_ctx.m_cache->Get(keys[k], &val)) {
+							a_res[a_job.m_opts[k]].m_px 		= val.m_px;
+							a_res[a_job.m_opts[k]].m_stdErr = val.m_stdErr;
+							continue;
+						}
+					}
+					miss.push_back(k);
+				}
+			}
+			else
+				for (int k = 0; k < n; ++k)
+					miss.push_back(k);
+
+			int nM = int(miss.size());
+			if (nM == 0)
+				return;
+
+			vector<OptionFX const*> mOpts(nM);
+			for (int m = 0; m < nM; ++m)
+				mOpts[m] = opts[miss[m]];
+
+			MultiOPPathEval pathEval(mOpts.data(), nM);
+			a_mc.m_mce->template Simulate<true>
+				(a_ctx.m_t0, T, s0.m_tauMins, s0.m_PNS, false, &diff, &a_ctx.m_irpA,
+				 &a_ctx.m_irpB, s0.m_ccyA, s0.m_ccyB, &pathEval);
+
+			double df = a_ctx.m_irpB.DF(s0.m_ccyB, a_ctx.m_t0, T);
+			for (int m = 0; m < nM; ++m) {
+				int 			k = miss[m];
+				BatchRes& r = a_res[a_job.m_opts[k]];
+				auto pe 	 	= pathEval.GetPxErr(m);
+				r.m_px 			= df * get<0>(pe);
+				r.m_stdErr 	= df * get<1>(pe);
+				if (!keys[k].IsEmpty())
+					a_ctx.m_cache->Put(keys[k], PxVal{r.m_px, NAN, NAN, r.m_stdErr});
+			}
+		}
+		else {
+			if constexpr (HasJumps<Diffusion1D>::value)
+				throw std::invalid_argument("grid cannot price jump-diffusions");
+			else {
+				if (a_mc.m_grid == nullptr) {
+					a_mc.m_grid = new typename ModelCtx<Diffusion1D>::Grid
+						(a_ctx.m_ratesFileA, a_ctx.m_ratesFileB);
+					a_mc.m_grid->SetCache(a_ctx.m_cache, a_ctx.m_ratesKey);
+				}
+
+				vector<std::tuple<double, double, double>> pdg(n);
+				a_mc.m_grid->RunBwdBatch(opts.data(), n, &diff, s0.m_S0, a_ctx.m_t0,
+																 pdg.data(), s0.m_PNS, s0.m_tauMins);
+				for (int k = 0; k < n; ++k) {
+					BatchRes& r = a_res[a_job.m_opts[k]];
+					r.m_px 			= get<0>(pdg[k]);
+					r.m_delta 	= get<1>(pdg[k]);
+					r.m_gamma 	= get<2>(pdg[k]);
+				}
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// "ParsePortfolio": returns false (having reported the line) on error:   //
+	//------------------------------------------------------------------------//
+	bool ParsePortfolio(char const* a_file, vector<OptionSpec>* a_specs) {
+		constexpr int BUF_SIZE = 512;
+
+		FILE* src = fopen(a_file, "r");
+		if (src == nullptr) {
+			cerr << "Cannot open " << a_file << endl;
+			return false;
+		}
+
+		char buf[BUF_SIZE];
+		int  line = 0;
+		bool ok 	= true;
+
+		while (ok && fgets(buf, BUF_SIZE, src) != nullptr) {
+			++line;
+			char const* b = buf;
+			while (*b == ' ' || *b == '\t')
+				++b;
+			if (*b == '\0' || *b == '\n' || *b == '#')
+				continue;
+
+			OptionSpec s = {};
+			char type[8], ccyA[8], ccyB[8], engine[8], model[16];
+			int  isAmer = 0, off = 0;
+			int  nf = sscanf(b, "%31s %7s %lf %ld %d %7s %7s %7s %d %ld %lf %15s%n",
+											 s.m_id, type, &s.m_K, &s.m_Tdays, &isAmer, ccyA, ccyB,
+											 engine, &s.m_tauMins, &s.m_PNS, &s.m_S0, model, &off);
+			if (nf != 12) {
+				cerr << "Line " << line << ": invalid format" << endl;
+				ok = false;
+				break;
+			}
+
+			s.m_isAmerican = bool(isAmer);
+			int m = 0;
+			while (m < int(ModelE::N) && strcmp(model, ModelNames[m]) != 0)
+				++m;
+
+			if (strcmp(type, "Call") == 0)
+				s.m_isCall = true;
+			else if (strcmp(type, "Put") == 0)
+				s.m_isCall = false;
+			else {
+				cerr << "Line " << line << ": invalid option type" << endl;
+				ok = false;
+				break;
+			}
+
+			if (strcmp(engine, "MC") == 0)
+				s.m_engine = EngineE::MC;
+			else if (strcmp(engine, "Grid") == 0)
+				s.m_engine = EngineE::Grid;
+			else {
+				cerr << "Line " << line << ": invalid engine" << endl;
+				ok = false;
+				break;
+			}
+
+			if (m == int(ModelE::N)) {
+				cerr << "Line " << line << ": invalid model" << endl;
+				ok = false;
+				break;
+			}
+			s.m_model = ModelE(m);
+
+			// the vol params:
+			char const* p = b + off;
+			int 				np = 0;
+			while (true) {
+				char* end = nullptr;
+				double v 	= strtod(p, &end);
+				if (end == p)
+					break;
+				if (np == MaxModelParams) {
+					np = -1;
+					break;
+				}
+				s.m_params[np++] = v;
+				p = end;
+			}
+			while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
+				++p;
+
+			if (np != NModelParams[m] || *p != '\0') {
+				cerr << "Line " << line << ": expected " << NModelParams[m]
+						 << " vol params of " << model << endl;
+				ok = false;
+				break;
+			}
+
+			try {
+				s.m_ccyA = Str2CcyE(ccyA);
+				s.m_ccyB = Str2CcyE(ccyB);
+			}
+			catch (std::exception const& e) {
+				cerr << "Line " << line << ": " << e.what() << endl;
+				ok = false;
+				break;
+			}
+
+			if (!(s.m_K > 0 && s.m_Tdays > 0 && s.m_tauMins > 0 && s.m_PNS > 0 &&
+						s.m_S0 > 0))
+			{
+				cerr << "Line " << line << ": invalid params" << endl;
+				ok = false;
+				break;
+			}
+			a_specs->push_back(s);
+		}
+		fclose(src);
+		return ok;
+	}
+
+	//------------------------------------------------------------------------//
+	// "MkJobs": groups the options into jobs:                                //
+	//------------------------------------------------------------------------//
+	vector<BatchJob> MkJobs(vector<OptionSpec> const& a_specs) {
+		int n = int(a_specs.size());
+		vector<double> keys(size_t(n) * JobKeyLen);
+		for (int i = 0; i < n; ++i)
+			MkJobKey(a_specs[i], keys.data() + size_t(i) * JobKeyLen);
+
+		auto keyOf = [&keys](int a_i) { return keys.data() + a_i * JobKeyLen; };
+
+		// sort the options by their keys (stable, so that the options within
+		// a job keep the portfolio order), then cut the runs of equal keys:
+		vector<int> order(n);
+		for (int i = 0; i < n; ++i)
+			order[i] = i;
+		std::stable_sort(order.begin(), order.end(), [&](int a_i, int a_j) {
+			return std::lexicographical_compare(keyOf(a_i), keyOf(a_i) + JobKeyLen,
+																					keyOf(a_j), keyOf(a_j) + JobKeyLen);
+		});
+
+		vector<BatchJob> jobs;
+		for (int i = 0; i < n; ++i) {
+			int o = order[i];
+			if (i == 0 ||
+					!std::equal(keyOf(o), keyOf(o) + JobKeyLen, keyOf(order[i - 1])))
+				jobs.push_back(BatchJob{{}, 0.0, 0.0});
+			jobs.back().m_opts.push_back(o);
+		}
+
+		for (BatchJob& job: jobs)
+			job.m_cost = JobCost(a_specs[job.m_opts[0]], int(job.m_opts.size()));
+		return jobs;
+	}
+
+	//------------------------------------------------------------------------//
+	// "CsvQuote": "a_s" as a quoted CSV field (its quotes doubled):          //
+	//------------------------------------------------------------------------//
+	string CsvQuote(string const& a_s) {
+		string q = "\"";
+		for (char c: a_s) {
+			if (c == '"')
+				q += '"';
+			q += c;
+		}
+		return q + '"';
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc < 5 || argc > 8) {
+		cerr << "PARAMS:\nportfolioFile, ratesFileA, ratesFileB,\n"
+						"outFile (.csv, or .bin for binary),\n"
+						"[nThreads=0 (all) [cacheFile [t0 (secs since epoch)=now]]]\n";
+		return 1;
+	}
+
+	char const* portfFile = 			argv[1];
+	char const* ratesFileA = 			argv[2];
+	char const* ratesFileB = 			argv[3];
+	char const* outFile 	= 			argv[4];
+	int nThreads 					= (argc >= 6) ? atoi(argv[5]) : 0;
+	char const* cacheFile = (argc >= 7) ? argv[6] : nullptr;
+	time_t t0 						= (argc == 8) ? time_t(atol(argv[7])) : time(nullptr);
+
+	BatchCtx ctx
+	{
+		ratesFileA, ratesFileB, IRPConst(ratesFileA), IRPConst(ratesFileB),
+		t0, 2, {}, nullptr, SpecKey{0, 0}
+	};
+
+	if (!ParsePortfolio(portfFile, &ctx.m_specs))
+		return 1;
+
+	int n = int(ctx.m_specs.size());
+	if (n == 0) {
+		cerr << "Empty portfolio" << endl;
+		return 1;
+	}
+
+	// the MC engines are sized for the longest path of all MC jobs:
+	for (OptionSpec const& s: ctx.m_specs)
+		if (s.m_engine == EngineE::MC)
+			ctx.m_maxL = std::max<long>(ctx.m_maxL, NSteps(s.m_Tdays, s.m_tauMins)
+																							+ 1);
+
+	vector<BatchJob> jobs = MkJobs(ctx.m_specs);
+	int nJobs = int(jobs.size());
+
+	vector<double> costs(nJobs);
+	for (int j = 0; j < nJobs; ++j)
+		costs[j] = jobs[j].m_cost;
+
+	vector<BatchRes> res(n);
+	vector<string> 	 errs(n);
+	for (int i = 0; i < n; ++i) {
+		BatchRes& r = res[i];
+		memset(&r, 0, sizeof(BatchRes));
+		strncpy(r.m_id, ctx.m_specs[i].m_id, BatchIDLen - 1);
+		r.m_px 		 = NAN;
+		r.m_delta  = NAN;
+		r.m_gamma  = NAN;
+		r.m_stdErr = NAN;
+	}
+
+	// the cache (on-disk if "cacheFile" is not empty, in-memory otherwise):
+	PxCache* cache = nullptr;
+	if (cacheFile != nullptr) {
+		try {
+			cache = new PxCache(65536, (*cacheFile != '\0') ? cacheFile : nullptr);
+			// (hashed once for all workers, and only with a cache):
+			ctx.m_ratesKey = HashRates<IRPConst, IRPConst>(ratesFileA, ratesFileB);
+		}
+		catch (std::exception const& e) {
+			cerr << e.what() << endl;
+			delete cache;
+			return 1;
+		}
+		ctx.m_cache = cache;
+	}
+
+	//------------------------------------------------------------------------//
+	// Run the jobs:                                                          //
+	//------------------------------------------------------------------------//
+	WorkStealingPool pool(nThreads);
+	WorkerCtx* wctxs = new WorkerCtx[pool.GetNThreads()];
+
+	using Clock = std::chrono::steady_clock;
+	auto tb = Clock::now();
+
+	pool.Run(nJobs, costs.data(), [&](int a_j, int a_w) {
+		BatchJob& job = jobs[a_j];
+		WorkerCtx& wc = wctxs[a_w];
+		auto 			 t0 = Clock::now();
+		int 			 status = 0;
+		string 		 err;
+		try {
+			switch (ctx.m_specs[job.m_opts[0]].m_model) {
+				case ModelE::GBM:
+					PriceJob(ctx, job, get<ModelCtx<DiffusionGBM>>(wc), res.data());
+					break;
+				case ModelE::CEV:
+					PriceJob(ctx, job, get<ModelCtx<DiffusionCEV>>(wc), res.data());
+					break;
+				case ModelE::Lipton:
+					PriceJob(ctx, job, get<ModelCtx<DiffusionLipton>>(wc), res.data());
+					break;
+				case ModelE::Merton:
+					PriceJob(ctx, job, get<ModelCtx<DiffusionMerton>>(wc), res.data());
+					break;
+				case ModelE::Kou:
+					PriceJob(ctx, job, get<ModelCtx<DiffusionKou>>(wc), res.data());
+					break;
+				default:
+					throw std::invalid_argument("invalid model");
+			}
+		}
+		catch (std::exception const& e) {
+			status = 1;
+			err 	 = e.what();
+		}
+		catch (...) { // (fails the job too, rather than the whole run)
+			status = 1;
+			err 	 = "unknown exception";
+		}
+		job.m_secs = std::chrono::duration<double>(Clock::now() - t0).count();
+
+		// (each option belongs to one job only, so no locking is needed):
+		for (int i: job.m_opts) {
+			res[i].m_job 	 	= a_j;
+			res[i].m_secs 	= job.m_secs;
+			res[i].m_status = status;
+			if (status != 0) {
+				res[i].m_px = NAN;
+				errs[i] 		= err;
+			}
+		}
+	});
+
+	double wall = std::chrono::duration<double>(Clock::now() - tb).count();
+	delete[] wctxs;
+
+	if (cache != nullptr) {
+		PrintPxCacheStats(cerr, cache->GetStats());
+		delete cache;
+	}
+
+	//------------------------------------------------------------------------//
+	// Output:                                                                //
+	//------------------------------------------------------------------------//
+	size_t lf 	= strlen(outFile);
+	bool 	 isBin = lf >= 4 && strcmp(outFile + lf - 4, ".bin") == 0;
+
+	FILE* dst = fopen(outFile, isBin ? "wb" : "w");
+	if (dst == nullptr) {
+		cerr << "Cannot open " << outFile << endl;
+		return 1;
+	}
+
+	bool ok = true;
+	if (isBin) {
+		BatchResHdr hdr;
+		memset(&hdr, 0, sizeof(hdr));
+		memcpy(hdr.m_magic, BatchResMagic, sizeof(hdr.m_magic));
+		hdr.m_nRes 	= uint32_t(n);
+		hdr.m_nJobs = uint32_t(nJobs);
+		hdr.m_t0 		= int64_t(ctx.m_t0);
+		ok = fwrite(&hdr, sizeof(hdr), 1, dst) == 1 &&
+				 fwrite(res.data(), sizeof(BatchRes), size_t(n), dst) == size_t(n);
+	}
+	else {
+		fprintf(dst, "id,type,K,Tdays,isAmerican,engine,model,px,delta,gamma,"
+								 "stdErr,job,secs,status,error\n");
+		for (int i = 0; i < n; ++i) {
+			OptionSpec const& s = ctx.m_specs[i];
+			BatchRes const& 	r = res[i];
+			fprintf(dst, "%s,%s,%.10g,%ld,%d,%s,%s,%.10g,%.10g,%.10g,%.10g,%d,"
+									 "%.6f,%d,%s\n",
+							r.m_id, s.m_isCall ? "Call" : "Put", s.m_K, s.m_Tdays,
+							int(s.m_isAmerican), (s.m_engine == EngineE::MC) ? "MC" : "Grid",
+							ModelNames[int(s.m_model)], r.m_px, r.m_delta, r.m_gamma,
+							r.m_stdErr, r.m_job, r.m_secs, r.m_status,
+							CsvQuote(errs[i]).c_str());
+		}
+	}
+	ok = (fclose(dst) == 0) && ok;
+	if (!ok) {
+		cerr << "Cannot write " << outFile << endl;
+		return 1;
+	}
+
+	// summary: the jobs' total time vs the wall time gives the parallel
+	// efficiency:
+	double busy 	= 0;
+	int 	 nFails = 0;
+	for (BatchJob const& job: jobs)
+		busy += job.m_secs;
+	for (BatchRes const& r: res)
+		nFails += (r.m_status != 0);
+
+	cerr << n << " options in " << nJobs << " jobs on " << pool.GetNThreads()
+			 << " threads: " << wall << " s (jobs: " << busy << " s), "
+			 << nFails << " failed" << endl;
+	return (nFails == 0) ? 0 : 2;
+}
@@ -0,0 +1,39 @@
+//==========================================================================//
+//                               "BatchResults.h"                           //
+// Binary output format of "BatchPricer"                                    //
+//--------------------------------------------------------------------------//
+// Layout (all fields native-endian, 8-byte aligned):                       //
+// * BatchResHdr;                                                           //
+// * BatchRes[m_nRes], in the order of the options in the portfolio file    //
+// Fields which do not apply (eg Delta of an MC price, StdErr of a grid     //
+// price) are NaN; on failure, "m_status" is non-0 and the px is NaN        //
+//==========================================================================//
+
+#pragma once
+
+#include <cstdint>
+
+namespace SiriusFM {
+
+	constexpr char BatchResMagic[8] = {'S', 'F', 'M', 'B', 'R', 'E', 'S', '1'};
+
+	constexpr int BatchIDLen = 32; // incl the terminating 0
+
+	struct BatchResHdr {
+		char 		 m_magic[8];
+		uint32_t m_nRes;
+		uint32_t m_nJobs;
+		int64_t  m_t0; 			 // pricing time (abs)
+	};
+
+	struct BatchRes {
+		char 		m_id[BatchIDLen];
+		double 	m_px;
+		double 	m_delta;
+		double 	m_gamma;
+		double 	m_stdErr; 	 // MC only
+		double 	m_secs; 		 // wall time of the whole job
+		int32_t m_job; 			 // index of the job which priced the option
+		int32_t m_status; 	 // 0: OK
+	};
+}
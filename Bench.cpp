@@ -0,0 +1,612 @@
+//==========================================================================//
+//                                 "Bench.cpp"                              //
+// Benchmarks of the hot paths: MC engine, path evaluators, path replay,    //
+// grid, BSM kernels and IR curve loading                                   //
+//--------------------------------------------------------------------------//
+// Each case is run "warmup" times untimed, then "reps" times; the report   //
+// gives min / p50 / p90 / max of the wall time per rep and the throughput  //
+// at the median, as a table on stderr and as JSON (on stdout, or to a      //
+// file), so that the runs before and after a change can be diffed. With    //
+// -DSIRIUSFM_INSTR, the phase timers and counters of each case are printed //
+// as well. Run from the repo dir (the IR files are read from there):       //
+//   Bench [reps [warmup [jsonFile]]]                                       //
+//==========================================================================//
+
+#include "DiffusionGBM.h"
+#include "DiffusionCEV.h"
+#include "DiffusionLipton.h"
+#include "DiffusionLocalVol.h"
+#include "DiffusionMerton.h"
+#include "DiffusionHeston.h"
+#include "IRProviderConst.h"
+#include "MCEngine1D.hpp"
+#include "MCOptionPricer1D.hpp"
+#include "MCOptionHedger1D.hpp"
+#include "GridNOP1D_S3_RKC1.hpp"
+#include "PathFile.h"
+#include "BSMBatch.hpp"
+#include "BSM.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+
+using namespace SiriusFM;
+using namespace std;
+
+namespace {
+	char const* const IRsFile = "const_IRs.txt";
+
+	// Results are accumulated here, so that the benchmarked code is not
+	// optimized away:
+	volatile double g_sink = 0;
+
+	//------------------------------------------------------------------------//
+	// "BenchRes": timings of one case:                                       //
+	//------------------------------------------------------------------------//
+	struct BenchRes {
+		string 				 m_name;
+		string 				 m_unit; 	// of the work, eg "paths"
+		double 				 m_work; 	// per rep
+		vector<double> m_secs; 	// per rep, sorted
+
+		// Nearest-rank percentile of the rep times:
+		double Pct(double a_p) const {
+			long n = long(m_secs.size());
+			long k = std::max<long>(0, long(a_p * n + 0.5) - 1);
+			return m_secs[std::min<long>(k, n - 1)];
+		}
+	};
+
+	//------------------------------------------------------------------------//
+	// "RunBench": times "a_f()":                                             //
+	//------------------------------------------------------------------------//
+	template<typename F>
+	BenchRes RunBench(char const* a_name, char const* a_unit, double a_work,
+										int a_warmup, int a_reps, F const& a_f)
+	{
+		for (int i = 0; i < a_warmup; ++i)
+			a_f();
+
+		BenchRes res{a_name, a_unit, a_work, {}};
+		SFM_INSTR(ResetInstrStats();)
+		for (int i = 0; i < a_reps; ++i) {
+			auto t0 = chrono::steady_clock::now();
+			a_f();
+			auto t1 = chrono::steady_clock::now();
+			res.m_secs.push_back(chrono::duration<double>(t1 - t0).count());
+		}
+		sort(res.m_secs.begin(), res.m_secs.end());
+
+		fprintf(stderr, "%-28s p50 %10.4f s  p90 %10.4f s  %12.4g %s/s\n",
+						a_name, res.Pct(0.5), res.Pct(0.9), a_work / res.Pct(0.5), a_unit);
+		SFM_INSTR(PrintInstrStats(cerr, GetInstrStats());)
+		return res;
+	}
+
+	//------------------------------------------------------------------------//
+	// "SinkEval": the cheapest "PathEvaluator" (for the engine timings):     //
+	//------------------------------------------------------------------------//
+	struct SinkEval {
+		double m_sum = 0;
+		template<typename Real>
+		void operator()(long a_L, long a_PM, Real const* a_paths,
+										double const* a_ts)
+		{
+			for (long p = 0; p < a_PM; ++p)
+				m_sum += a_paths[p * a_L + a_L - 1];
+		}
+	};
+
+	//------------------------------------------------------------------------//
+	// "BenchEngine": "MCEngine1D::Simulate" (RN), 1y of daily steps, with    //
+	// the paths stored as "Real"s:                                           //
+	//------------------------------------------------------------------------//
+	template<typename Diffusion1D, typename Real = double>
+	BenchRes BenchEngine(char const* a_name, Diffusion1D const& a_diff,
+											 int a_warmup, int a_reps)
+	{
+		constexpr long P = 20'000; // (and as many antithetic ones)
+		time_t t0 = MkDate(2024, 1, 1);
+		time_t T 	= t0 + 365 * SEC_IN_DAY;
+		IRPConst irp(IRsFile);
+		MCEngine1D<Diffusion1D, IRPConst, IRPConst, CcyE, CcyE, SinkEval, Real>
+			mce(400, 8192);
+
+		return RunBench(a_name, "paths", 2.0 * P, a_warmup, a_reps, [&]() {
+			SinkEval eval;
+			mce.template Simulate<true>(t0, T, 1440, P, false, &a_diff, &irp, &irp,
+																	CcyE::USD, CcyE::RUB, &eval);
+			g_sink = g_sink + eval.m_sum;
+		});
+	}
+
+	//------------------------------------------------------------------------//
+	// "WriteJSON":                                                           //
+	//------------------------------------------------------------------------//
+	void WriteJSON(ostream& a_os, vector<BenchRes> const& a_res, int a_reps,
+								 int a_warmup)
+	{
+		a_os.precision(6);
+		a_os << "{\n  \"reps\": " << a_reps << ",\n  \"warmup\": " << a_warmup
+				 << ",\n  \"benchmarks\": [\n";
+		for (size_t i = 0; i < a_res.size(); ++i) {
+			BenchRes const& r = a_res[i];
+			a_os << "    {\"name\": \"" 		<< r.m_name
+					 << "\", \"unit\": \"" 		<< r.m_unit
+					 << "\", \"work\": " 			<< r.m_work
+					 << ", \"min_s\": " 				<< r.m_secs.front()
+					 << ", \"p50_s\": " 				<< r.Pct(0.5)
+					 << ", \"p90_s\": " 				<< r.Pct(0.9)
+					 << ", \"max_s\": " 				<< r.m_secs.back()
+					 << ", \"rate_p50\": " 			<< r.m_work / r.Pct(0.5) << "}"
+					 << (i + 1 < a_res.size() ? ",\n" : "\n");
+		}
+		a_os << "  ]\n}\n";
+	}
+}
+
+int main(int argc, char** argv) {
+	int 				reps 		 = (argc > 1) ? atoi(argv[1]) : 7;
+	int 				warmup 	 = (argc > 2) ? atoi(argv[2]) : 2;
+	char const* jsonFile = (argc > 3) ? argv[3] : nullptr;
+
+	if (reps < 1 || warmup < 0) {
+		cerr << "PARAMS:\n[reps [warmup [jsonFile]]]\n";
+		return 1;
+	}
+
+	vector<BenchRes> res;
+	double S0 = 100.0;
+
+	//------------------------------------------------------------------------//
+	// MC engine, per diffusion:                                              //
+	//------------------------------------------------------------------------//
+	{
+		DiffusionGBM 		gbm(0.0, 0.2, S0);
+		DiffusionCEV 		cev(0.0, 0.2 * pow(S0, 0.2), 0.8, S0);
+		DiffusionLipton lip(0.0, 1.0, 0.1, 0.003, S0);
+		DiffusionMerton mer(0.0, 0.15, 0.5, -0.1, 0.15, S0);
+		DiffusionHeston hes(0.0, 1.5, 0.04, 0.4, -0.6, 0.04, S0);
+
+		// a flat 20% local vol on a 100 x 13 table:
+		vector<double> lvs(100 * 13, 0.2);
+		DiffusionLocalVol lv(0.0, S0, MkDate(2024, 1, 1), 20.0, 500.0, 100, 1.0,
+												 13, lvs.data());
+
+		res.push_back(BenchEngine("MCEngine1D/GBM", 			gbm, warmup, reps));
+		res.push_back(BenchEngine("MCEngine1D/CEV", 			cev, warmup, reps));
+		res.push_back(BenchEngine("MCEngine1D/Lipton", 		lip, warmup, reps));
+		res.push_back(BenchEngine("MCEngine1D/LocalVol", 	lv,  warmup, reps));
+		res.push_back(BenchEngine("MCEngine1D/Merton", 		mer, warmup, reps));
+		res.push_back(BenchEngine("MCEngine1D/Heston", 		hes, warmup, reps));
+
+		// single-precision paths:
+		res.push_back(BenchEngine<DiffusionGBM, float>
+			("MCEngine1D/GBM/f32", 			gbm, warmup, reps));
+		res.push_back(BenchEngine<DiffusionLocalVol, float>
+			("MCEngine1D/LocalVol/f32", lv, 	warmup, reps));
+		res.push_back(BenchEngine<DiffusionHeston, float>
+			("MCEngine1D/Heston/f32", 	hes, warmup, reps));
+	}
+
+	//------------------------------------------------------------------------//
+	// Validation of the single-precision paths: the same European Call       //
+	// priced on float and on double paths of the same seed (the paths only   //
+	// differ by the rounding of the stored points, so the prices must agree  //
+	// far within the MC error):                                              //
+	//------------------------------------------------------------------------//
+	{
+		time_t 			 t0 = MkDate(2024, 1, 1);
+		time_t 			 T 	= t0 + 365 * SEC_IN_DAY;
+		DiffusionGBM gbm(0.0, 0.2, S0);
+		CallOptionFX call(CcyE::USD, CcyE::RUB, S0, T, false);
+		IRPConst 		 irp(IRsFile);
+
+		using Eval = MCOptionPricer1D<DiffusionGBM, IRPConst, IRPConst, CcyE,
+																	CcyE>::OPPathEval;
+		auto price = [&](auto* a_mce, double* a_stdErr) {
+			Eval eval(&call);
+			a_mce->template Simulate<true>(t0, T, 1440, 20'000, false, &gbm, &irp,
+																		 &irp, CcyE::USD, CcyE::RUB, &eval);
+			*a_stdErr = std::get<0>(eval.GetStats()) / sqrt(40'000.0);
+			return eval.GetPx();
+		};
+		MCEngine1D<DiffusionGBM, IRPConst, IRPConst, CcyE, CcyE, Eval, double>
+			mce64(400, 8192);
+		MCEngine1D<DiffusionGBM, IRPConst, IRPConst, CcyE, CcyE, Eval, float>
+			mce32(400, 8192);
+		double err = 0;
+		double px64 = price(&mce64, &err);
+		double px32 = price(&mce32, &err);
+		double diff = fabs(px32 - px64);
+		fprintf(stderr, "%-28s px(f64) %.8f  px(f32) %.8f  diff %.3g "
+						"(%.3g StdErr)%s\n", "MCEngine1D/f32-vs-f64", px64, px32, diff,
+						diff / err, (diff > 0.01 * err) ? "  MISMATCH" : "");
+	}
+
+	//------------------------------------------------------------------------//
+	// Variance reduction modes: 1y GBM Calls (ATM and 30% OTM), on "NB"      //
+	// batches of 2 P / NB paths (the engine holds one batch of 366 points),  //
+	// so that the actual StdErr and the variance reduction factor (vs i.i.d. //
+	// paths) are measured from "NB" batch means:                             //
+	//------------------------------------------------------------------------//
+	{
+		using Eval = MCOptionPricer1D<DiffusionGBM, IRPConst, IRPConst, CcyE,
+																	CcyE>::OPPathEval;
+		constexpr long P 	= 20'000;
+		constexpr long NB = 80;
+		time_t 			 t0 	= MkDate(2024, 1, 1);
+		time_t 			 T 		= t0 + 365 * SEC_IN_DAY;
+		DiffusionGBM gbm(0.0, 0.2, S0);
+		CallOptionFX atm(CcyE::USD, CcyE::RUB, S0, 			 T, false);
+		CallOptionFX otm(CcyE::USD, CcyE::RUB, 1.3 * S0, T, false);
+		IRPConst 		 irp(IRsFile);
+		MCEngine1D<DiffusionGBM, IRPConst, IRPConst, CcyE, CcyE, Eval>
+			mce(366, 2 * P / NB);
+
+		char const* names[3] = {"MCVarRed/None", "MCVarRed/StratTerm",
+														"MCVarRed/MomentMatch"};
+		for (int m = 0; m < 3; ++m) {
+			mce.SetVarRed(VarRedE(m));
+			for (CallOptionFX const* call: {&atm, &otm}) {
+				double px = 0, err = 0, vrf = 0;
+				string name = string(names[m]) + ((call == &atm) ? "/ATM" : "/OTM");
+				res.push_back(RunBench(name.c_str(), "paths", 2.0 * P, warmup, reps,
+					[&]() {
+						Eval eval(call);
+						mce.Simulate<true>(t0, T, 1440, P, false, &gbm, &irp, &irp,
+															 CcyE::USD, CcyE::RUB, &eval);
+						px 	= eval.GetPx();
+						std::tie(err, vrf) = eval.GetVarRedStats();
+						g_sink = g_sink + px;
+					}));
+				fprintf(stderr, "%-28s px %.6f  StdErr %.3g  VRF %.3g\n", "", px,
+								err, vrf);
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// Importance sampling: deep OTM 1y GBM options (a 2.5-sigma Call, a      //
+	// 3-sigma Put and a Digital Call), without and with the drift shift to   //
+	// the strike; the StdErr is from the "NB" batch means, as in "MCVarRed": //
+	//------------------------------------------------------------------------//
+	{
+		using Eval = MCOptionPricer1D<DiffusionGBM, IRPConst, IRPConst, CcyE,
+																	CcyE>::OPPathEval;
+		constexpr long P 	= 20'000;
+		constexpr long NB = 80;
+		time_t 							t0 	= MkDate(2024, 1, 1);
+		time_t 							T 	= t0 + 365 * SEC_IN_DAY;
+		DiffusionGBM 				gbm(0.0, 0.2, S0);
+		CallOptionFX 				call(CcyE::USD, CcyE::RUB, 1.7 * S0, T, false);
+		PutOptionFX 				put (CcyE::USD, CcyE::RUB, 0.55 * S0, T, false);
+		DigitalCallOptionFX dig (CcyE::USD, CcyE::RUB, 1.6 * S0, T);
+		IRPConst 						irp(IRsFile);
+		MCEngine1D<DiffusionGBM, IRPConst, IRPConst, CcyE, CcyE, Eval>
+			mce(366, 2 * P / NB);
+
+		std::pair<char const*, OptionFX const*> opts[3] =
+			{{"Call", &call}, {"Put", &put}, {"Digital", &dig}};
+		for (int is = 0; is < 2; ++is)
+			for (auto const& opt: opts) {
+				mce.SetImpSampling(is ? opt.second->GetStrike() : NAN);
+				double px = 0, err = 0, vrf = 0;
+				string name = string(is ? "MCImpSampling/IS/" : "MCImpSampling/None/")
+										+ opt.first;
+				res.push_back(RunBench(name.c_str(), "paths", 2.0 * P, warmup, reps,
+					[&]() {
+						Eval eval(opt.second);
+						mce.Simulate<true>(t0, T, 1440, P, false, &gbm, &irp, &irp,
+															 CcyE::USD, CcyE::RUB, &eval);
+						px 	= eval.GetPx();
+						std::tie(err, vrf) = eval.GetVarRedStats();
+						g_sink = g_sink + px;
+					}));
+				fprintf(stderr, "%-28s px %.6g  StdErr %.3g (%.2f%%)  theta %.3g\n",
+								"", px, err, 100.0 * err / px, mce.GetISTheta());
+			}
+	}
+
+	//------------------------------------------------------------------------//
+	// Path files: the 1y GBM paths of "BenchEngine" are recorded once, then  //
+	// replayed into "OPPathEval" (to compare with "MCEngine1D/GBM"); the     //
+	// replayed price must be exactly the simulated one:                      //
+	//------------------------------------------------------------------------//
+	{
+		using Eval = MCOptionPricer1D<DiffusionGBM, IRPConst, IRPConst, CcyE,
+																	CcyE>::OPPathEval;
+		char const* pathFile = "bench_paths.bin";
+		constexpr long P 		 = 20'000;
+		time_t 			 t0 = MkDate(2024, 1, 1);
+		time_t 			 T 	= t0 + 365 * SEC_IN_DAY;
+		DiffusionGBM gbm(0.0, 0.2, S0);
+		CallOptionFX call(CcyE::USD, CcyE::RUB, S0, T, false);
+		IRPConst 		 irp(IRsFile);
+
+		double px = 0;
+		{
+			MCEngine1D<DiffusionGBM, IRPConst, IRPConst, CcyE, CcyE, PathRecorder>
+				rec(400, 8192);
+			PathRecorder recorder(pathFile);
+			rec.Simulate<true>(t0, T, 1440, P, false, &gbm, &irp, &irp, CcyE::USD,
+												 CcyE::RUB, &recorder);
+			recorder.Close();
+
+			MCEngine1D<DiffusionGBM, IRPConst, IRPConst, CcyE, CcyE, Eval>
+				mce(400, 8192);
+			Eval eval(&call);
+			mce.Simulate<true>(t0, T, 1440, P, false, &gbm, &irp, &irp, CcyE::USD,
+												 CcyE::RUB, &eval);
+			px = eval.GetPx();
+		}
+
+		PathReplay replay(pathFile);
+		double 		 pxR = 0;
+		res.push_back(RunBench("PathReplay/OPPathEval", "paths",
+			double(replay.GetNPaths()), warmup, reps, [&]() {
+				Eval eval(&call);
+				replay.Replay<double>(&eval);
+				pxR 	 = eval.GetPx();
+				g_sink = g_sink + pxR;
+			}));
+		if (pxR != px)
+			fprintf(stderr, "PathReplay: MISMATCH: px %.10f, replayed %.10f\n", px,
+							pxR);
+		remove(pathFile);
+	}
+
+	//------------------------------------------------------------------------//
+	// Path evaluators on fixed GBM paths (1y of daily points):               //
+	//------------------------------------------------------------------------//
+	{
+		using Pricer = MCOptionPricer1D<DiffusionGBM, IRPConst, IRPConst, CcyE,
+																		CcyE>;
+		using Hedger = MCOptionHedger1D<DiffusionGBM, IRPConst, IRPConst, CcyE,
+																		CcyE>;
+		constexpr long L 	= 366;
+		constexpr long PM = 8192;
+		double sigma 			= 0.2;
+		double tau 				= 1.0 / 365.0;
+		time_t t0 				= MkDate(2024, 1, 1);
+		time_t T 					= t0 + 365 * SEC_IN_DAY;
+
+		vector<double> ts(L);
+		vector<double> paths(L * PM);
+		std::mt19937_64 U(0);
+		std::normal_distribution<> N01(0.0, 1.0);
+		for (long l = 0; l < L; ++l)
+			ts[l] = YearFrac(t0) + double(l) * tau;
+		for (long p = 0; p < PM; ++p) {
+			double* path = paths.data() + p * L;
+			path[0] = S0;
+			for (long l = 1; l < L; ++l)
+				path[l] = path[l - 1] *
+									exp(- 0.5 * sigma * sigma * tau + sigma * sqrt(tau) * N01(U));
+		}
+
+		IRPConst 		 irp(IRsFile);
+		CallOptionFX call(CcyE::USD, CcyE::RUB, S0, T, false);
+
+		// (a European payoff reads the last point only, so many passes):
+		constexpr int Iter = 100;
+		res.push_back(RunBench("OPPathEval", "paths", double(PM) * Iter, warmup,
+			reps, [&]() {
+				Pricer::OPPathEval eval(&call);
+				for (int it = 0; it < Iter; ++it)
+					eval(L, PM, paths.data(), ts.data());
+				g_sink = g_sink + eval.GetPx();
+			}));
+
+		vector<float> paths32(paths.begin(), paths.end());
+		res.push_back(RunBench("OPPathEval/f32", "paths", double(PM) * Iter,
+			warmup, reps, [&]() {
+				Pricer::OPPathEval eval(&call);
+				for (int it = 0; it < Iter; ++it)
+					eval(L, PM, paths32.data(), ts.data());
+				g_sink = g_sink + eval.GetPx();
+			}));
+
+		Hedger::DeltaFunc delta = [&](double a_S, double a_t) {
+			return BSMDeltaCall(a_S, S0, YearFrac(T) - a_t, irp.r(CcyE::USD, a_t),
+													irp.r(CcyE::RUB, a_t), sigma);
+		};
+		res.push_back(RunBench("OHPathEval", "paths", double(PM), warmup, reps,
+			[&]() {
+				Hedger::OHPathEval eval(&call, &irp, &irp, 8.0, &delta, 0.001);
+				eval(L, PM, paths.data(), ts.data());
+				g_sink = g_sink + std::get<0>(eval.GetStats());
+			}));
+	}
+
+	//------------------------------------------------------------------------//
+	// MC engine with a heavy evaluator ("OHPathEval"), serial and pipelined  //
+	// with 1 and 2 producers (1y of daily steps):                            //
+	//------------------------------------------------------------------------//
+	{
+		using Hedger = MCOptionHedger1D<DiffusionGBM, IRPConst, IRPConst, CcyE,
+																		CcyE>;
+		constexpr long P 	= 4'000; // (and as many antithetic ones)
+		double sigma 			= 0.2;
+		time_t t0 				= MkDate(2024, 1, 1);
+		time_t T 					= t0 + 365 * SEC_IN_DAY;
+		DiffusionGBM gbm(0.0, sigma, S0);
+		IRPConst 		 irp(IRsFile);
+		CallOptionFX call(CcyE::USD, CcyE::RUB, S0, T, false);
+
+		Hedger::DeltaFunc delta = [&](double a_S, double a_t) {
+			return BSMDeltaCall(a_S, S0, YearFrac(T) - a_t, irp.r(CcyE::USD, a_t),
+													irp.r(CcyE::RUB, a_t), sigma);
+		};
+		MCEngine1D<DiffusionGBM, IRPConst, IRPConst, CcyE, CcyE,
+							 Hedger::OHPathEval>
+			mce(400, 3072);
+
+		char const* names[3] = {"MCHedge/Serial", "MCHedge/Pipe1", "MCHedge/Pipe2"};
+		for (int nProd = 0; nProd < 3; ++nProd) {
+			mce.SetPipeline(nProd);
+			res.push_back(RunBench(names[nProd], "paths", 2.0 * P, warmup, reps,
+				[&]() {
+					Hedger::OHPathEval eval(&call, &irp, &irp, 8.0, &delta, 0.001);
+					mce.Simulate<false>(t0, T, 1440, P, false, &gbm, &irp, &irp,
+															CcyE::USD, CcyE::RUB, &eval);
+					g_sink = g_sink + std::get<0>(eval.GetStats());
+				}));
+			PrintMCPipelineStats(cerr, mce.GetPipelineStats());
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// Pipeline with more producers than buffers (many small batches of 30d   //
+	// of daily steps): a regression of the producers` termination, and the   //
+	// prices must not depend on the # of producers:                          //
+	//------------------------------------------------------------------------//
+	{
+		using Eval = MCOptionPricer1D<DiffusionGBM, IRPConst, IRPConst, CcyE,
+																	CcyE>::OPPathEval;
+		constexpr long P = 20'000;
+		time_t 			 t0 	= MkDate(2024, 1, 1);
+		time_t 			 T 		= t0 + 30 * SEC_IN_DAY;
+		DiffusionGBM gbm(0.0, 0.2, S0);
+		CallOptionFX call(CcyE::USD, CcyE::RUB, S0, T, false);
+		IRPConst 		 irp(IRsFile);
+		MCEngine1D<DiffusionGBM, IRPConst, IRPConst, CcyE, CcyE, Eval>
+			mce(50, 600);
+
+		int const cfgs[2][3] = {{8, 2, 2}, {16, 3, 2}}; // (nProd, nBufs, ref)
+		for (auto const& cfg: cfgs) {
+			double pxs[2] = {0, 0};
+			for (int k = 0; k < 2; ++k) {
+				mce.SetPipeline((k == 0) ? cfg[2] : cfg[0], cfg[1]);
+				string name = "MCPipe/" + to_string(mce.GetNProducers()) + "x" +
+											to_string(cfg[1]);
+				res.push_back(RunBench(name.c_str(), "paths", 2.0 * P, warmup, reps,
+					[&]() {
+						Eval eval(&call);
+						mce.Simulate<true>(t0, T, 1440, P, false, &gbm, &irp, &irp,
+															 CcyE::USD, CcyE::RUB, &eval);
+						pxs[k] 	= eval.GetPx();
+						g_sink 	= g_sink + pxs[k];
+					}));
+			}
+			fprintf(stderr, "%-28s px %.10f vs %.10f%s\n", "", pxs[1], pxs[0],
+							(pxs[1] != pxs[0]) ? "  MISMATCH" : "");
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// Grid: 1y European Put, 500 S-intervals, 30-min steps:                  //
+	//------------------------------------------------------------------------//
+	{
+		constexpr int NS = 500;
+		DiffusionGBM gbm(0.0, 0.2, S0);
+		time_t 			 t0 = MkDate(2024, 1, 1);
+		time_t 			 T 	= t0 + 365 * SEC_IN_DAY;
+		PutOptionFX  put(CcyE::USD, CcyE::RUB, S0, T, false);
+
+		GridNOP1D_S3_RKC1<DiffusionGBM, IRPConst, IRPConst, CcyE, CcyE>
+			grid(IRsFile, IRsFile);
+
+		// node-updates per run (M is known after the 1st run):
+		grid.Run<false>(&put, &gbm, S0, t0, NS, 30);
+		double nodes = double(NS) * double(grid.GetM() - 1);
+
+		res.push_back(RunBench("GridNOP1D/Bwd", "nodes", nodes, warmup, reps,
+			[&]() {
+				grid.Run<false>(&put, &gbm, S0, t0, NS, 30);
+				g_sink = g_sink + std::get<0>(grid.GetPxDeltaGamma0());
+			}));
+		res.push_back(RunBench("GridNOP1D/Fwd", "nodes", nodes, warmup, reps,
+			[&]() {
+				grid.Run<true>(&put, &gbm, S0, t0, NS, 30);
+				g_sink = g_sink + grid.GetTs()[0];
+			}));
+	}
+
+	//------------------------------------------------------------------------//
+	// BSM kernels, over 4096 options (x 200 calls per rep):                  //
+	//------------------------------------------------------------------------//
+	{
+		constexpr int N 	 = 4096;
+		constexpr int Iter = 200;
+		double 				work = double(N) * Iter;
+
+		// (vector<bool> is packed, so a plain array):
+		bool* 				 isCall = new bool[N];
+		vector<double> S(N), K(N), TTE(N), rA(N), rB(N), sg(N), px(N), iv(N);
+		vector<double> dl(N), gm(N), vg(N), th(N);
+		for (int i = 0; i < N; ++i) {
+			isCall[i] = (i % 2 == 0);
+			S[i] 			= S0;
+			K[i] 			= 60.0 + 80.0 * double(i) / N;
+			TTE[i] 		= 0.05 + 2.0 * double(i % 37) / 37.0;
+			rA[i] 		= 0.0025;
+			rB[i] 		= 0.0425;
+			sg[i] 		= 0.1 + 0.3 * double(i % 11) / 11.0;
+		}
+		BSMPxBatch(N, isCall, S.data(), K.data(), TTE.data(), rA.data(),
+							 rB.data(), sg.data(), px.data());
+
+		res.push_back(RunBench("BSM/PxCall", "options", work, warmup, reps,
+			[&]() {
+				double s = 0;
+				for (int it = 0; it < Iter; ++it)
+					for (int i = 0; i < N; ++i)
+						s += BSMPxCall(S[i], K[i], TTE[i], rA[i], rB[i], sg[i]);
+				g_sink = g_sink + s;
+			}));
+		res.push_back(RunBench("BSM/PxBatch", "options", work, warmup, reps,
+			[&]() {
+				for (int it = 0; it < Iter; ++it)
+					BSMPxBatch(N, isCall, S.data(), K.data(), TTE.data(), rA.data(),
+										 rB.data(), sg.data(), iv.data());
+				g_sink = g_sink + iv[0];
+			}));
+		res.push_back(RunBench("BSM/GreeksBatch", "options", work, warmup, reps,
+			[&]() {
+				for (int it = 0; it < Iter; ++it)
+					BSMGreeksBatch(N, isCall, S.data(), K.data(), TTE.data(),
+												 rA.data(), rB.data(), sg.data(), dl.data(),
+												 gm.data(), vg.data(), th.data());
+				g_sink = g_sink + dl[0];
+			}));
+		res.push_back(RunBench("BSM/ImplVolBatch", "options", work, warmup, reps,
+			[&]() {
+				for (int it = 0; it < Iter; ++it)
+					BSMImplVolBatch(N, isCall, px.data(), S.data(), K.data(),
+													TTE.data(), rA.data(), rB.data(), iv.data());
+				g_sink = g_sink + iv[0];
+			}));
+		delete[] isCall;
+	}
+
+	//------------------------------------------------------------------------//
+	// IR curve loading (x 1000 per rep):                                     //
+	//------------------------------------------------------------------------//
+	{
+		constexpr int Iter = 1000;
+		res.push_back(RunBench("IRProviderConst/Load", "loads", Iter, warmup,
+			reps, [&]() {
+				for (int it = 0; it < Iter; ++it) {
+					IRPConst irp(IRsFile);
+					g_sink = g_sink + irp.r(CcyE::USD, 0.0);
+				}
+			}));
+	}
+
+	if (jsonFile != nullptr) {
+		ofstream out(jsonFile);
+		if (!out)
+			throw runtime_error("cannot open the JSON output file");
+		WriteJSON(out, res, reps, warmup);
+	}
+	else
+		WriteJSON(cout, res, reps, warmup);
+	return 0;
+}
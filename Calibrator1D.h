@@ -0,0 +1,124 @@
+//==========================================================================//
+//                              "Calibrator1D.h"                            //
+// Calibration of the vol params of 1D diffusions to market implied vols    //
+//--------------------------------------------------------------------------//
+// Each evaluation of the model vols is one Fwd run of "GridNOP1D_S3_RKC1"  //
+// up to the last expiry (all expiries being on its timeline): the Call and //
+// Put prices for all strikes of an expiry are integrated from the density  //
+// at that t-point and converted into implied vols by "BSMImplVolBatch".    //
+// The params are fitted by Levenberg-Marquardt in the vol space; the       //
+// finite-difference columns of the Jacobian are computed in parallel (if   //
+// built with "-fopenmp"), each thread running its own grid                 //
+//--------------------------------------------------------------------------//
+// Diffusion1D must provide "NVolParams", "GetVolParams(double*)", "GetMu()"//
+// and a Ctor (mu, double const* volParams, S0) which throws on invalid     //
+// params                                                                   //
+//==========================================================================//
+
+#pragma once
+
+#include "GridNOP1D_S3_RKC1.hpp"
+#include "VanillaOption.h"
+
+#include <tuple>
+#include <ctime>
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// Market quote: BSM implied vol of a European option:                    //
+	//------------------------------------------------------------------------//
+	struct VolQuote {
+		double m_K;
+		time_t m_expirTime;
+		double m_vol;
+		double m_weight; // weight of the vol error in the objective
+	};
+
+	//------------------------------------------------------------------------//
+	// Calibrator1D class:                                                    //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D, typename AProvider, typename BProvider,
+		typename AssetClassA, typename AssetClassB
+	>
+	class Calibrator1D {
+		private:
+			using Grid = GridNOP1D_S3_RKC1<Diffusion1D, AProvider, BProvider,
+																		 AssetClassA, AssetClassB>;
+			static constexpr int NP = Diffusion1D::NVolParams;
+
+			// FD steps for the Jacobian: FDStep * max(|p|, FDMinP):
+			static constexpr double FDStep = 1e-3;
+			static constexpr double FDMinP = 1e-2;
+
+			AProvider 				m_irpA;
+			BProvider 				m_irpB;
+			AssetClassA const m_assetA;
+			AssetClassB const m_assetB;
+			int 							m_nGrids; // one per thread
+			Grid** 						m_grids;
+
+			// The problem being solved (valid inside "Calibrate" only):
+			int 			m_nQ; 			// # of quotes, sorted by expiry
+			int 			m_nExp; 		// # of distinct expiries
+			time_t* 	m_expirs; 	// [m_nExp]
+			int* 			m_qBeg; 		// [m_nExp + 1]: quotes of each expiry
+			double* 	m_qs; 			// SoA quote data (K, TTE, rA, rB, S0, vol, w)
+			double* 	m_work; 		// [m_nGrids]: calls, puts, pxs, IVs (per quote)
+			bool* 		m_isCall; 	// [m_nGrids * m_nQ]
+			Option<AssetClassA, AssetClassB> const* m_opt; // up to the last expiry
+			double 		m_mu;
+			double 		m_S0;
+			time_t 		m_t0;
+			long 			m_Nints;
+			int 			m_tauMins;
+			double 		m_BFactor;
+
+		public:
+			// non-default Ctor ("a_maxN", "a_maxM" are for each of the grids):
+			Calibrator1D
+			(
+				char const* a_ratesFileA,
+				char const* a_ratesFileB,
+				AssetClassA a_assetA,
+				AssetClassB a_assetB,
+				long 				a_maxN = 1024,
+				long 				a_maxM = 100'000
+			);
+
+			// non-default Dtor:
+			~Calibrator1D();
+
+			//--------------------------------------------------------------------//
+			// "Calibrate": fits the vol params of "a_init" (its mu and S0 are    //
+			// kept) to "a_nQ" quotes with the spot "a_S0" at "a_t0". Quotes the  //
+			// model can not price (no density at the strike) count as zero vol.  //
+			// Returns (fitted diffusion, weighted RMS vol error, # of LM iters): //
+			//--------------------------------------------------------------------//
+			std::tuple<Diffusion1D, double, int> Calibrate
+			(
+				Diffusion1D const& a_init,
+				VolQuote const* 	 a_quotes,
+				int 							 a_nQ,
+				double 						 a_S0,
+				time_t 						 a_t0,
+				// grid params:
+				long 	 a_Nints 		= 300,
+				int 	 a_tauMins 	= 60,	 // t-step (capped by the stability limit)
+				double a_BFactor 	= 4.5,
+				// LM params:
+				int 	 a_maxIters = 50,
+				double a_tol 			= 1e-8 // on the relative decrease of the objective
+			);
+
+		private:
+			//--------------------------------------------------------------------//
+			// "Residuals": weighted (model - market) vols for the vol params     //
+			// "a_ps", using the grid and work space "a_g"; returns false if the  //
+			// params are invalid or the grid run fails:                          //
+			//--------------------------------------------------------------------//
+			bool Residuals(int a_g, double const* a_ps, double* a_res);
+	};
+}
@@ -0,0 +1,430 @@
+//==========================================================================//
+//                            "Calibrator1D.hpp"                            //
+// Implementation of "Calibrator1D" methods                                 //
+//==========================================================================//
+
+#pragma once
+
+#include "Calibrator1D.h"
+#include "BSMBatch.hpp"
+#include "Time.h"
+
+#include <stdexcept>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// Ctor and Dtor:                                                         //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D, typename AProvider, typename BProvider,
+		typename AssetClassA, typename AssetClassB
+	>
+	Calibrator1D<Diffusion1D, AProvider, BProvider, AssetClassA, AssetClassB>::
+	Calibrator1D
+	(
+		char const* a_ratesFileA,
+		char const* a_ratesFileB,
+		AssetClassA a_assetA,
+		AssetClassB a_assetB,
+		long 				a_maxN,
+		long 				a_maxM
+	)
+	: m_irpA 	 (a_ratesFileA),
+		m_irpB 	 (a_ratesFileB),
+		m_assetA (a_assetA),
+		m_assetB (a_assetB),
+		m_nGrids (1),
+		m_grids  (nullptr),
+		m_nQ 		 (0),
+		m_nExp 	 (0),
+		m_expirs (nullptr),
+		m_qBeg 	 (nullptr),
+		m_qs 		 (nullptr),
+		m_work 	 (nullptr),
+		m_isCall (nullptr),
+		m_opt 	 (nullptr),
+		m_mu 		 (0),
+		m_S0 		 (0),
+		m_t0 		 (0),
+		m_Nints  (0),
+		m_tauMins(0),
+		m_BFactor(0)
+	{
+		// The Jacobian columns are evaluated in parallel, so more than NP grids
+		// would never be used:
+#		ifdef _OPENMP
+		m_nGrids = std::min<int>(omp_get_max_threads(), NP);
+#		endif
+
+		// NB: the grids memory is only committed when touched by "Run":
+		m_grids = new Grid*[m_nGrids];
+		for (int g = 0; g < m_nGrids; ++g)
+			m_grids[g] = new Grid(a_ratesFileA, a_ratesFileB, a_maxN, a_maxM);
+	}
+
+	template
+	<
+		typename Diffusion1D, typename AProvider, typename BProvider,
+		typename AssetClassA, typename AssetClassB
+	>
+	Calibrator1D<Diffusion1D, AProvider, BProvider, AssetClassA, AssetClassB>::
+	~Calibrator1D()
+	{
+		for (int g = 0; g < m_nGrids; ++g)
+			delete m_grids[g];
+		delete[] m_grids;
+		m_grids = nullptr;
+	}
+
+	//------------------------------------------------------------------------//
+	// "Calibrate" implementation:                                            //
+	//------------------------------------------------------------------------//
+	// LM iteration: J^T J + lambda diag(J^T J) is solved for the step (by    //
+	// Cholesky, as NP is small); lambda is decreased after a successful step //
+	// and increased (without re-computing J) after a failed one:             //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D, typename AProvider, typename BProvider,
+		typename AssetClassA, typename AssetClassB
+	>
+	std::tuple<Diffusion1D, double, int>
+	Calibrator1D<Diffusion1D, AProvider, BProvider, AssetClassA, AssetClassB>::
+	Calibrate
+	(
+		Diffusion1D const& a_init,
+		VolQuote const* 	 a_quotes,
+		int 							 a_nQ,
+		double 						 a_S0,
+		time_t 						 a_t0,
+		long 							 a_Nints,
+		int 							 a_tauMins,
+		double 						 a_BFactor,
+		int 							 a_maxIters,
+		double 						 a_tol
+	)
+	{
+		if (a_quotes == nullptr || a_nQ < NP)
+			throw std::invalid_argument("Too few quotes to calibrate");
+
+		assert(a_S0 > 0 && a_Nints > 0 && a_tauMins > 0 && a_BFactor > 0 &&
+					 a_maxIters > 0 && a_tol > 0);
+
+		//----------------------------------------------------------------------//
+		// Set up the problem: quotes sorted by expiry, in SoA form:            //
+		//----------------------------------------------------------------------//
+		m_nQ 			= a_nQ;
+		m_mu 			= a_init.GetMu();
+		m_S0 			= a_S0;
+		m_t0 			= a_t0;
+		m_Nints 	= a_Nints;
+		m_tauMins = a_tauMins;
+		m_BFactor = a_BFactor;
+
+		int* ord = new int[m_nQ];
+		std::iota(ord, ord + m_nQ, 0);
+		std::stable_sort(ord, ord + m_nQ, [a_quotes](int a_i, int a_j)
+			{ return a_quotes[a_i].m_expirTime < a_quotes[a_j].m_expirTime; });
+
+		m_expirs = new time_t[m_nQ];
+		m_qBeg 	 = new int[m_nQ + 1];
+		m_qs 		 = new double[7 * m_nQ];
+		m_work 	 = new double[4 * m_nQ * m_nGrids];
+		m_isCall = new bool[m_nQ * m_nGrids];
+		m_nExp 	 = 0;
+
+		double* Ks 	 = m_qs;
+		double* TTEs = m_qs + 1 * m_nQ;
+		double* rAs  = m_qs + 2 * m_nQ;
+		double* rBs  = m_qs + 3 * m_nQ;
+		double* S0s  = m_qs + 4 * m_nQ;
+		double* vols = m_qs + 5 * m_nQ;
+		double* ws 	 = m_qs + 6 * m_nQ;
+
+		for (int q = 0; q < m_nQ; ++q) {
+			VolQuote const& Q = a_quotes[ord[q]];
+
+			if (Q.m_expirTime <= a_t0 || Q.m_K <= 0 || Q.m_vol <= 0 ||
+					Q.m_weight < 0)
+			{
+				delete[] ord;
+				delete[] m_expirs;
+				delete[] m_qBeg;
+				delete[] m_qs;
+				delete[] m_work;
+				delete[] m_isCall;
+				throw std::invalid_argument("Invalid quote");
+			}
+			if (m_nExp == 0 || m_expirs[m_nExp - 1] != Q.m_expirTime) {
+				m_qBeg[m_nExp] 		= q;
+				m_expirs[m_nExp++] = Q.m_expirTime;
+			}
+			double TTE = YearFracInt(Q.m_expirTime - a_t0);
+			Ks  [q] = Q.m_K;
+			TTEs[q] = TTE;
+			rAs [q] = - log(m_irpA.DF(m_assetA, a_t0, Q.m_expirTime)) / TTE;
+			rBs [q] = - log(m_irpB.DF(m_assetB, a_t0, Q.m_expirTime)) / TTE;
+			S0s [q] = a_S0;
+			vols[q] = Q.m_vol;
+			ws 	[q] = Q.m_weight;
+		}
+		m_qBeg[m_nExp] = m_nQ;
+		delete[] ord;
+
+		// The Fwd runs go up to the last expiry (the payoff is not used):
+		m_opt = new CallOption<AssetClassA, AssetClassB>
+			(m_assetA, m_assetB, a_S0, m_expirs[m_nExp - 1], false);
+
+		//----------------------------------------------------------------------//
+		// LM iterations:                                                       //
+		//----------------------------------------------------------------------//
+		double  p [NP];
+		double  pT[NP]; 							// trial params
+		double  A [NP * NP]; 					// J^T J
+		double  L [NP * NP]; 					// Cholesky factor of the damped A
+		double  g [NP]; 							// J^T r
+		double  dp[NP];
+		double* r 	 = new double[m_nQ];
+		double* rT 	 = new double[m_nQ];
+		double* J 	 = new double[m_nQ * NP]; // by-column
+		bool 		okJ[NP];
+
+		a_init.GetVolParams(p);
+
+		auto Cost = [this](double const* a_r) {
+			double c = 0;
+			for (int q = 0; q < m_nQ; ++q)
+				c += a_r[q] * a_r[q];
+			return c;
+		};
+
+		if (!Residuals(0, p, r)) {
+			delete[] r;
+			delete[] rT;
+			delete[] J;
+			delete m_opt;
+			delete[] m_expirs;
+			delete[] m_qBeg;
+			delete[] m_qs;
+			delete[] m_work;
+			delete[] m_isCall;
+			throw std::invalid_argument
+				("Initial params are not valid, or the grid is too small for them");
+		}
+		double cost 	= Cost(r);
+		double lambda = 1e-3;
+		int 	 iter 	= 0;
+
+		for (; iter < a_maxIters; ++iter) {
+			// The Jacobian by forward differences (backward ones if the forward
+			// point is not a valid param set). The columns are independent:
+#			ifdef _OPENMP
+#			pragma omp parallel for num_threads(m_nGrids) schedule(dynamic, 1)
+#			endif
+			for (int k = 0; k < NP; ++k) {
+				int th = 0;
+#				ifdef _OPENMP
+				th = omp_get_thread_num();
+#				endif
+				double pk[NP];
+				std::copy(p, p + NP, pk);
+				double* Jk = J + k * m_nQ;
+				double  h  = FDStep * std::max<double>(fabs(p[k]), FDMinP);
+
+				pk[k] = p[k] + h;
+				okJ[k] = Residuals(th, pk, Jk);
+				if (!okJ[k]) {
+					h 		 = - h;
+					pk[k]  = p[k] + h;
+					okJ[k] = Residuals(th, pk, Jk);
+				}
+				for (int q = 0; q < m_nQ; ++q)
+					Jk[q] = okJ[k] ? (Jk[q] - r[q]) / h : 0.0;
+			}
+
+			for (int k = 0; k < NP; ++k) {
+				g[k] = 0;
+				for (int q = 0; q < m_nQ; ++q)
+					g[k] += J[k * m_nQ + q] * r[q];
+
+				for (int l = 0; l <= k; ++l) {
+					double a = 0;
+					for (int q = 0; q < m_nQ; ++q)
+						a += J[k * m_nQ + q] * J[l * m_nQ + q];
+					A[k * NP + l] = a;
+					A[l * NP + k] = a;
+				}
+			}
+
+			// Find a damping which reduces the cost:
+			bool   accepted = false;
+			double costT 		= cost;
+			double maxRelDp = 0;
+
+			while (!accepted && lambda < 1e10) {
+				// Cholesky of (A + lambda diag(A)), then the step dp = - A^{-1} g:
+				bool spd = true;
+				for (int k = 0; k < NP && spd; ++k)
+					for (int l = 0; l <= k; ++l) {
+						double s = A[k * NP + l];
+						if (l == k)
+							s += lambda * std::max<double>(A[k * NP + k], 1e-12);
+						for (int m = 0; m < l; ++m)
+							s -= L[k * NP + m] * L[l * NP + m];
+
+						if (l < k)
+							L[k * NP + l] = s / L[l * NP + l];
+						else if (s > 0)
+							L[k * NP + k] = sqrt(s);
+						else {
+							spd = false;
+							break;
+						}
+					}
+				if (!spd) {
+					lambda *= 4;
+					continue;
+				}
+				for (int k = 0; k < NP; ++k) {
+					double s = - g[k];
+					for (int m = 0; m < k; ++m)
+						s -= L[k * NP + m] * dp[m];
+					dp[k] = s / L[k * NP + k];
+				}
+				for (int k = NP - 1; k >= 0; --k) {
+					double s = dp[k];
+					for (int m = k + 1; m < NP; ++m)
+						s -= L[m * NP + k] * dp[m];
+					dp[k] = s / L[k * NP + k];
+				}
+
+				maxRelDp = 0;
+				for (int k = 0; k < NP; ++k) {
+					pT[k] 	 = p[k] + dp[k];
+					maxRelDp = std::max<double>(maxRelDp,
+											fabs(dp[k]) / std::max<double>(fabs(p[k]), FDMinP));
+				}
+
+				if (Residuals(0, pT, rT) && (costT = Cost(rT)) < cost) {
+					accepted = true;
+					lambda 	 = std::max<double>(lambda / 3, 1e-12);
+				}
+				else
+					lambda *= 4;
+			}
+
+			if (!accepted)
+				break; // no descent: at a (local) minimum
+
+			double decr = (cost - costT) / std::max<double>(cost, 1e-300);
+			std::copy(pT, pT + NP, p);
+			std::swap(r, rT);
+			cost = costT;
+
+			if (decr < a_tol || maxRelDp < a_tol) {
+				++iter;
+				break;
+			}
+		}
+
+		double wSum = 0;
+		for (int q = 0; q < m_nQ; ++q)
+			wSum += ws[q] * ws[q];
+		double rmse = (wSum > 0) ? sqrt(cost / wSum) : 0.0;
+
+		delete[] r;
+		delete[] rT;
+		delete[] J;
+		delete m_opt;
+		delete[] m_expirs;
+		delete[] m_qBeg;
+		delete[] m_qs;
+		delete[] m_work;
+		delete[] m_isCall;
+		m_opt 	 = nullptr;
+		m_expirs = nullptr;
+		m_qBeg 	 = nullptr;
+		m_qs 		 = nullptr;
+		m_work 	 = nullptr;
+		m_isCall = nullptr;
+
+		return std::make_tuple(Diffusion1D(m_mu, p, m_S0), rmse, iter);
+	}
+
+	//------------------------------------------------------------------------//
+	// "Residuals" implementation:                                            //
+	//------------------------------------------------------------------------//
+	// The OTM option (Put for K < F, Call otherwise) is used for each quote, //
+	// as its implied vol is the better conditioned one:                      //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D, typename AProvider, typename BProvider,
+		typename AssetClassA, typename AssetClassB
+	>
+	bool
+	Calibrator1D<Diffusion1D, AProvider, BProvider, AssetClassA, AssetClassB>::
+	Residuals(int a_g, double const* a_ps, double* a_res)
+	{
+		assert(0 <= a_g && a_g < m_nGrids);
+		Grid* grid 		= m_grids[a_g];
+		double* calls = m_work + 4 * m_nQ * a_g;
+		double* puts 	= calls + m_nQ;
+		double* pxs 	= calls + 2 * m_nQ;
+		double* IVs 	= calls + 3 * m_nQ;
+		bool* isCall 	= m_isCall + m_nQ * a_g;
+
+		double const* Ks 	 = m_qs;
+		double const* TTEs = m_qs + 1 * m_nQ;
+		double const* rAs  = m_qs + 2 * m_nQ;
+		double const* rBs  = m_qs + 3 * m_nQ;
+		double const* S0s  = m_qs + 4 * m_nQ;
+		double const* vols = m_qs + 5 * m_nQ;
+		double const* ws 	 = m_qs + 6 * m_nQ;
+
+		try {
+			Diffusion1D diff(m_mu, a_ps, m_S0);
+
+			grid->template Run<true>(m_opt, &diff, m_S0, m_t0, m_Nints, m_tauMins,
+															 m_BFactor, 1.0, m_expirs, m_nExp);
+
+			// Each expiry is exactly a t-point:
+			int M 						= grid->GetM();
+			double const* ts 	= grid->GetTs();
+
+			for (int e = 0; e < m_nExp; ++e) {
+				int j = int(std::lower_bound(ts, ts + M, YearFrac(m_expirs[e])) - ts);
+				assert(j < M && ts[j] == YearFrac(m_expirs[e]));
+				int q0 = m_qBeg[e];
+
+				grid->GetEurPxsFwd(j, Ks + q0, m_qBeg[e + 1] - q0,
+													 calls + q0, puts + q0);
+			}
+		}
+		catch (std::exception const&) {
+			return false;
+		}
+
+		for (int q = 0; q < m_nQ; ++q) {
+			double F 	= S0s[q] * exp((rBs[q] - rAs[q]) * TTEs[q]);
+			isCall[q] = (Ks[q] >= F);
+			pxs[q] 		= isCall[q] ? calls[q] : puts[q];
+		}
+		BSMImplVolBatch(m_nQ, isCall, pxs, S0s, Ks, TTEs, rAs, rBs, IVs);
+
+		for (int q = 0; q < m_nQ; ++q)
+			a_res[q] = ws[q] * ((std::isnan(IVs[q]) ? 0.0 : IVs[q]) - vols[q]);
+
+		return true;
+	}
+}
@@ -0,0 +1,43 @@
+//==========================================================================//
+//                               "CurveStore.h"                             //
+// Binary snapshot format of bucketed FwdCurves, for memory-mapping         //
+//--------------------------------------------------------------------------//
+// Layout (all fields native-endian, every section 8-byte aligned):         //
+// * CurveStoreHdr;                                                         //
+// * CurveStoreSlot[m_nSlots]: open-addressing hash table CcyID -> index;   //
+// * for each index in [0, m_nCcys): double fwds[m_nB], double ints[m_nB],  //
+//   as in "MkBucketedCurve" (the bucket k starts at m_t0 + k * m_dt)       //
+// The file is produced by "MkCurveStore" and read by "IRPMapped"           //
+//==========================================================================//
+
+#pragma once
+
+#include "IRProvider.h"
+
+#include <cstdint>
+
+namespace SiriusFM {
+
+	constexpr char CurveStoreMagic[8] = {'S', 'F', 'M', 'C', 'R', 'V', '0', '1'};
+
+	struct CurveStoreHdr {
+		char 		 m_magic[8];
+		uint32_t m_nCcys;
+		uint32_t m_nSlots; 	 // power of 2, at least 2 * m_nCcys
+		uint32_t m_nB; 			 // # of buckets in each curve
+		uint32_t m_reserved;
+		double 	 m_t0; 			 // base date (YearFrac)
+		double 	 m_dt; 			 // bucket size (years)
+	};
+
+	struct CurveStoreSlot {
+		uint32_t m_id; 			 // CcyID (UNDEFINED for an empty slot)
+		uint32_t m_idx; 		 // index of the curve
+	};
+
+	// Home slot of a CcyID (probing is linear from there):
+	inline uint32_t CurveStoreHash(CcyID a_ccy, uint32_t a_nSlots) {
+		uint64_t h = uint64_t(uint32_t(a_ccy)) * 0x9E3779B97F4A7C15ULL;
+		return uint32_t(h >> 32) & (a_nSlots - 1);
+	}
+}
@@ -7,6 +7,10 @@
 
 #include <stdexcept>
 #include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+#include "FastMath.h"
 
 namespace SiriusFM {
 	class DiffusionCEV {
@@ -17,6 +21,9 @@ namespace SiriusFM {
 			double const m_S0;
 
 		public:
+			// mu and sigma do not depend on t:
+			static constexpr bool IsTimeHomog = true;
+
 			DiffusionCEV(double a_mu, double a_sigma, double a_beta, double a_S0)
 			: m_mu(a_mu),
 				m_sigma(a_sigma),
@@ -28,6 +35,10 @@ namespace SiriusFM {
 					if (m_S0 < 0) throw std::invalid_argument("invalid S0");
 				}
 
+			// Ctor from the vol params (sigma, beta) as in "GetVolParams":
+			DiffusionCEV(double a_mu, double const* a_volParams, double a_S0)
+			: DiffusionCEV(a_mu, a_volParams[0], a_volParams[1], a_S0) {}
+
 			double mu(double a_S, double t) const {
 				return (a_S < 0)? 0.0: m_mu * a_S;
 			}
@@ -36,8 +47,44 @@ namespace SiriusFM {
 				return (a_S < 0)? 0.0: m_sigma * pow(a_S, m_beta);
 			}
 
+			// Batch forms (over "a_n" points); S^beta = exp(beta log S) by the
+			// vectorizable "FastExp" / "FastLog" (S = 0 is taken as DBL_MIN,
+			// which gives the same result to double precision):
+			void mu(double const* a_S, double a_t, double* __restrict__ a_out,
+							long a_n) const
+			{
+				double mu = m_mu;
+				for (long i = 0; i < a_n; ++i)
+					a_out[i] = (a_S[i] < 0)? 0.0: mu * a_S[i];
+			}
+
+			void sigma(double const* a_S, double a_t, double* __restrict__ a_out,
+								 long a_n) const
+			{
+				double sg = m_sigma;
+				double bt = m_beta;
+				for (long i = 0; i < a_n; ++i) {
+					double S 	= a_S[i];
+					double Sb = FastExp(bt * FastLog(std::max<double>(S, DBL_MIN)));
+					a_out[i] 	= (S < 0)? 0.0: sg * Sb;
+				}
+			}
+
 			double GetS0() const {
 				return m_S0;
 			}
+
+			double GetMu() const {
+				return m_mu;
+			}
+
+			// Params which are fitted by calibration (sigma, beta); mu and S0 are
+			// kept as they are:
+			static constexpr int NVolParams = 2;
+
+			void GetVolParams(double* a_ps) const {
+				a_ps[0] = m_sigma;
+				a_ps[1] = m_beta;
+			}
 	};
 }
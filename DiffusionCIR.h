@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include "SpecHash.h"
+
 #include <stdexcept>
 #include <cmath>
 
@@ -17,6 +19,9 @@ namespace SiriusFM {
 			double const m_S0;
 
 		public:
+			// mu and sigma do not depend on t:
+			static constexpr bool IsTimeHomog = true;
+
 			DiffusionCIR(double a_kappa, double a_theta, 
 																					double a_sigma, double a_S0)
 			:	m_kappa(a_kappa),
@@ -38,8 +43,32 @@ namespace SiriusFM {
 				return (a_S < 0)? 0.0: m_sigma * sqrt(a_S);
 			}
 			
+			// Batch forms (over "a_n" points):
+			void mu(double const* a_S, double a_t, double* __restrict__ a_out,
+							long a_n) const
+			{
+				double k  = m_kappa;
+				double th = m_theta;
+				for (long i = 0; i < a_n; ++i)
+					a_out[i] = (a_S[i] < 0)? 0.0: k * (th - a_S[i]);
+			}
+
+			void sigma(double const* a_S, double a_t, double* __restrict__ a_out,
+								 long a_n) const
+			{
+				double sg = m_sigma;
+				for (long i = 0; i < a_n; ++i)
+					a_out[i] = (a_S[i] < 0)? 0.0: sg * sqrt(a_S[i]);
+			}
+			
 			double GetS0() const {
 				return m_S0;
 			}
+
+			// The keys of "PxCache" (see "HashDiffusion"): kappa, theta, sigma
+			// and S0:
+			void HashSpec(SpecHasher& a_h) const {
+				a_h.Add(m_kappa).Add(m_theta).Add(m_sigma).Add(m_S0);
+			}
 	};
 }
@@ -15,6 +15,9 @@ namespace SiriusFM {
 			double const m_S0;
 
 		public:
+			// mu and sigma do not depend on t:
+			static constexpr bool IsTimeHomog = true;
+
 			DiffusionGBM(double a_mu, double a_sigma, double a_S0)
 			:	m_mu(a_mu),
 			  m_sigma(a_sigma),
@@ -24,6 +27,10 @@ namespace SiriusFM {
 					if (m_S0 < 0) throw std::invalid_argument("invalid S0");
 				}
 
+			// Ctor from the vol params (sigma) as in "GetVolParams":
+			DiffusionGBM(double a_mu, double const* a_volParams, double a_S0)
+			: DiffusionGBM(a_mu, a_volParams[0], a_S0) {}
+
 			double mu(double a_S, double t) const {
 				return (a_S < 0)? 0.0: m_mu * a_S;
 			}
@@ -32,8 +39,37 @@ namespace SiriusFM {
 				return (a_S < 0)? 0.0: m_sigma * a_S;
 			}
 			
+			// Batch forms (over "a_n" points):
+			void mu(double const* a_S, double a_t, double* __restrict__ a_out,
+							long a_n) const
+			{
+				double mu = m_mu;
+				for (long i = 0; i < a_n; ++i)
+					a_out[i] = (a_S[i] < 0)? 0.0: mu * a_S[i];
+			}
+
+			void sigma(double const* a_S, double a_t, double* __restrict__ a_out,
+								 long a_n) const
+			{
+				double sg = m_sigma;
+				for (long i = 0; i < a_n; ++i)
+					a_out[i] = (a_S[i] < 0)? 0.0: sg * a_S[i];
+			}
+			
 			double GetS0() const {
 				return m_S0;
 			}
+
+			double GetMu() const {
+				return m_mu;
+			}
+
+			// Params which are fitted by calibration (sigma); mu and S0 are
+			// kept as they are:
+			static constexpr int NVolParams = 1;
+
+			void GetVolParams(double* a_ps) const {
+				a_ps[0] = m_sigma;
+			}
 	};
 }
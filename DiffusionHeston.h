@@ -0,0 +1,171 @@
+//==========================================================================//
+//                             "DiffusionHeston.h"                          //
+// Heston stochastic-vol model and its QE discretization                    //
+//--------------------------------------------------------------------------//
+//   dS = mu S dt + sqrt(v) S dW1,                                          //
+//   dv = kappa (theta - v) dt + xi sqrt(v) dW2,   d<W1, W2> = rho dt       //
+// The MC step follows Andersen (2008): the variance by the Quadratic-      //
+// Exponential scheme (exact 1st and 2nd moments), and the log-spot by the  //
+// central (gamma1 = gamma2 = 1/2) discretization of Int v dt, with the     //
+// martingale correction, so E[S(t+dt) | S(t)] = S(t) exp(drift * dt)       //
+// exactly; this allows daily or weekly steps. "MCEngine1D" uses "StepQE"   //
+// instead of "mu" / "sigma" as the model declares "IsStochVol"             //
+//==========================================================================//
+
+#pragma once
+
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+
+namespace SiriusFM {
+	class DiffusionHeston {
+		private:
+			double const m_mu;
+			double const m_kappa;
+			double const m_theta;
+			double const m_xi; 		// vol of variance
+			double const m_rho;
+			double const m_v0;
+			double const m_S0;
+
+		public:
+			// mu and the vol params do not depend on t:
+			static constexpr bool IsTimeHomog = true;
+
+			// The state is (S, v), not S only:
+			static constexpr bool IsStochVol 	= true;
+
+			DiffusionHeston(double a_mu, double a_kappa, double a_theta,
+											double a_xi, double a_rho, double a_v0, double a_S0)
+			: m_mu(a_mu),
+				m_kappa(a_kappa),
+				m_theta(a_theta),
+				m_xi(a_xi),
+				m_rho(a_rho),
+				m_v0(a_v0),
+				m_S0(a_S0)
+				{
+					if (!(m_kappa > 0)) throw std::invalid_argument("invalid kappa");
+					if (!(m_theta > 0)) throw std::invalid_argument("invalid theta");
+					if (!(m_xi > 0)) throw std::invalid_argument("invalid xi");
+					if (!(m_rho >= -1 && m_rho <= 1))
+						throw std::invalid_argument("invalid rho");
+					if (!(m_v0 >= 0)) throw std::invalid_argument("invalid v0");
+					if (m_S0 < 0) throw std::invalid_argument("invalid S0");
+				}
+
+			// Ctor from the vol params (kappa, theta, xi, rho, v0), as in
+			// "GetVolParams":
+			DiffusionHeston(double a_mu, double const* a_volParams, double a_S0)
+			: DiffusionHeston(a_mu, a_volParams[0], a_volParams[1], a_volParams[2],
+												a_volParams[3], a_volParams[4], a_S0) {}
+
+			double GetS0() const {
+				return m_S0;
+			}
+
+			double GetV0() const {
+				return m_v0;
+			}
+
+			double GetMu() const {
+				return m_mu;
+			}
+
+			double GetKappa() const { return m_kappa; }
+			double GetTheta() const { return m_theta; }
+			double GetXi() 		const { return m_xi; 		}
+			double GetRho() 	const { return m_rho; 	}
+
+			// Params which are fitted by calibration (kappa, theta, xi, rho, v0);
+			// mu and S0 are kept as they are:
+			static constexpr int NVolParams = 5;
+
+			void GetVolParams(double* a_ps) const {
+				a_ps[0] = m_kappa;
+				a_ps[1] = m_theta;
+				a_ps[2] = m_xi;
+				a_ps[3] = m_rho;
+				a_ps[4] = m_v0;
+			}
+
+			//--------------------------------------------------------------------//
+			// QE step constants (depend on the step "dt" only):                  //
+			//--------------------------------------------------------------------//
+			struct QEConsts {
+				double m_dt;
+				double m_E; 				// exp(-kappa dt)
+				double m_s2v; 			// s^2 = m_s2v * v + m_s2c
+				double m_s2c;
+				double m_K0, m_K1, m_K2, m_K3, m_K4; // log-spot step (w/o correction)
+				double m_A; 				// K2 + K4 / 2
+			};
+
+			QEConsts MkQEConsts(double a_dt) const {
+				QEConsts c;
+				double E 	= exp(-m_kappa * a_dt);
+				double x2 = m_xi * m_xi;
+				double k 	= m_kappa * m_rho / m_xi - 0.5;
+				c.m_dt 		= a_dt;
+				c.m_E 		= E;
+				c.m_s2v 	= x2 * E * (1.0 - E) / m_kappa;
+				c.m_s2c 	= m_theta * x2 * (1.0 - E) * (1.0 - E) / (2.0 * m_kappa);
+				c.m_K0 		= - m_rho * m_kappa * m_theta * a_dt / m_xi;
+				c.m_K1 		= 0.5 * a_dt * k - m_rho / m_xi;
+				c.m_K2 		= 0.5 * a_dt * k + m_rho / m_xi;
+				c.m_K3 		= 0.5 * a_dt * (1.0 - m_rho * m_rho);
+				c.m_K4 		= c.m_K3;
+				c.m_A 		= c.m_K2 + 0.5 * c.m_K4;
+				return c;
+			}
+
+			//--------------------------------------------------------------------//
+			// "StepQE": advances (log S, v) by "a_c.m_dt" with the log-drift     //
+			// "a_drift" (eg rB - rA, or mu), given 2 independent N(0,1) draws;   //
+			// (-Zv, -Zs) give the antithetic step:                               //
+			//--------------------------------------------------------------------//
+			void StepQE(QEConsts const& a_c, double a_drift, double a_Zv,
+									double a_Zs, double* a_logS, double* a_v) const
+			{
+				constexpr double PsiC = 1.5;
+				double v 	 = *a_v;
+				double m 	 = m_theta + (v - m_theta) * a_c.m_E;
+				double s2  = a_c.m_s2v * v + a_c.m_s2c;
+				double psi = s2 / (m * m);
+				double vn  = 0;
+				double lnM = NAN; // log E[exp(A vn)] (if finite)
+
+				if (psi <= PsiC) {
+					// Quadratic: vn = a (b + Zv)^2:
+					double q  = 2.0 / psi;
+					double b2 = q - 1.0 + sqrt(q) * sqrt(q - 1.0);
+					double a  = m / (1.0 + b2);
+					double b  = sqrt(b2);
+					vn = a * (b + a_Zv) * (b + a_Zv);
+					if (a_c.m_A * a < 0.5)
+						lnM = a_c.m_A * b2 * a / (1.0 - 2.0 * a_c.m_A * a) -
+									0.5 * log(1.0 - 2.0 * a_c.m_A * a);
+				}
+				else {
+					// Exponential: mass "p" at 0, exp(beta) tail; 1 - U by the Zv:
+					double p  = (psi - 1.0) / (psi + 1.0);
+					double bt = (1.0 - p) / m;
+					double Uc = 0.5 * erfc(a_Zv * M_SQRT1_2);
+					vn = (Uc >= 1.0 - p) ? 0.0 : log((1.0 - p) / Uc) / bt;
+					if (a_c.m_A < bt)
+						lnM = log(p + bt * (1.0 - p) / (bt - a_c.m_A));
+				}
+
+				// Martingale correction of K0 (if E[exp(A vn)] is finite):
+				double K0 = std::isfinite(lnM)
+										? - lnM - (a_c.m_K1 + 0.5 * a_c.m_K3) * v
+										: a_c.m_K0;
+
+				*a_logS += a_drift * a_c.m_dt + K0 + a_c.m_K1 * v + a_c.m_K2 * vn +
+									 sqrt(std::max<double>(a_c.m_K3 * v + a_c.m_K4 * vn, 0.0)) *
+									 a_Zs;
+				*a_v = vn;
+			}
+	};
+}
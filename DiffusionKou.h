@@ -0,0 +1,127 @@
+//==========================================================================//
+//                              "DiffusionKou.h"                            //
+// Kou jump-diffusion: GBM with double-exponential log-jumps                //
+//--------------------------------------------------------------------------//
+//   dS / S- = mu dt + sigma dW + (e^J - 1) dN,                             //
+//   N Poisson of intensity lambda, J ~ Exp(eta1) with prob p (up-jumps),   //
+//   -Exp(eta2) with prob 1 - p (down-jumps); eta1 > 1 so E[e^J] < Inf      //
+// "mu" / "sigma" are those of the continuous part; in the RN case the      //
+// engine compensates the drift by lambda * "GetJumpComp"                   //
+//==========================================================================//
+
+#pragma once
+
+#include <stdexcept>
+#include <cmath>
+#include <random>
+
+namespace SiriusFM {
+	class DiffusionKou {
+		private:
+			double const m_mu;
+			double const m_sigma;
+			double const m_lambda; 	// jump intensity (per year)
+			double const m_p; 			// prob of an up-jump
+			double const m_eta1; 		// rate of up-jumps
+			double const m_eta2; 		// rate of down-jumps
+			double const m_S0;
+
+		public:
+			// mu and sigma do not depend on t:
+			static constexpr bool IsTimeHomog = true;
+
+			static constexpr bool HasJumps 		= true;
+
+			DiffusionKou(double a_mu, double a_sigma, double a_lambda, double a_p,
+									 double a_eta1, double a_eta2, double a_S0)
+			: m_mu(a_mu),
+				m_sigma(a_sigma),
+				m_lambda(a_lambda),
+				m_p(a_p),
+				m_eta1(a_eta1),
+				m_eta2(a_eta2),
+				m_S0(a_S0)
+				{
+					if (m_sigma < 0) throw std::invalid_argument("invalid sigma");
+					if (m_lambda < 0) throw std::invalid_argument("invalid lambda");
+					if (!(m_p >= 0 && m_p <= 1)) throw std::invalid_argument("invalid p");
+					if (!(m_eta1 > 1)) throw std::invalid_argument("invalid eta1");
+					if (!(m_eta2 > 0)) throw std::invalid_argument("invalid eta2");
+					if (m_S0 < 0) throw std::invalid_argument("invalid S0");
+				}
+
+			// Ctor from the vol params (sigma, lambda, p, eta1, eta2) as in
+			// "GetVolParams":
+			DiffusionKou(double a_mu, double const* a_volParams, double a_S0)
+			: DiffusionKou(a_mu, a_volParams[0], a_volParams[1], a_volParams[2],
+										 a_volParams[3], a_volParams[4], a_S0) {}
+
+			double mu(double a_S, double t) const {
+				return (a_S < 0)? 0.0: m_mu * a_S;
+			}
+
+			double sigma(double a_S, double t) const {
+				return (a_S < 0)? 0.0: m_sigma * a_S;
+			}
+
+			// Batch forms (over "a_n" points):
+			void mu(double const* a_S, double a_t, double* __restrict__ a_out,
+							long a_n) const
+			{
+				double mu = m_mu;
+				for (long i = 0; i < a_n; ++i)
+					a_out[i] = (a_S[i] < 0)? 0.0: mu * a_S[i];
+			}
+
+			void sigma(double const* a_S, double a_t, double* __restrict__ a_out,
+								 long a_n) const
+			{
+				double sg = m_sigma;
+				for (long i = 0; i < a_n; ++i)
+					a_out[i] = (a_S[i] < 0)? 0.0: sg * a_S[i];
+			}
+
+			double GetS0() const {
+				return m_S0;
+			}
+
+			double GetMu() const {
+				return m_mu;
+			}
+
+			double GetLambda() const {
+				return m_lambda;
+			}
+
+			// E[e^J] - 1:
+			double GetJumpComp() const {
+				return m_p * m_eta1 / (m_eta1 - 1.0) +
+							 (1.0 - m_p) * m_eta2 / (m_eta2 + 1.0) - 1.0;
+			}
+
+			// Sum of "a_n" log-jumps:
+			template<typename RNG>
+			double LogJumps(int a_n, RNG& a_U) const {
+				std::uniform_real_distribution<> U01(0.0, 1.0);
+				double J = 0;
+				for (int k = 0; k < a_n; ++k) {
+					bool 	 up = U01(a_U) < m_p;
+					double E 	= - log(1.0 - U01(a_U)); // Exp(1)
+					J += up ? E / m_eta1 : - E / m_eta2;
+				}
+				return J;
+			}
+
+			// Params which are fitted by calibration (sigma, lambda, p, eta1,
+			// eta2); mu and S0 are kept as they are:
+			static constexpr int NVolParams = 5;
+
+			void GetVolParams(double* a_ps) const {
+				a_ps[0] = m_sigma;
+				a_ps[1] = m_lambda;
+				a_ps[2] = m_p;
+				a_ps[3] = m_eta1;
+				a_ps[4] = m_eta2;
+			}
+	};
+}
@@ -18,6 +18,9 @@ namespace SiriusFM {
 			double const m_S0;
 
 		public:
+			// mu and sigma do not depend on t:
+			static constexpr bool IsTimeHomog = true;
+
 			DiffusionLipton(double a_mu, double a_sigma0, double a_sigma1, 
 							double a_sigma2, double a_S0)
 			: m_mu(a_mu),
@@ -32,16 +35,57 @@ namespace SiriusFM {
 					if (m_S0 < 0) throw std::invalid_argument("invalid S0");
 				}
 
+			// Ctor from the vol params (sigma0, sigma1, sigma2), as in
+			// "GetVolParams":
+			DiffusionLipton(double a_mu, double const* a_volParams, double a_S0)
+			: DiffusionLipton(a_mu, a_volParams[0], a_volParams[1], 
+											a_volParams[2], a_S0) {}
+
 			double mu(double a_S, double t) const {
 				return (a_S < 0)? 0.0: m_mu * a_S;
 			}
 
 			double sigma(double a_S, double t) const {
-				return (a_S < 0)? 0.0: m_sigma0 + m_sigma1 * a_S + m_sigma2 * pow(a_S, 2);
+				return (a_S < 0)? 0.0: m_sigma0 + (m_sigma1 + m_sigma2 * a_S) * a_S;
+			}
+
+			// Batch forms (over "a_n" points):
+			void mu(double const* a_S, double a_t, double* __restrict__ a_out,
+							long a_n) const
+			{
+				double mu = m_mu;
+				for (long i = 0; i < a_n; ++i)
+					a_out[i] = (a_S[i] < 0)? 0.0: mu * a_S[i];
+			}
+
+			void sigma(double const* a_S, double a_t, double* __restrict__ a_out,
+								 long a_n) const
+			{
+				double s0 = m_sigma0;
+				double s1 = m_sigma1;
+				double s2 = m_sigma2;
+				for (long i = 0; i < a_n; ++i) {
+					double S = a_S[i];
+					a_out[i] = (S < 0)? 0.0: s0 + (s1 + s2 * S) * S;
+				}
 			}
 
 			double GetS0() const {
 				return m_S0;
 			}
+
+			double GetMu() const {
+				return m_mu;
+			}
+
+			// Params which are fitted by calibration (sigma0, sigma1, sigma2);
+			// mu and S0 are kept as they are:
+			static constexpr int NVolParams = 3;
+
+			void GetVolParams(double* a_ps) const {
+				a_ps[0] = m_sigma0;
+				a_ps[1] = m_sigma1;
+				a_ps[2] = m_sigma2;
+			}
 	};
 }
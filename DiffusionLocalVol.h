@@ -0,0 +1,203 @@
+//==========================================================================//
+//                           "DiffusionLocalVol.h"                          //
+// Local-vol diffusion with the vol tabulated on a (log S, t) grid          //
+//--------------------------------------------------------------------------//
+//   dS = mu S dt + sigmaLoc(S, t) S dW                                     //
+// sigmaLoc is given at the nodes of uniform axes in x = log S and in the   //
+// time "t - t0" since the surface date, so the cell of a point is found by //
+// O(1) index arithmetic. The 4 bilinear coefficients of the cells are kept //
+// by t-row, as 4 contiguous planes over the x-cells (so that the lookups   //
+// are vectorized as gathers); for a given t, "GetSlice" resolves the row   //
+// and weight once, after which each S costs one log, 4 loads and 2 FMAs.   //
+// The batch "sigma" does that once per call, ie once per engine step.      //
+// Outside the table the vol is extrapolated flat. The nodes are normally   //
+// built from implied-vol quotes by "MkDupireLVs" (see "DupireLV.hpp")      //
+//==========================================================================//
+
+#pragma once
+
+#include "Time.h"
+#include "FastMath.h"
+#include "SpecHash.h"
+
+#include <stdexcept>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+namespace SiriusFM {
+	class DiffusionLocalVol {
+		private:
+			double const 	m_mu;
+			double const 	m_S0;
+			double const 	m_t0; 	// year frac of the surface date
+			int 	 const 	m_NX; 	// # of log S nodes
+			int 	 const 	m_NT; 	// # of t nodes
+			double const 	m_x0; 	// log SMin
+			double const 	m_rdx; 	// 1 / (log S step)
+			double const 	m_rdt; 	// 1 / (t step)
+			double* const m_cs; 	// [(j * 4 + k) * (NX-1) + i]: cell coeffs
+
+			//--------------------------------------------------------------------//
+			// "MkCells": bilinear coeffs of the cells; on cell (i, j), with u, w //
+			// in [0, 1] the fractions in x and t:                                //
+			//   sigmaLoc = (a + c w) + (b + d w) u                               //
+			//--------------------------------------------------------------------//
+			static double* MkCells(double a_SMin, double a_SMax, int a_NX,
+														 double a_TMax, int a_NT, double const* a_lvs)
+			{
+				if (!(a_SMin > 0 && a_SMax > a_SMin && a_TMax > 0) || a_NX < 2 ||
+						a_NT < 2 || a_lvs == nullptr)
+					throw std::invalid_argument("invalid local vol table");
+				for (int n = 0; n < a_NX * a_NT; ++n)
+					if (!(a_lvs[n] >= 0)) throw std::invalid_argument("invalid vol");
+
+				double* cs = new double[4 * (a_NT - 1) * (a_NX - 1)];
+				for (int j = 0; j < a_NT - 1; ++j)
+					for (int i = 0; i < a_NX - 1; ++i) {
+						double s00 = a_lvs[j * a_NX + i];
+						double s10 = a_lvs[j * a_NX + i + 1];
+						double s01 = a_lvs[(j + 1) * a_NX + i];
+						double s11 = a_lvs[(j + 1) * a_NX + i + 1];
+						double* c  = cs + j * 4 * (a_NX - 1) + i;
+						c[0] 						= s00;
+						c[a_NX - 1] 		= s10 - s00;
+						c[2 * (a_NX - 1)] = s01 - s00;
+						c[3 * (a_NX - 1)] = s11 - s10 - s01 + s00;
+					}
+				return cs;
+			}
+
+		public:
+			// sigma depends on t:
+			static constexpr bool IsTimeHomog = false;
+
+			//--------------------------------------------------------------------//
+			// Time slice of the table: the row of cells (the "a", "b", "c", "d"  //
+			// planes of "m_nc" coeffs each) and the weight in t:                 //
+			//--------------------------------------------------------------------//
+			struct Slice {
+				double const* m_cs;
+				long 					m_nc;
+				double 				m_w;
+			};
+
+			// "a_lvs[j * a_NX + i]": sigmaLoc at S = SMin (SMax/SMin)^{i/(NX-1)},
+			// t = t0 + TMax j/(NT-1):
+			DiffusionLocalVol
+			(
+				double 				a_mu,
+				double 				a_S0,
+				time_t 				a_t0,
+				double 				a_SMin,
+				double 				a_SMax,
+				int 					a_NX,
+				double 				a_TMax,
+				int 					a_NT,
+				double const* a_lvs
+			)
+			: m_mu (a_mu),
+				m_S0 (a_S0),
+				m_t0 (YearFrac(a_t0)),
+				m_NX (a_NX),
+				m_NT (a_NT),
+				m_x0 (log(a_SMin)),
+				m_rdx(double(a_NX - 1) / log(a_SMax / a_SMin)),
+				m_rdt(double(a_NT - 1) / a_TMax),
+				m_cs (MkCells(a_SMin, a_SMax, a_NX, a_TMax, a_NT, a_lvs))
+				{
+					if (m_S0 < 0) {
+						delete[] m_cs;
+						throw std::invalid_argument("invalid S0");
+					}
+				}
+
+			~DiffusionLocalVol() {
+				delete[] m_cs;
+			}
+
+			DiffusionLocalVol(DiffusionLocalVol const&) = delete;
+
+			DiffusionLocalVol& operator=(DiffusionLocalVol const&) = delete;
+
+			//--------------------------------------------------------------------//
+			// "GetSlice": the t-cell of "a_t" (abs year frac), clamped to the    //
+			// table:                                                             //
+			//--------------------------------------------------------------------//
+			Slice GetSlice(double a_t) const {
+				double q = std::min<double>(std::max<double>((a_t - m_t0) * m_rdt,
+																										 0.0), m_NT - 1);
+				int 	 j = std::min<int>(int(q), m_NT - 2);
+				return Slice{m_cs + j * 4 * (m_NX - 1), m_NX - 1, q - j};
+			}
+
+			//--------------------------------------------------------------------//
+			// "SigmaLoc": on the slice, at "a_x" = log S:                        //
+			//--------------------------------------------------------------------//
+			double SigmaLoc(Slice const& a_sl, double a_x) const {
+				double q = std::min<double>(std::max<double>((a_x - m_x0) * m_rdx,
+																										 0.0), m_NX - 1);
+				int 	 i = std::min<int>(int(q), m_NX - 2);
+				double const* c  = a_sl.m_cs + i;
+				long 					nc = a_sl.m_nc;
+				return (c[0] + c[2 * nc] * a_sl.m_w) +
+							 (c[nc] + c[3 * nc] * a_sl.m_w) * (q - i);
+			}
+
+			double mu(double a_S, double t) const {
+				return (a_S < 0)? 0.0: m_mu * a_S;
+			}
+
+			double sigma(double a_S, double a_t) const {
+				return (a_S <= 0)? 0.0: SigmaLoc(GetSlice(a_t), log(a_S)) * a_S;
+			}
+
+			// Batch forms (over "a_n" points); the slice is resolved once:
+			void mu(double const* a_S, double a_t, double* __restrict__ a_out,
+							long a_n) const
+			{
+				double mu = m_mu;
+				for (long i = 0; i < a_n; ++i)
+					a_out[i] = (a_S[i] < 0)? 0.0: mu * a_S[i];
+			}
+
+			void sigma(double const* a_S, double a_t, double* __restrict__ a_out,
+								 long a_n) const
+			{
+				Slice 				sl 	= GetSlice(a_t);
+				double const* ca 	= sl.m_cs;
+				double const* cb 	= ca + sl.m_nc;
+				double const* cc 	= cb + sl.m_nc;
+				double const* cd 	= cc + sl.m_nc;
+				double 				w 	= sl.m_w;
+				double 				x0 	= m_x0;
+				double 				rdx = m_rdx;
+				double 				qM 	= m_NX - 1;
+				int 					iM 	= m_NX - 2;
+				for (long n = 0; n < a_n; ++n) {
+					double S = a_S[n];
+					double x = FastLog(std::max<double>(S, DBL_MIN));
+					double q = std::min<double>(std::max<double>((x - x0) * rdx, 0.0),
+																			qM);
+					int 	 i = std::min<int>(int(q), iM);
+					double lv = (ca[i] + cc[i] * w) + (cb[i] + cd[i] * w) * (q - i);
+					a_out[n] 	= lv * std::max<double>(S, 0.0); // (no branch: vectorized)
+				}
+			}
+
+			double GetS0() const {
+				return m_S0;
+			}
+
+			double GetMu() const {
+				return m_mu;
+			}
+
+			// The whole surface goes into the keys of "PxCache" (there are no
+			// "GetVolParams" for it):
+			void HashSpec(SpecHasher& a_h) const {
+				a_h.Add(m_S0).Add(m_t0).Add(m_NX).Add(m_NT).Add(m_x0).Add(m_rdx)
+					 .Add(m_rdt).Add(m_cs, 4 * long(m_NT - 1) * (m_NX - 1));
+			}
+	};
+}
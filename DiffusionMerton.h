@@ -0,0 +1,116 @@
+//==========================================================================//
+//                             "DiffusionMerton.h"                          //
+// Merton jump-diffusion: GBM with log-normal jumps                         //
+//--------------------------------------------------------------------------//
+//   dS / S- = mu dt + sigma dW + (e^J - 1) dN,                             //
+//   N Poisson of intensity lambda, J ~ N(muJ, sigmaJ^2)                    //
+// "mu" / "sigma" are those of the continuous part; in the RN case the      //
+// engine compensates the drift by lambda * "GetJumpComp". Vanillas are     //
+// priced by the series in "MertonJD.hpp"                                   //
+//==========================================================================//
+
+#pragma once
+
+#include <stdexcept>
+#include <cmath>
+#include <random>
+
+namespace SiriusFM {
+	class DiffusionMerton {
+		private:
+			double const m_mu;
+			double const m_sigma;
+			double const m_lambda; 	// jump intensity (per year)
+			double const m_muJ; 		// mean log-jump
+			double const m_sigmaJ; 	// StD of log-jump
+			double const m_S0;
+
+		public:
+			// mu and sigma do not depend on t:
+			static constexpr bool IsTimeHomog = true;
+
+			static constexpr bool HasJumps 		= true;
+
+			DiffusionMerton(double a_mu, double a_sigma, double a_lambda,
+											double a_muJ, double a_sigmaJ, double a_S0)
+			: m_mu(a_mu),
+				m_sigma(a_sigma),
+				m_lambda(a_lambda),
+				m_muJ(a_muJ),
+				m_sigmaJ(a_sigmaJ),
+				m_S0(a_S0)
+				{
+					if (m_sigma < 0) throw std::invalid_argument("invalid sigma");
+					if (m_lambda < 0) throw std::invalid_argument("invalid lambda");
+					if (m_sigmaJ < 0) throw std::invalid_argument("invalid sigmaJ");
+					if (m_S0 < 0) throw std::invalid_argument("invalid S0");
+				}
+
+			// Ctor from the vol params (sigma, lambda, muJ, sigmaJ) as in
+			// "GetVolParams":
+			DiffusionMerton(double a_mu, double const* a_volParams, double a_S0)
+			: DiffusionMerton(a_mu, a_volParams[0], a_volParams[1],
+												a_volParams[2], a_volParams[3], a_S0) {}
+
+			double mu(double a_S, double t) const {
+				return (a_S < 0)? 0.0: m_mu * a_S;
+			}
+
+			double sigma(double a_S, double t) const {
+				return (a_S < 0)? 0.0: m_sigma * a_S;
+			}
+
+			// Batch forms (over "a_n" points):
+			void mu(double const* a_S, double a_t, double* __restrict__ a_out,
+							long a_n) const
+			{
+				double mu = m_mu;
+				for (long i = 0; i < a_n; ++i)
+					a_out[i] = (a_S[i] < 0)? 0.0: mu * a_S[i];
+			}
+
+			void sigma(double const* a_S, double a_t, double* __restrict__ a_out,
+								 long a_n) const
+			{
+				double sg = m_sigma;
+				for (long i = 0; i < a_n; ++i)
+					a_out[i] = (a_S[i] < 0)? 0.0: sg * a_S[i];
+			}
+
+			double GetS0() const {
+				return m_S0;
+			}
+
+			double GetMu() const {
+				return m_mu;
+			}
+
+			double GetSigma() 	const { return m_sigma; 	}
+			double GetLambda() 	const { return m_lambda; 	}
+			double GetMuJ() 		const { return m_muJ; 		}
+			double GetSigmaJ() 	const { return m_sigmaJ; 	}
+
+			// E[e^J] - 1:
+			double GetJumpComp() const {
+				return exp(m_muJ + 0.5 * m_sigmaJ * m_sigmaJ) - 1.0;
+			}
+
+			// Sum of "a_n" log-jumps, which is N(n muJ, n sigmaJ^2):
+			template<typename RNG>
+			double LogJumps(int a_n, RNG& a_U) const {
+				std::normal_distribution<> N01(0.0, 1.0);
+				return a_n * m_muJ + m_sigmaJ * sqrt(double(a_n)) * N01(a_U);
+			}
+
+			// Params which are fitted by calibration (sigma, lambda, muJ,
+			// sigmaJ); mu and S0 are kept as they are:
+			static constexpr int NVolParams = 4;
+
+			void GetVolParams(double* a_ps) const {
+				a_ps[0] = m_sigma;
+				a_ps[1] = m_lambda;
+				a_ps[2] = m_muJ;
+				a_ps[3] = m_sigmaJ;
+			}
+	};
+}
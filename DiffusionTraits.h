@@ -0,0 +1,111 @@
+//==========================================================================//
+//                             "DiffusionTraits.h"                          //
+// Compile-time properties of Diffusion1D classes used by the engines       //
+//--------------------------------------------------------------------------//
+// A Diffusion declares a property by providing a static constexpr member;  //
+// if the member is absent, the most conservative value is assumed          //
+//==========================================================================//
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+namespace SiriusFM {
+	class SpecHasher;
+
+	//------------------------------------------------------------------------//
+	// "IsTimeHomog": mu(S, t) and sigma(S, t) do not depend on t, so the     //
+	// coefficients evaluated on a fixed S-grid may be cached across t-layers://
+	//------------------------------------------------------------------------//
+	template<typename Diffusion1D, typename = void>
+	struct IsTimeHomog: std::false_type {};
+
+	template<typename Diffusion1D>
+	struct IsTimeHomog
+		<Diffusion1D, std::void_t<decltype(Diffusion1D::IsTimeHomog)>>
+	: std::bool_constant<Diffusion1D::IsTimeHomog> {};
+
+	//------------------------------------------------------------------------//
+	// "IsStochVol": the state is (S, v), so the model is stepped by its own  //
+	// "MkQEConsts" / "StepQE" rather than by mu(S, t) and sigma(S, t):       //
+	//------------------------------------------------------------------------//
+	template<typename Diffusion1D, typename = void>
+	struct IsStochVol: std::false_type {};
+
+	template<typename Diffusion1D>
+	struct IsStochVol
+		<Diffusion1D, std::void_t<decltype(Diffusion1D::IsStochVol)>>
+	: std::bool_constant<Diffusion1D::IsStochVol> {};
+
+	//------------------------------------------------------------------------//
+	// "HasJumps": a jump-diffusion; besides mu(S, t) and sigma(S, t) of the  //
+	// continuous part, the model provides the jump intensity "GetLambda",    //
+	// the compensator "GetJumpComp" = E[e^J] - 1 and "LogJumps" (the sum of  //
+	// "n" log-jump sizes J):                                                 //
+	//------------------------------------------------------------------------//
+	template<typename Diffusion1D, typename = void>
+	struct HasJumps: std::false_type {};
+
+	template<typename Diffusion1D>
+	struct HasJumps
+		<Diffusion1D, std::void_t<decltype(Diffusion1D::HasJumps)>>
+	: std::bool_constant<Diffusion1D::HasJumps> {};
+
+	//------------------------------------------------------------------------//
+	// "HasBatchCoeffs": the model provides the array forms                   //
+	//   mu   (double const* S, double t, double* out, long n)                //
+	//   sigma(double const* S, double t, double* out, long n),               //
+	// which the engines prefer to the per-point calls. Their loops read the  //
+	// params from locals, copied from the members beforehand: the members    //
+	// themselves are not hoisted out of the loop:                            //
+	//------------------------------------------------------------------------//
+	template<typename Diffusion1D, typename = void>
+	struct HasBatchCoeffs: std::false_type {};
+
+	template<typename Diffusion1D>
+	struct HasBatchCoeffs
+	<
+		Diffusion1D,
+		std::void_t
+		<
+			decltype(std::declval<Diffusion1D const&>().mu
+				(std::declval<double const*>(), 0.0, std::declval<double*>(), 0L)),
+			decltype(std::declval<Diffusion1D const&>().sigma
+				(std::declval<double const*>(), 0.0, std::declval<double*>(), 0L))
+		>
+	>
+	: std::true_type {};
+
+	//------------------------------------------------------------------------//
+	// "HasSpecHash": the model feeds its params into a "SpecHasher" itself   //
+	// by "HashSpec(SpecHasher&)" (eg a model with tabulated params), rather  //
+	// than by its "GetVolParams" and "GetS0" (see "HashDiffusion"):          //
+	//------------------------------------------------------------------------//
+	template<typename Diffusion1D, typename = void>
+	struct HasSpecHash: std::false_type {};
+
+	template<typename Diffusion1D>
+	struct HasSpecHash
+	<
+		Diffusion1D,
+		std::void_t
+		<
+			decltype(std::declval<Diffusion1D const&>().HashSpec
+				(std::declval<SpecHasher&>()))
+		>
+	>
+	: std::true_type {};
+
+	//------------------------------------------------------------------------//
+	// "HasVolParams": the model exposes its "NVolParams" vol params by       //
+	// "GetVolParams(double*)" (as fitted by the calibrators):                //
+	//------------------------------------------------------------------------//
+	template<typename Diffusion1D, typename = void>
+	struct HasVolParams: std::false_type {};
+
+	template<typename Diffusion1D>
+	struct HasVolParams
+		<Diffusion1D, std::void_t<decltype(Diffusion1D::NVolParams)>>
+	: std::true_type {};
+}
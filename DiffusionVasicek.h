@@ -0,0 +1,46 @@
+//==========================================================================//
+//                             "DiffusionVasicek.h"                         //
+// Vasicek short rate: OU process with constant params, which (unlike       //
+// "DiffusionOU") may become negative; the rate model of "MCEngine2F"       //
+//==========================================================================//
+
+#pragma once
+
+#include <stdexcept>
+
+namespace SiriusFM {
+	class DiffusionVasicek {
+		private:
+			double const m_kappa;
+			double const m_theta;
+			double const m_sigma;
+			double const m_S0;
+
+		public:
+			// mu and sigma do not depend on t:
+			static constexpr bool IsTimeHomog = true;
+
+			DiffusionVasicek(double a_kappa, double a_theta,
+																					double a_sigma, double a_S0)
+			:	m_kappa(a_kappa),
+				m_theta(a_theta),
+				m_sigma(a_sigma),
+				m_S0(a_S0)
+				{
+					if (m_sigma < 0) throw std::invalid_argument("invalid sigma");
+					if (m_kappa <= 0) throw std::invalid_argument("invalid kappa");
+				}
+
+			double mu(double a_S, double t) const {
+				return m_kappa * (m_theta - a_S);
+			}
+
+			double sigma(double a_S, double t) const {
+				return m_sigma;
+			}
+
+			double GetS0() const {
+				return m_S0;
+			}
+	};
+}
@@ -0,0 +1,212 @@
+//==========================================================================//
+//                                "DupireLV.hpp"                            //
+// Dupire local vols from implied-vol quotes, on the nodes of the           //
+// "DiffusionLocalVol" table                                                //
+//--------------------------------------------------------------------------//
+// In terms of the total implied variance w(y, T) = IV^2 T as a function of //
+// the log-moneyness y = log(K / F(T)), F(T) = S0 e^{(rB - rA) T}:          //
+//   sigmaLoc^2 = w_T / (1 - y w_y / w + (-1/4 - 1/w + y^2 / w^2) w_y^2 / 4 //
+//                       + w_yy / 2),                                       //
+// taken at K = S, T = t. For each expiry, w is a natural cubic spline in y //
+// through the quotes (flat beyond the extreme strikes); in T, w is linear  //
+// between the expiries and has a flat IV before the 1st and after the last //
+// one. Where the quotes admit arbitrage (w_T <= 0 or the denominator is    //
+// not positive), the implied vol itself is used                            //
+//==========================================================================//
+
+#pragma once
+
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// "MkNatSpline": 2nd derivatives "a_M" of the natural cubic spline       //
+	// through (a_xs[i], a_ys[i]), i < a_n (a_xs increasing):                 //
+	//------------------------------------------------------------------------//
+	inline void MkNatSpline
+	(
+		int 					a_n,
+		double const* a_xs,
+		double const* a_ys,
+		double* 			a_M
+	)
+	{
+		a_M[0] 			 = 0;
+		a_M[a_n - 1] = 0;
+		if (a_n < 3)
+			return;
+
+		// Tridiagonal system for M[1..n-2], by the Thomas algorithm ("cp" and
+		// "a_M" keep the eliminated super-diagonal and rhs):
+		double* cp = new double[a_n];
+		cp[0] = 0;
+		for (int i = 1; i < a_n - 1; ++i) {
+			double h0 = a_xs[i] 		- a_xs[i - 1];
+			double h1 = a_xs[i + 1] - a_xs[i];
+			double r 	= 6.0 * ((a_ys[i + 1] - a_ys[i]) / h1 -
+												 (a_ys[i] 		- a_ys[i - 1]) / h0);
+			double b 	= 2.0 * (h0 + h1) - h0 * cp[i - 1];
+			cp[i] 		= h1 / b;
+			a_M[i] 		= (r - h0 * a_M[i - 1]) / b;
+		}
+		for (int i = a_n - 3; i >= 1; --i)
+			a_M[i] -= cp[i] * a_M[i + 1];
+		delete[] cp;
+	}
+
+	//------------------------------------------------------------------------//
+	// "SplineEval": the spline and its 1st and 2nd derivatives at "a_x"      //
+	// (constant beyond the end points):                                      //
+	//------------------------------------------------------------------------//
+	inline void SplineEval
+	(
+		int 					a_n,
+		double const* a_xs,
+		double const* a_ys,
+		double const* a_M,
+		double 				a_x,
+		double* 			a_f,
+		double* 			a_f1,
+		double* 			a_f2
+	)
+	{
+		if (a_n == 1 || a_x <= a_xs[0] || a_x >= a_xs[a_n - 1]) {
+			*a_f 	= (a_n == 1 || a_x <= a_xs[0]) ? a_ys[0] : a_ys[a_n - 1];
+			*a_f1 = 0;
+			*a_f2 = 0;
+			return;
+		}
+		int 	 i = int(std::upper_bound(a_xs, a_xs + a_n, a_x) - a_xs) - 1;
+		double h = a_xs[i + 1] - a_xs[i];
+		double A = (a_xs[i + 1] - a_x) / h;
+		double B = 1.0 - A;
+		*a_f 	= A * a_ys[i] + B * a_ys[i + 1] +
+						((A * A * A - A) * a_M[i] + (B * B * B - B) * a_M[i + 1]) * h * h /
+						6.0;
+		*a_f1 = (a_ys[i + 1] - a_ys[i]) / h +
+						((1.0 - 3.0 * A * A) * a_M[i] + (3.0 * B * B - 1.0) * a_M[i + 1]) *
+						h / 6.0;
+		*a_f2 = A * a_M[i] + B * a_M[i + 1];
+	}
+
+	//------------------------------------------------------------------------//
+	// "MkDupireLVs":                                                         //
+	//------------------------------------------------------------------------//
+	// Quotes: "a_IVs[j * a_nK + i]" is the IV of strike "a_Ks[i]" and time-  //
+	// to-expiry "a_TTEs[j]" (both increasing); rates are const. Output: the  //
+	// local vols "a_lvs[j * a_NX + i]" at S = SMin (SMax/SMin)^{i/(NX-1)},   //
+	// t = TMax j/(NT-1), as taken by the "DiffusionLocalVol" Ctor:           //
+	//------------------------------------------------------------------------//
+	inline void MkDupireLVs
+	(
+		double 				a_S0,
+		double 				a_rateA,
+		double 				a_rateB,
+		int 					a_nK,
+		double const* a_Ks,
+		int 					a_nT,
+		double const* a_TTEs,
+		double const* a_IVs,
+		double 				a_SMin,
+		double 				a_SMax,
+		int 					a_NX,
+		double 				a_TMax,
+		int 					a_NT,
+		double* 			a_lvs
+	)
+	{
+		if (!(a_S0 > 0) || a_nK < 1 || a_nT < 1 || a_Ks == nullptr ||
+				a_TTEs == nullptr || a_IVs == nullptr || a_lvs == nullptr)
+			throw std::invalid_argument("invalid IV quotes");
+		if (!(a_SMin > 0 && a_SMax > a_SMin && a_TMax > 0) || a_NX < 2 ||
+				a_NT < 2)
+			throw std::invalid_argument("invalid local vol table");
+		for (int i = 0; i < a_nK; ++i)
+			if (!(a_Ks[i] > 0) || (i > 0 && !(a_Ks[i] > a_Ks[i - 1])))
+				throw std::invalid_argument("invalid strikes");
+		for (int j = 0; j < a_nT; ++j)
+			if (!(a_TTEs[j] > 0) || (j > 0 && !(a_TTEs[j] > a_TTEs[j - 1])))
+				throw std::invalid_argument("invalid expiries");
+		for (int n = 0; n < a_nK * a_nT; ++n)
+			if (!(a_IVs[n] > 0))
+				throw std::invalid_argument("invalid implied vol");
+
+		// Per-expiry splines of the total variance in y: [j * nK + i]:
+		int 		nKT = a_nK * a_nT;
+		double* ys 	= new double[nKT];
+		double* ws 	= new double[nKT];
+		double* Ms 	= new double[nKT];
+		for (int j = 0; j < a_nT; ++j) {
+			double T 	= a_TTEs[j];
+			double lF = log(a_S0) + (a_rateB - a_rateA) * T;
+			for (int i = 0; i < a_nK; ++i) {
+				double IV 			 = a_IVs[j * a_nK + i];
+				ys[j * a_nK + i] = log(a_Ks[i]) - lF;
+				ws[j * a_nK + i] = IV * IV * T;
+			}
+			MkNatSpline(a_nK, ys + j * a_nK, ws + j * a_nK, Ms + j * a_nK);
+		}
+
+		double lSMin = log(a_SMin);
+		double dx 	 = log(a_SMax / a_SMin) / double(a_NX - 1);
+		double dt 	 = a_TMax / double(a_NT - 1);
+
+		for (int jt = 0; jt < a_NT; ++jt) {
+			// (the total variance vanishes at t = 0, but the ratios below do
+			// not, so a tiny t is used instead):
+			double T = std::max<double>(dt * jt, 1e-6 * a_TTEs[0]);
+
+			// The expiries around T and the weight of the upper one:
+			int j0 = 0, j1 = 0;
+			double a = 0, Tsc = 1;
+			if (T <= a_TTEs[0])
+				Tsc = T / a_TTEs[0];
+			else if (T >= a_TTEs[a_nT - 1]) {
+				j0  = j1 = a_nT - 1;
+				Tsc = T / a_TTEs[a_nT - 1];
+			}
+			else {
+				j1 = int(std::upper_bound(a_TTEs, a_TTEs + a_nT, T) - a_TTEs);
+				j0 = j1 - 1;
+				a  = (T - a_TTEs[j0]) / (a_TTEs[j1] - a_TTEs[j0]);
+			}
+			double lF = log(a_S0) + (a_rateB - a_rateA) * T;
+
+			for (int ix = 0; ix < a_NX; ++ix) {
+				double y = lSMin + dx * ix - lF;
+				double w0, w01, w02, w1, w11, w12;
+				SplineEval(a_nK, ys + j0 * a_nK, ws + j0 * a_nK, Ms + j0 * a_nK, y,
+									 &w0, &w01, &w02);
+				SplineEval(a_nK, ys + j1 * a_nK, ws + j1 * a_nK, Ms + j1 * a_nK, y,
+									 &w1, &w11, &w12);
+
+				// w and its derivatives at (y, T):
+				double w, wT, wy, wyy;
+				if (j0 == j1) { // flat IV in T
+					w 	= w0 	* Tsc;
+					wT 	= w0 	/ a_TTEs[j0];
+					wy 	= w01 * Tsc;
+					wyy = w02 * Tsc;
+				}
+				else {
+					w 	= (1.0 - a) * w0  + a * w1;
+					wT 	= (w1 - w0) / (a_TTEs[j1] - a_TTEs[j0]);
+					wy 	= (1.0 - a) * w01 + a * w11;
+					wyy = (1.0 - a) * w02 + a * w12;
+				}
+
+				double den = 1.0 - y * wy / w +
+										 0.25 * (-0.25 - 1.0 / w + y * y / (w * w)) * wy * wy +
+										 0.5 * wyy;
+				double lv2 = (wT > 0 && den > 0) ? wT / den : w / T;
+				a_lvs[jt * a_NX + ix] = sqrt(lv2);
+			}
+		}
+		delete[] ys;
+		delete[] ws;
+		delete[] Ms;
+	}
+}
@@ -13,8 +13,11 @@
 
 #include "IRProvider.h"                                                         
 #include "Option.h"
+#include "PxCache.h"
 
 #include <tuple>
+#include <cstring>
+#include <string>
 
 namespace SiriusFM {
 
@@ -37,13 +40,32 @@ namespace SiriusFM {
 			long 					m_maxN;  // max # of S points
 			double* const m_grid;  // 2D grid as 1D array
 			double* const m_ts; 	 // timeline
+			double* const m_taus;  // t-steps: m_taus[j] = m_ts[j+1] - m_ts[j]
 			double* const m_S;		 // S-line
 			double* const m_ES; 	 // E[S](t)
 			double* const m_VarS;  // Var[S](t)
+			double* const m_DFA;   // DF in A from t0 to t
+			double* const m_DFB;   // DF in B from t0 to t
+			double* const m_diffC; // diffusive coeffs sigma^2(S_i) / (2 h^2)
+			double* const m_convC; // convective coeffs S_i / (2 h)
+			double* const m_D2f0;  // d^2f/dS^2 of the cubic spline at t=0 (Bwd)
 			int 					m_N;		 // actual # of S-point
 			int 					m_M;		 // actual #  of t-points
 			int 					m_i0;		 // S(i0) = S0
 			bool					m_isFwd; // last run was Fwd
+			bool 					m_hasGrid; // "m_grid" holds the last run (not so after
+															 // "RunBwdBatch", which keeps 2 layers only)
+			PxCache* 			m_cache; // optional, for "RunBwdBatch" (not owned)
+			std::string 	m_ratesFileA; // (for "m_ratesKey")
+			std::string 	m_ratesFileB;
+			SpecKey 			m_ratesKey; // of the rate files, once a cache is set
+
+			// Min # of S-points for which a t-layer is split between OpenMP
+			// threads (if built with "-fopenmp"); smaller layers are done serially:
+			static constexpr int OMPMinN = 4096;
+
+			// Safety factor for the max stable t-step of the explicit scheme:
+			static constexpr double CFLSafety = 0.8;
 
 		public:
 			// non-default Ctor:
@@ -56,44 +78,80 @@ namespace SiriusFM {
 			)
 			: m_irpA (a_ratesFileA),
 				m_irpB (a_ratesFileB),
-				m_maxN (a_maxN),
 				m_maxM (a_maxM),
-				m_grid (new double[m_maxN * m_maxN]),
+				m_maxN (a_maxN),
+				m_grid (new double[m_maxN * m_maxM]),
 				m_ts	 (new double[m_maxM]),
+				m_taus (new double[m_maxM]),
 				m_S		 (new double[m_maxN]),
 				m_ES	 (new double[m_maxM]),
 				m_VarS (new double[m_maxM]),
+				m_DFA	 (new double[m_maxM]),
+				m_DFB	 (new double[m_maxM]),
+				m_diffC(new double[m_maxN]),
+				m_convC(new double[m_maxN]),
+				m_D2f0 (new double[m_maxN]),
 				m_N		 (0),
 				m_M		 (0),
 				m_i0	 (0),
-				m_isFwd(false)
+				m_isFwd(false),
+				m_hasGrid(false),
+				m_cache(nullptr),
+				m_ratesFileA((a_ratesFileA != nullptr) ? a_ratesFileA : ""),
+				m_ratesFileB((a_ratesFileB != nullptr) ? a_ratesFileB : ""),
+				m_ratesKey{0, 0}
 			{
-				// zero-out all arrays:
-				memset(m_grid, 0, m_maxN * m_maxM * sizeof(double));
+				// zero-out all arrays. NB: the grid itself is not zeroed out: every
+				// column used is fully over-written by "Run", and touching all of
+				// (maxN * maxM) doubles here would commit GBs of memory up-front:
 				memset(m_S, 	 0, m_maxN 					* sizeof(double));
 				memset(m_ts, 	 0, m_maxM 					* sizeof(double));	
+				memset(m_taus, 0, m_maxM 					* sizeof(double));	
 				memset(m_ES, 	 0, m_maxM 					* sizeof(double));		
 				memset(m_VarS, 0, m_maxM 					* sizeof(double));
+				memset(m_DFA,  0, m_maxM 					* sizeof(double));
+				memset(m_DFB,  0, m_maxM 					* sizeof(double));
+				memset(m_diffC,0, m_maxN 					* sizeof(double));
+				memset(m_convC,0, m_maxN 					* sizeof(double));
+				memset(m_D2f0, 0, m_maxN 					* sizeof(double));
 			}
 
 			// non-default Dtor:
 			~GridNOP1D_S3_RKC1() {
 				delete[] (m_grid);
 				delete[] (m_ts);
+				delete[] (m_taus);
 				delete[] (m_S);
 				delete[] (m_ES);
 				delete[] (m_VarS);
+				delete[] (m_DFA);
+				delete[] (m_DFB);
+				delete[] (m_diffC);
+				delete[] (m_convC);
+				delete[] (m_D2f0);
 
 				const_cast<double*&>(m_grid) = nullptr;
 				const_cast<double*&>(m_S) 	 = nullptr;
 				const_cast<double*&>(m_ts) 	 = nullptr;
+				const_cast<double*&>(m_taus) = nullptr;
 				const_cast<double*&>(m_ES) 	 = nullptr;
 				const_cast<double*&>(m_VarS) = nullptr;
+				const_cast<double*&>(m_DFA)  = nullptr;
+				const_cast<double*&>(m_DFB)  = nullptr;
+				const_cast<double*&>(m_diffC)= nullptr;
+				const_cast<double*&>(m_convC)= nullptr;
+				const_cast<double*&>(m_D2f0) = nullptr;
 			}
 
 			//--------------------------------------------------------------------//
 			// "Run": performs Backward or Forward-Induction                      //			
 			//--------------------------------------------------------------------//
+			// By default, the timeline is uniform with "a_tauMins" steps. With   //
+			// "a_tauGrowth" > 1, the steps grow geometrically backwards from the //
+			// expiry (where the payoff kink needs fine steps), up to the max     //
+			// step at which the explicit scheme is still stable. "a_fixDates"    //
+			// (e.g. exercise or monitoring dates) are always on the timeline:    //
+			//--------------------------------------------------------------------//
 			template<bool IsFwd> // =true for Fwd induction
 			void Run
 			(
@@ -104,12 +162,205 @@ namespace SiriusFM {
 				time_t a_t0, 						// abs starting time
 				long a_Nints		 = 500, // # of S-intervals
 				int a_tauMins 	 = 30, 	// TimeStep in mins
-				double a_BFactor = 4.5 	// # of StDs for upper bound
+				double a_BFactor = 4.5, // # of StDs for upper bound
+				double a_tauGrowth = 1.0, 						// t-step growth factor
+				time_t const* a_fixDates = nullptr, 	// dates to be on the timeline
+				int a_nFixDates	 = 0
 			);
 
 			//--------------------------------------------------------------------//
 			// GetPxDeltaGamma0: return Px, Delta and Gamma at t=0                //
 			//--------------------------------------------------------------------//
 			std::tuple<double, double, double> GetPxDeltaGamma0() const;
+
+			//--------------------------------------------------------------------//
+			// GetPxDeltaGamma0 at an arbitrary S in [0, B] (after a Bwd run),    //
+			// from the natural cubic spline through the t=0 layer:               //
+			//--------------------------------------------------------------------//
+			std::tuple<double, double, double> GetPxDeltaGamma0(double a_S) const;
+
+			// Same for "a_n" spots at once (any of the outputs may be NULL):
+			void GetPxDeltaGamma0
+			(
+				double const* a_Ss,
+				int 					a_n,
+				double* 			a_pxs,
+				double* 			a_deltas,
+				double* 			a_gammas
+			) const;
+
+			//--------------------------------------------------------------------//
+			// "GetEurPxsFwd": after a Fwd run, returns discounted European Call  //
+			// and Put prices for "a_nK" strikes at each of "m_M" t-points of the //
+			// timeline, integrating the payoffs against the transition density.  //
+			// Output arrays are [m_M * a_nK] (by-row for each t); either of them //
+			// may be NULL:                                                       //
+			//--------------------------------------------------------------------//
+			void GetEurPxsFwd
+			(
+				double const* a_Ks,
+				int 					a_nK,
+				double* 			a_calls,
+				double* 			a_puts
+			) const;
+
+			// Same for the t-point "a_j" only (output arrays are [a_nK]):
+			void GetEurPxsFwd
+			(
+				int 					a_j,
+				double const* a_Ks,
+				int 					a_nK,
+				double* 			a_calls,
+				double* 			a_puts
+			) const;
+
+			// The timeline of the last run (as YYYY.YearFrac):
+			int GetM() const { return m_M; }
+			double const* GetTs() const { return m_ts; }
+
+			//--------------------------------------------------------------------//
+			// "PxRichardson": prices the option at S0 by Bwd runs on successively//
+			// refined grids (h halved, t-steps growing up to the stability cap,  //
+			// which scales as h^2), until the Richardson error estimate is below //
+			// "a_tol" or the grid max size is reached. Each level re-uses the    //
+			// price from the previous one. Returns (Px, ErrEst, Nints, M) where  //
+			// Px is the extrapolated price and (Nints, M) is the finest grid run://
+			//--------------------------------------------------------------------//
+			std::tuple<double, double, long, int> PxRichardson
+			(
+				Option<AssetClassA, AssetClassB> const* a_option,
+				Diffusion1D const* a_diff,
+				double a_S0,
+				time_t a_t0,
+				double a_tol,
+				long 	 a_Nints0 	 = 100,  // # of S-intervals at the coarsest level
+				int 	 a_tauMins 	 = 5,	 	 // t-step at expiry (at all levels)
+				double a_BFactor 	 = 4.5,
+				int 	 a_maxLevels = 6
+			);
+
+			//--------------------------------------------------------------------//
+			// "RunBwdBatch": Backward Induction for "a_K" options with the same  //
+			// expiry and underlying on one common grid; all payoff columns are   //
+			// marshalled together. Returns (Px, Delta, Gamma) at t=0 for each    //
+			// option in "a_res" (the grid itself is not stored). With a cache    //
+			// attached, the results are looked up there first, and only the     //
+			// missing ones are computed (the result of an option does not depend //
+			// on the other options of the batch):                                //
+			//--------------------------------------------------------------------//
+			void RunBwdBatch
+			(
+				Option<AssetClassA, AssetClassB> const* const* a_options,
+				int 	 a_K,										// # of options
+				Diffusion1D const* a_diff,
+				double a_S0,
+				time_t a_t0,
+				std::tuple<double, double, double>* a_res, // output [a_K]
+				long 	 a_Nints	 = 500,
+				int 	 a_tauMins = 30,
+				double a_BFactor = 4.5,
+				double a_tauGrowth = 1.0,
+				time_t const* a_fixDates = nullptr,
+				int 	 a_nFixDates = 0
+			);
+
+			// Attaches a result cache to "RunBwdBatch" (NULL to detach). The
+			// rate files are hashed (once) for the keys here, unless their key
+			// "a_ratesKey" is given (eg shared by many grids):
+			void SetCache(PxCache* a_cache, SpecKey a_ratesKey = SpecKey{0, 0}) {
+				if (a_cache != nullptr && m_ratesKey.IsEmpty())
+					m_ratesKey = a_ratesKey.IsEmpty()
+						? HashRates<AProvider, BProvider>(m_ratesFileA.c_str(),
+																							m_ratesFileB.c_str())
+						: a_ratesKey;
+				m_cache = a_cache;
+			}
+
+		private:
+			// "RunBwdBatch" itself, without the cache:
+			void RunBwdBatchNC
+			(
+				Option<AssetClassA, AssetClassB> const* const* a_options,
+				int 	 a_K,
+				Diffusion1D const* a_diff,
+				double a_S0,
+				time_t a_t0,
+				std::tuple<double, double, double>* a_res,
+				long 	 a_Nints,
+				int 	 a_tauMins,
+				double a_BFactor,
+				double a_tauGrowth,
+				time_t const* a_fixDates,
+				int 	 a_nFixDates
+			);
+
+			//--------------------------------------------------------------------//
+			// "MkGrid": constructs the timeline "m_ts" (up to the option expiry) //
+			// and the S-line "m_S" (with S0 exactly on the grid at "m_i0");      //
+			// returns the S-step h:                                              //
+			//--------------------------------------------------------------------//
+			double MkGrid
+			(
+				Option<AssetClassA, AssetClassB> const* a_option,
+				Diffusion1D const* a_diff,
+				double a_S0,
+				time_t a_t0,
+				long 	 a_Nints,
+				int 	 a_tauMins,
+				double a_BFactor,
+				double a_tauGrowth,
+				time_t const* a_fixDates,
+				int 	 a_nFixDates
+			);
+
+			//--------------------------------------------------------------------//
+			// "MkTimeLine": fills in "m_ts", "m_taus" and "m_M":                 //
+			//--------------------------------------------------------------------//
+			void MkTimeLine
+			(
+				time_t a_t0,
+				time_t a_T,
+				time_t a_tauSec,
+				double a_tauGrowth,
+				time_t const* a_fixDates,
+				int 	 a_nFixDates,
+				time_t a_capSec 	// max t-step (0 for none)
+			);
+
+			//--------------------------------------------------------------------//
+			// "MkCurves": integrates E[S](t), Var[S](t) and the DFs along the    //
+			// timeline:                                                          //
+			//--------------------------------------------------------------------//
+			void MkCurves
+			(
+				Option<AssetClassA, AssetClassB> const* a_option,
+				Diffusion1D const* a_diff,
+				double a_S0
+			);
+
+			//--------------------------------------------------------------------//
+			// "MkDiffCoeffs": fills in "m_diffC" at time "a_t" (one "sigma" call //
+			// per S-node):                                                       //
+			//--------------------------------------------------------------------//
+			void MkDiffCoeffs(Diffusion1D const* a_diff, double a_t, double a_h);
+
+			//--------------------------------------------------------------------//
+			// "MkSpline0": fills in "m_D2f0" for the t=0 layer:                  //
+			//--------------------------------------------------------------------//
+			void MkSpline0();
+
+			//--------------------------------------------------------------------//
+			// "EurPxsFwdLayer": European prices at the t-point "a_j" after a Fwd //
+			// run; "a_P0" is a scratch array of (2 * m_N):                       //
+			//--------------------------------------------------------------------//
+			void EurPxsFwdLayer
+			(
+				int 					a_j,
+				double const* a_Ks,
+				int 					a_nK,
+				double* 			a_calls,
+				double* 			a_puts,
+				double* 			a_P0
+			) const;
 	};
 }
@@ -1,14 +1,21 @@
 //==========================================================================//
 //                         "GridNOP1D_S3_RKC1.hpp"                          //
-// Implementation of "Run" and "GetPxDeltaGamma0" methods                   //
+// Implementation of "Run", "RunBwdBatch", "PxRichardson", "GetPxDeltaGamma0"//
+// (at S0 and at arbitrary S) and "GetEurPxsFwd" methods                    //
 //==========================================================================//
 
 #pragma once                                                                    
                                                                                  
 #include "GridNOP1D_S3_RKC1.h"
+#include "DiffusionTraits.h"
+#include "Instr.h"
 #include "Time.h"
 
 #include <stdexcept>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <utility>
 
 namespace SiriusFM {
 
@@ -33,14 +40,17 @@ namespace SiriusFM {
 		time_t a_t0,	 	  // abs starting time
 		long 	 a_Nints,  	// # of S-intervals
 		int 	 a_tauMins, // TimeStep in mins
-		double a_BFactor  // # of StDs for upper boundary
+		double a_BFactor, // # of StDs for upper boundary
+		double a_tauGrowth,
+		time_t const* a_fixDates,
+		int 	 a_nFixDates
 	)
 	{
 		//----------------------------------------------------------------------//
 		// Construct the grid:                                                  //
 		//----------------------------------------------------------------------//
 		assert(a_option != nullptr && a_diff != nullptr && a_Nints > 0 
-																						&& a_tauMins > && a_BFactor > 0);
+																						&& a_tauMins > 0 && a_BFactor > 0);
 		
 		if (IsFwd && a_option->m_isAmerican)
 			throw std::invalid_argument("American options are not supported in Fwd");
@@ -52,88 +62,22 @@ namespace SiriusFM {
 		if (a_option->m_isAsian)
 			throw std::invalid_argument("Asian options aren`t supported by 1D-grid");
 		
-		m_isFwd = IsFwd;
+		m_isFwd 	= IsFwd;
+		m_hasGrid = false; // (until the run is complete)
 
-		// time to option expir as Year Frac:
-		double TTE = YearFracInt(a_option->m_expirTime - a_t0);
-
-		// fill in the timeline:
-		long tauSec = a_tauMins * 60;
-		long Mints  = (a_option->m_expirTime - a_t0) / tauSec;
-																										// number of t-intervals
-		if (TTE <= 0 || Mints <= 0)                                                               
-			throw std::invalid_argument("Option has already expired or too close");
-		
-		m_M = Mints + 1; // # of t-points
-	
-		if (m_M > m_maxM)
-			throw std::invalid_argument("too many t-points");
-
-		double tau = TTE / double(Mints); // time step
-
-		double integrAB = 0.0;
-		m_ES	[0]				= a_S0;
-		m_VarS[0] 			= 0;
-
-		for (int j = 0; j < m_M; ++j) {
-			// Advance the timeline:
-			double t = YearFrac(a_t0 + j * tauSec);
-			m_ts[j]  = t;
-		
-			// Integrate E[S](t) and Var[S](t) curves:
-			// take rB(t) - rA(t) and cut the negative values to nake sure the grid 
-			// upper boundary is expanding with time:
-
-			double rA = m_irpA.r(a_option->m_assetA, t);
-			double rB = m_irpB.r(a_option->m_assetB, t);
-			double rateDiff = std::max<double>(rB - rA, 0.0);
-			
-			// integrated rates:
-			if (j < m_M - 1) {
-				integrAB += rateDiff * tau;
-
-				// E[St]:
-				m_ES[j+1] = a_S0 * exp(integrAB); 
-			
-				// Var[St]:
-				double sigma = a_diff->sigma(m_ES[j], t);
-				m_VarS[j+1]  = m_VarS[j] + sigma * sigma * tau;
-			}
-		}
-
-		double StDS = sqrt(m_VarS[m_M - 1]); // Estimated StD  at the end:
-		
-		double B = m_ES[m_M - 1] + a_BFactor * StDS; // Upper bound for S:
-
-		// Generate the S-line:
-		double h = B / double(a_Nints); // S-step
-
-		// S0 should be exactly on the grid:
-		m_i0 = int(round(a_S0 / h));
-		h = a_S0 / double(m_i0);
-		
-		if (!std::isfinite(h))
-			throw std::invalid_argument("S0 is too small, try increasing N");
-		
-		B = h * double(a_Nints); // adjust the upper bound B
-			
-		m_N = a_Nints + 1; // # of S-points
-		
-		if (m_N > m_maxN)
-			throw std::invalid_argument("Nints is too large");
+		// Construct the timeline and the S-line:
+		double h = MkGrid(a_option, a_diff, a_S0, a_t0, a_Nints, a_tauMins,
+											a_BFactor, a_tauGrowth, a_fixDates, a_nFixDates);
 
 		// NB: the Grid is stored by-column (S-continious) for better locality
 		// payOff is used in Bwd Induction only:
 		double* payOff = !IsFwd ? (m_grid + m_N * (m_M - 1)) : nullptr; 
 																															// last column
 	
-		for (int i = 0; i < m_N; ++i) {
-			m_S[i] = double(i) * h;
-			
-			// Create the payoff at t=T on the grid. The grid is stored by-column:
-			if (!IsFwd)
+		// Create the payoff at t=T on the grid. The grid is stored by-column:
+		if (!IsFwd)
+			for (int i = 0; i < m_N; ++i)
 				payOff[i] = a_option->Payoff(1, m_S + i, m_ts + (m_M - 1));
-		}
 		
 		// initial condition for Fwd:
 		if (IsFwd) {
@@ -163,55 +107,69 @@ namespace SiriusFM {
 		for (int j = 0; j < m_M - 1; ++j)
 			m_grid[j * m_N] = fa; // low bound
 
-		// Time Marshalling:
-		double D2 = 2 * h * h; // denum in the diffusive term
+		// Diffusive and convective coeffs on the S-grid. If the diffusion is
+		// time-homogeneous, "sigma" is evaluated only once per node here,
+		// otherwise "m_diffC" is re-computed at each t-layer:
+		constexpr bool IsTH = IsTimeHomog<Diffusion1D>::value;
+
+		for (int i = 0; i < m_N; ++i)
+			m_convC[i] = m_S[i] / (2 * h);
 
+		if (IsTH)
+			MkDiffCoeffs(a_diff, m_ts[0], h);
+
+		// Time Marshalling:
 		for (int j = IsFwd ? 0 :  m_M - 1;
 				IsFwd ? (j <= m_M - 2) : (j >= 1);
 				j += (IsFwd ? 1 : -1)) 
 		{
-			double const*  fj = m_grid + j * m_N; // prev time layer (j)
-			double* 		  fj1 = const_cast<double*>(IsFwd ? (fj + m_N) : (fj - m_N));
+			SFM_INSTR(
+				uint64_t tc = ReadTSC();
+				g_instr.m_gridLayers += 1;
+				g_instr.m_gridNodes  += m_N;
+			)
+			double const* __restrict__ fj = m_grid + j * m_N; // prev layer (j)
+			double* __restrict__ fj1 =
+				const_cast<double*>(IsFwd ? (fj + m_N) : (fj - m_N));
 																	// curr time layer to be filled in (j+-1)
 			double tj 		= m_ts[j];
 			double rateAj = m_irpA.r(a_option->m_assetA, tj);
 			double rateBj = m_irpB.r(a_option->m_assetB, tj);
-			double C1 		= (rateBj - rateAj) / (2 * h); 
-																						// coeff in the convective term
-			fj1[0] = fa; // low bound
+			double rDiff	= rateBj - rateAj; // coeff in the convective term
+			double tau 		= IsFwd ? m_taus[j] : m_taus[j - 1];
 
-//#			pragma omp parallel for
-			for (int i = 1; i <= m_N - 2; ++i) {
-				double Si   = m_S[i];
-				double fjiM = fj [i - 1];
-				double fji  = fj [i];
-				double fjiP = fj [i + 1];
-
-				double sigma = a_diff->sigma(Si, tj); // vol
-
-				double DfDt = 0;
-
-				if (IsFwd) {
-					// Fokker-Planch:
-					double SiM 		= m_S[i - 1];
-					double SiP 		= m_S[i + 1];
-					double sigmaP = a_diff->sigma(SiP, tj);
-					double sigmaM = a_diff->sigma(SiM, tj);
-
-					DfDt = - C1 * (SiP * fjiP - SiM * fjiM)
-								 + (sigmaP * sigmaP * fjiP - 2 * sigma * sigma * fji
-								 + sigmaM * sigmaM * fjiM) / D2;
-					}
-
-				else {
-					// Black-Scholes-Merton:
-					double DfDt = rateBj * fji 							// reactive term
-											- C1 * Si * (fjiP - fjiM) 	// convective term
-											- sigma * sigma / D2 * (fjiP - 2 * fji + fjiM);
-				}
+			if (!IsTH)
+				MkDiffCoeffs(a_diff, tj, h);
+			SFM_LAP(tc, PhaseE::Coeffs)
 
-				//FIXME: we use Euler`s method insted of RKC1
-				fj1[i] = fji - tau * DfDt;
+			double const* __restrict__ dC = m_diffC;
+			double const* __restrict__ cC = m_convC;
+
+			fj1[0] = fa; // low bound
+
+			//FIXME: we use Euler`s method insted of RKC1
+			if (IsFwd) {
+				// Fokker-Planck:
+				// DfDt = - rDiff * d(S f)/dS + 1/2 * d^2(sigma^2 f)/dS^2:
+#ifdef _OPENMP
+#				pragma omp parallel for simd if(m_N > OMPMinN)
+#endif
+				for (int i = 1; i <= m_N - 2; ++i)
+					fj1[i] = fj[i] + tau *
+						(dC[i + 1] * fj[i + 1] - 2 * dC[i] * fj[i] + dC[i - 1] * fj[i - 1]
+						- rDiff * (cC[i + 1] * fj[i + 1] - cC[i - 1] * fj[i - 1]));
+			}
+			else {
+				// Black-Scholes-Merton (going backwards, so -DfDt is added):
+				// - DfDt = sigma^2/2 * d^2f/dS^2 + rDiff * S * df/dS - rateB * f:
+#ifdef _OPENMP
+#				pragma omp parallel for simd if(m_N > OMPMinN)
+#endif
+				for (int i = 1; i <= m_N - 2; ++i)
+					fj1[i] = fj[i] + tau *
+						(dC[i] * (fj[i + 1] - 2 * fj[i] + fj[i - 1])		// diffusive term
+						+ rDiff * cC[i] * (fj[i + 1] - fj[i - 1])				// convective term
+						- rateBj * fj[i]);															// reactive term
 			}
 
 			fj1[m_N - 1] = (!IsFwd && isNeumann) ? (fj1[m_N - 2] + UBC) : UBC; 
@@ -229,7 +187,674 @@ namespace SiriusFM {
 					fj1[i] = std::max<double>(fj1[i], intrVal);
 				}
 			}
+			SFM_LAP(tc, PhaseE::Step)
+		} // end of Time Marshalling
+
+		// For Px, Delta and Gamma at any S:
+		if (!IsFwd)
+			MkSpline0();
+		m_hasGrid = true;
+	}
+
+	//------------------------------------------------------------------------//
+	// "RunBwdBatch" implementation: the cache look-ups:                      //
+	//------------------------------------------------------------------------//
+	template                                                                      
+	<                                                                             
+		typename Diffusion1D, typename AProvider, typename BProvider,               
+		typename AssetClassA, typename AssetClassB                                  
+	>
+	void GridNOP1D_S3_RKC1<Diffusion1D, AProvider,
+															BProvider, AssetClassA, AssetClassB>::
+	RunBwdBatch
+	(
+		Option<AssetClassA, AssetClassB> const* const* a_options,
+		int 	 a_K,
+		Diffusion1D const* a_diff,
+		double a_S0,
+		time_t a_t0,
+		std::tuple<double, double, double>* a_res,
+		long 	 a_Nints,
+		int 	 a_tauMins,
+		double a_BFactor,
+		double a_tauGrowth,
+		time_t const* a_fixDates,
+		int 	 a_nFixDates
+	)
+	{
+		assert(a_options != nullptr && a_K > 0 && a_diff != nullptr
+					 && a_res != nullptr && (a_nFixDates == 0 || a_fixDates != nullptr));
+
+		// The key of an option is that of its spec and of all other inputs
+		// (none if the diffusion has no key: then nothing is cached):
+		SpecHasher h0;
+		h0.Add("GridNOP1D_S3_RKC1::RunBwdBatch");
+		if (m_cache == nullptr || !HashDiffusion(h0, *a_diff)) {
+			RunBwdBatchNC(a_options, a_K, a_diff, a_S0, a_t0, a_res, a_Nints,
+										a_tauMins, a_BFactor, a_tauGrowth, a_fixDates, a_nFixDates);
+			return;
+		}
+		h0.Add(m_ratesKey).Add(a_S0).Add(int64_t(a_t0)).Add(a_Nints)
+			.Add(a_tauMins).Add(a_BFactor).Add(a_tauGrowth).Add(a_nFixDates);
+		for (int d = 0; d < a_nFixDates; ++d)
+			h0.Add(int64_t(a_fixDates[d]));
+
+		// the misses are compacted to the front of "opts":
+		Option<AssetClassA, AssetClassB> const** opts =
+			new Option<AssetClassA, AssetClassB> const*[a_K];
+		SpecKey* keys = new SpecKey[a_K];
+		int* 		 idxs = new int[a_K];
+		int 		 nM 	= 0;
+
+		for (int k = 0; k < a_K; ++k) {
+			SpecHasher h = h0;
+			PxVal 		 val;
+			if (a_options[k]->HashSpec(h)) {
+				keys[nM] = h.GetKey();
+				if (m_cache->Get(keys[nM], &val)) {
+					a_res[k] = std::make_tuple(val.m_px, val.m_delta, val.m_gamma);
+					continue;
+				}
+			}
+			else
+				keys[nM] = SpecKey{0, 0}; // not cacheable
+
+			opts[nM] = a_options[k];
+			idxs[nM] = k;
+			++nM;
+		}
+
+		if (nM > 0) {
+			std::tuple<double, double, double>* res =
+				new std::tuple<double, double, double>[nM];
+			try {
+				RunBwdBatchNC(opts, nM, a_diff, a_S0, a_t0, res, a_Nints, a_tauMins,
+											a_BFactor, a_tauGrowth, a_fixDates, a_nFixDates);
+			}
+			catch (...) {
+				delete[] res;
+				delete[] opts;
+				delete[] keys;
+				delete[] idxs;
+				throw;
+			}
+
+			for (int m = 0; m < nM; ++m) {
+				a_res[idxs[m]] = res[m];
+				if (!keys[m].IsEmpty())
+					m_cache->Put(keys[m], PxVal{std::get<0>(res[m]),
+																			std::get<1>(res[m]),
+																			std::get<2>(res[m]), NAN});
+			}
+			delete[] res;
+		}
+		delete[] opts;
+		delete[] keys;
+		delete[] idxs;
+	}
+
+	//------------------------------------------------------------------------//
+	// "RunBwdBatchNC" implementation:                                        //
+	//------------------------------------------------------------------------//
+	template                                                                      
+	<                                                                             
+		typename Diffusion1D, typename AProvider, typename BProvider,               
+		typename AssetClassA, typename AssetClassB                                  
+	>
+	void GridNOP1D_S3_RKC1<Diffusion1D, AProvider,
+															BProvider, AssetClassA, AssetClassB>::
+	RunBwdBatchNC
+	(
+		Option<AssetClassA, AssetClassB> const* const* a_options,
+		int 	 a_K,
+		Diffusion1D const* a_diff,
+		double a_S0,
+		time_t a_t0,
+		std::tuple<double, double, double>* a_res,
+		long 	 a_Nints,
+		int 	 a_tauMins,
+		double a_BFactor,
+		double a_tauGrowth,
+		time_t const* a_fixDates,
+		int 	 a_nFixDates
+	)
+	{
+		assert(a_options != nullptr && a_K > 0 && a_diff != nullptr 
+					 && a_res != nullptr && a_Nints > 0 && a_tauMins > 0 
+					 && a_BFactor > 0 && a_S0 > 0);
+
+		// All options must share the expiry and the underlying:
+		Option<AssetClassA, AssetClassB> const* opt0 = a_options[0];
+
+		for (int k = 0; k < a_K; ++k) {
+			Option<AssetClassA, AssetClassB> const* opt = a_options[k];
+			assert(opt != nullptr);
+
+			if (opt->m_isAsian)
+				throw std::invalid_argument("Asian options aren`t supported by 1D-grid");
+
+			if (opt->m_expirTime != opt0->m_expirTime 
+					|| opt->m_assetA != opt0->m_assetA 
+					|| opt->m_assetB != opt0->m_assetB)
+				throw std::invalid_argument("Batch options must have same expiry and "
+																		"underlying");
+		}
+
+		// The grid geometry depends on the diffusion, expiry and rates only (not
+		// on the payoffs), so a single S-line is common to all options:
+		// (the S-line and the timeline are re-made, but the batch results are
+		// not in "m_grid", so the "Get*" accessors are invalid until "Run"):
+		m_hasGrid = false;
+		double h = MkGrid(opt0, a_diff, a_S0, a_t0, a_Nints, a_tauMins, a_BFactor,
+											a_tauGrowth, a_fixDates, a_nFixDates);
+		m_isFwd = false;
+
+		// Only 2 t-layers are kept, each one stored by-node with "a_K" option
+		// values per node contiguous, so the stencil is SIMD across options.
+		// "exer" holds the exercise values (-inf for non-American options),
+		// "fa", "nm" and "UBC" - the per-option boundary conditions:
+		long NK = long(m_N) * a_K;
+		double* buff = new double[3 * NK + 3 * a_K];
+		double* fj   = buff;
+		double* fj1  = fj   + NK;
+		double* exer = fj1  + NK;
+		double* fa   = exer + NK;
+		double* nm   = fa   + a_K; // 1 for Neumann-type upper BC, 0 otherwise
+		double* UBC  = nm   + a_K;
+
+		// Payoffs at t=T; for non-Asian options they are also the intrinsic 
+		// values at any t:
+		for (int i = 0; i < m_N; ++i)
+			for (int k = 0; k < a_K; ++k) {
+				double po = a_options[k]->Payoff(1, m_S + i, m_ts + (m_M - 1));
+				fj  [i * a_K + k] = po;
+				exer[i * a_K + k] = a_options[k]->m_isAmerican ? po : -INFINITY;
+			}
+
+		bool anyAmerican = false;
+
+		for (int k = 0; k < a_K; ++k) {
+			double poN1 = fj[(m_N - 1) * a_K + k];
+			double poN2 = fj[(m_N - 2) * a_K + k];
+			fa [k] = fj[k];
+			nm [k] = (poN1 != 0) ? 1.0 : 0.0;
+			UBC[k] = (poN1 != 0) ? (poN1 - poN2) : 0.0;
+			anyAmerican |= a_options[k]->m_isAmerican;
+		}
+
+		constexpr bool IsTH = IsTimeHomog<Diffusion1D>::value;
+
+		for (int i = 0; i < m_N; ++i)
+			m_convC[i] = m_S[i] / (2 * h);
+
+		if (IsTH)
+			MkDiffCoeffs(a_diff, m_ts[0], h);
+
+		// Time Marshalling (Bwd only):
+		for (int j = m_M - 1; j >= 1; --j) {
+			double tj 		= m_ts[j];
+			double rateAj = m_irpA.r(opt0->m_assetA, tj);
+			double rateBj = m_irpB.r(opt0->m_assetB, tj);
+			double rDiff	= rateBj - rateAj;
+			double tau 		= m_taus[j - 1];
+
+			if (!IsTH)
+				MkDiffCoeffs(a_diff, tj, h);
+
+			double const* __restrict__ gj  = fj;
+			double* 			__restrict__ gj1 = fj1;
+			double const* __restrict__ ex  = exer;
+			int K = a_K;
+
+			for (int k = 0; k < K; ++k)
+				gj1[k] = fa[k]; // low bound
+
+#ifdef _OPENMP
+#			pragma omp parallel for if(NK > OMPMinN)
+#endif
+			for (int i = 1; i <= m_N - 2; ++i) {
+				// Same BSM stencil as in "Run", as 3 coeffs per node:
+				double cD = m_diffC[i];
+				double cC = rDiff * m_convC[i];
+				double lo = tau * (cD - cC);
+				double di = 1.0 - tau * (2 * cD + rateBj);
+				double up = tau * (cD + cC);
+
+				double const* gM = gj  + (i - 1) * K;
+				double const* g  = gM  + K;
+				double const* gP = g   + K;
+				double* 			g1 = gj1 + i * K;
+
+#ifdef _OPENMP
+#				pragma omp simd
+#endif
+				for (int k = 0; k < K; ++k)
+					g1[k] = lo * gM[k] + di * g[k] + up * gP[k];
+			}
+
+			// upper bound:
+			double* gN1 = gj1 + (m_N - 1) * K;
+			double* gN2 = gN1 - K;
+			for (int k = 0; k < K; ++k)
+				gN1[k] = nm[k] * gN2[k] + UBC[k];
+
+			// American projection, per column:
+			if (anyAmerican)
+				for (long ik = 0; ik < NK; ++ik)
+					gj1[ik] = std::max<double>(gj1[ik], ex[ik]);
+
+			std::swap(fj, fj1);
 		} // end of Time Marshalling
+
+		// Now "fj" is the t=0 layer. Get (Px, Delta, Gamma) at S0 per option:
+		for (int k = 0; k < a_K; ++k) {
+			double px    = fj[m_i0 * a_K + k];
+			double delta = 0;
+			double gamma = 0;
+
+			if (0 < m_i0 && m_i0 <= m_N - 2) {
+				double fM = fj[(m_i0 - 1) * a_K + k];
+				double fP = fj[(m_i0 + 1) * a_K + k];
+				delta = (fP - fM) / (2 * h);
+				gamma = (fP - 2 * px + fM) / (h * h);
+			}
+			else if (m_i0 == 0)
+				delta = (fj[a_K + k] - px) / h;
+
+			else
+				delta = (px - fj[(m_N - 2) * a_K + k]) / h;
+
+			a_res[k] = std::make_tuple(px, delta, gamma);
+		}
+
+		delete[] buff;
+	}
+
+	//------------------------------------------------------------------------//
+	// "PxRichardson" implementation:                                         //
+	//------------------------------------------------------------------------//
+	// The explicit scheme error is C1 h^2 + C2 tau. With tau capped by the   //
+	// stability limit (~ h^2), both terms scale as h^2, so for 2 levels with //
+	// r = h0 / h1 (about 2, as S0 is kept on the grid):                      //
+	// Px* = Px1 + (Px1 - Px0) / (r^2 - 1), and |Px* - Px1| is the error      //
+	// estimate; from the 3rd level on, the change in Px* is accounted for as //
+	// well, in case the convergence is not yet asymptotic.                   //
+	// The expiry step ("a_tauMins") is the same at all levels, so the steps  //
+	// growing from it to the cap do not scale as h^2 (until the cap is below //
+	// it), and their error is not extrapolated away. It is kept so anyway:   //
+	// these steps span a few days before expiry, where the payoff kink wants //
+	// short steps at any h, and their error is negligible. Eg for a 1y ATM   //
+	// GBM Put (20% vol), the Px* of 5 and 240 mins differ by < 1e-6 at the   //
+	// 3rd level and < 1e-7 at the 4th (then within 3e-7 of BSM), while the   //
+	// h^2 corrections there are ~5e-4 and ~1e-4. Scaling the step by h^2     //
+	// would instead soon run into the 1 min resolution of the timeline:      //
+	//------------------------------------------------------------------------//
+	template                                                                      
+	<                                                                             
+		typename Diffusion1D, typename AProvider, typename BProvider,               
+		typename AssetClassA, typename AssetClassB                                  
+	>
+	std::tuple<double, double, long, int> GridNOP1D_S3_RKC1<Diffusion1D, 
+												AProvider, BProvider, AssetClassA, AssetClassB>::
+	PxRichardson
+	(
+		Option<AssetClassA, AssetClassB> const* a_option,
+		Diffusion1D const* a_diff,
+		double a_S0,
+		time_t a_t0,
+		double a_tol,
+		long 	 a_Nints0,
+		int 	 a_tauMins,
+		double a_BFactor,
+		int 	 a_maxLevels
+	)
+	{
+		assert(a_tol > 0 && a_Nints0 > 0 && a_maxLevels >= 2);
+
+		// Growth of t-steps from expiry up to the stability cap:
+		constexpr double TauGrowth = 1.05;
+
+		double pxP 	= 0; 				// Px at the prev level
+		double hP 	= 0; 				// h  at the prev level
+		double pxEP = NAN; 			// extrapolated Px at the prev level
+		double pxE 	= NAN;
+		double err 	= INFINITY;
+		long 	 N 		= a_Nints0;
+		long 	 NLast = 0;
+		int 	 MLast = 0;
+
+		for (int l = 0; l < a_maxLevels && N < m_maxN; ++l, N *= 2) {
+			// Stop if the next level would not fit into the grid (# of t-points
+			// is roughly x4 per level):
+			if (l > 0 && 4 * long(MLast) > m_maxM)
+				break;
+
+			Run<false>(a_option, a_diff, a_S0, a_t0, N, a_tauMins, a_BFactor,
+								 TauGrowth);
+
+			double px = m_grid[m_i0]; // j=0
+			double h 	= m_S[1] - m_S[0];
+
+			if (!std::isfinite(px))
+				break;
+
+			NLast = N;
+			MLast = m_M;
+
+			if (l > 0) {
+				double r2 = (hP / h) * (hP / h);
+				pxE = px + (px - pxP) / (r2 - 1);
+				err = fabs(pxE - px);
+
+				if (l > 1)
+					err = std::max<double>(err, fabs(pxE - pxEP));
+
+				if (err <= a_tol)
+					break;
+			}
+			else
+				pxE = px;
+
+			pxP  = px;
+			hP 	 = h;
+			pxEP = pxE;
+		}
+		return std::make_tuple(pxE, err, NLast, MLast);
+	}
+
+	//------------------------------------------------------------------------//
+	// "MkGrid" implementation:                                               //
+	//------------------------------------------------------------------------//
+	template                                                                      
+	<                                                                             
+		typename Diffusion1D, typename AProvider, typename BProvider,               
+		typename AssetClassA, typename AssetClassB                                  
+	>
+	double GridNOP1D_S3_RKC1<Diffusion1D, AProvider,
+															BProvider, AssetClassA, AssetClassB>::
+	MkGrid
+	(
+		Option<AssetClassA, AssetClassB> const* a_option,
+		Diffusion1D const* a_diff,
+		double a_S0,
+		time_t a_t0,
+		long 	 a_Nints,
+		int 	 a_tauMins,
+		double a_BFactor,
+		double a_tauGrowth,
+		time_t const* a_fixDates,
+		int 	 a_nFixDates
+	)
+	{
+		assert(a_tauGrowth >= 1 && (a_nFixDates == 0 || a_fixDates != nullptr));
+
+		time_t tauSec = time_t(a_tauMins) * SEC_IN_MIN;
+
+		if (a_option->m_expirTime - a_t0 < tauSec)
+			throw std::invalid_argument("Option has already expired or too close");
+
+		// Construct the timeline (with no cap on the steps yet) and integrate 
+		// E[S](t) and Var[S](t) along it:
+		MkTimeLine(a_t0, a_option->m_expirTime, tauSec, a_tauGrowth,
+							 a_fixDates, a_nFixDates, 0);
+		MkCurves(a_option, a_diff, a_S0);
+
+		double StDS = sqrt(m_VarS[m_M - 1]); // Estimated StD  at the end:
+		
+		double B = m_ES[m_M - 1] + a_BFactor * StDS; // Upper bound for S:
+
+		double h = B / double(a_Nints); // S-step
+
+		// S0 should be exactly on the grid:
+		m_i0 = int(round(a_S0 / h));
+		h = a_S0 / double(m_i0);
+		
+		if (!std::isfinite(h))
+			throw std::invalid_argument("S0 is too small, try increasing N");
+		
+		B = h * double(a_Nints); // adjust the upper bound B
+			
+		m_N = a_Nints + 1; // # of S-points
+		
+		if (m_N > m_maxN)
+			throw std::invalid_argument("Nints is too large");
+
+		// Generate the S-line:
+		for (int i = 0; i < m_N; ++i)
+			m_S[i] = double(i) * h;
+
+		// Growing steps (or any steps of a timeline with fixed dates) are capped
+		// by the stability limit of the explicit scheme:
+		// tau * (2 sigma^2 / (2 h^2) + rB) <= 1 (otherwise the stencil coeffs are
+		// no longer positive), with a safety margin:
+		if (a_tauGrowth > 1 || a_nFixDates > 0) {
+			MkDiffCoeffs(a_diff, m_ts[0], h);
+			double maxRB = 0;
+
+			for (int j = 0; j < m_M; ++j)
+				maxRB = std::max<double>(maxRB, m_irpB.r(a_option->m_assetB, m_ts[j]));
+
+			double maxC = maxRB;
+
+			for (int i = 0; i < m_N; ++i)
+				maxC = std::max<double>(maxC, 2 * m_diffC[i] + maxRB);
+
+			time_t capSec = 
+				std::max<time_t>(time_t(CFLSafety / maxC * AVG_SEC_IN_YEAR), 1);
+
+			MkTimeLine(a_t0, a_option->m_expirTime, tauSec, a_tauGrowth,
+								 a_fixDates, a_nFixDates, capSec);
+			MkCurves(a_option, a_diff, a_S0);
+		}
+		return h;
+	}
+
+	//------------------------------------------------------------------------//
+	// "MkTimeLine" implementation:                                           //
+	//------------------------------------------------------------------------//
+	// With no growth and no fixed dates, [t0, T] is split into equal steps   //
+	// of about "a_tauSec". Otherwise, the timeline is built backwards from T://
+	// the steps grow by "a_tauGrowth" (capped by "a_capSec" if non-0), each  //
+	// the fixed dates in (t0, T) becomes a t-point, and a remainder of less  //
+	// than 1/4 step at t0 is merged into the last step:                      //
+	//------------------------------------------------------------------------//
+	template                                                                      
+	<                                                                             
+		typename Diffusion1D, typename AProvider, typename BProvider,               
+		typename AssetClassA, typename AssetClassB                                  
+	>
+	void GridNOP1D_S3_RKC1<Diffusion1D, AProvider,
+															BProvider, AssetClassA, AssetClassB>::
+	MkTimeLine
+	(
+		time_t a_t0,
+		time_t a_T,
+		time_t a_tauSec,
+		double a_tauGrowth,
+		time_t const* a_fixDates,
+		int 	 a_nFixDates,
+		time_t a_capSec
+	)
+	{
+		if (a_tauGrowth == 1 && a_nFixDates == 0) {
+			long Mints = (a_T - a_t0) / a_tauSec; // number of t-intervals
+			m_M = Mints + 1; 											// # of t-points
+
+			if (m_M > m_maxM)
+				throw std::invalid_argument("too many t-points");
+
+			for (int j = 0; j < m_M; ++j)
+				m_ts[j] = YearFrac(a_t0 + (a_T - a_t0) * j / Mints);
+
+			for (int j = 0; j < m_M - 1; ++j)
+				m_taus[j] = YearFracInt(a_T - a_t0) / double(Mints);
+			return;
+		}
+
+		// The t-points (in secs) are generated backwards; "fixDs" are the fixed 
+		// dates sorted in ascending order:
+		time_t* secs  = new time_t[m_maxM + a_nFixDates];
+		time_t* fixDs = secs + m_maxM;
+		std::copy(a_fixDates, a_fixDates + a_nFixDates, fixDs);
+		std::sort(fixDs, fixDs + a_nFixDates);
+
+		int 	 n 		= 0;
+		int 	 k 		= a_nFixDates - 1; // next fixed date (backwards)
+		time_t t 		= a_T;
+		double step = (a_capSec > 0)
+									? std::min<double>(double(a_tauSec), double(a_capSec))
+									: double(a_tauSec);
+		secs[n++] 	= t;
+
+		while (t > a_t0) {
+			while (k >= 0 && fixDs[k] >= t)
+				--k;
+
+			time_t st 	= time_t(step);
+			time_t next = t - st;
+
+			if (next - a_t0 < st / 4)
+				next = a_t0;
+
+			if (k >= 0 && fixDs[k] > next && fixDs[k] > a_t0)
+				next = fixDs[k];
+
+			if (n >= m_maxM) {
+				delete[] secs;
+				throw std::invalid_argument("too many t-points");
+			}
+			secs[n++] = next;
+			t 				= next;
+
+			step *= a_tauGrowth;
+			if (a_capSec > 0)
+				step = std::min<double>(step, double(a_capSec));
+		}
+
+		m_M = n;
+		for (int j = 0; j < m_M; ++j) {
+			time_t tj = secs[m_M - 1 - j];
+			m_ts[j] 	= YearFrac(tj);
+
+			if (j < m_M - 1)
+				m_taus[j] = YearFracInt(secs[m_M - 2 - j] - tj);
+		}
+		delete[] secs;
+	}
+
+	//------------------------------------------------------------------------//
+	// "MkCurves" implementation:                                             //
+	//------------------------------------------------------------------------//
+	template                                                                      
+	<                                                                             
+		typename Diffusion1D, typename AProvider, typename BProvider,               
+		typename AssetClassA, typename AssetClassB                                  
+	>
+	void GridNOP1D_S3_RKC1<Diffusion1D, AProvider,
+															BProvider, AssetClassA, AssetClassB>::
+	MkCurves
+	(
+		Option<AssetClassA, AssetClassB> const* a_option,
+		Diffusion1D const* a_diff,
+		double a_S0
+	)
+	{
+		double integrAB = 0.0;
+		m_ES	[0]				= a_S0;
+		m_VarS[0] 			= 0;
+		m_DFA	[0]				= 1;
+		m_DFB	[0]				= 1;
+
+		for (int j = 0; j < m_M - 1; ++j) {
+			double t 	 = m_ts[j];
+			double tau = m_taus[j];
+
+			// Integrate E[S](t) and Var[S](t) curves:
+			// take rB(t) - rA(t) and cut the negative values to nake sure the grid 
+			// upper boundary is expanding with time:
+
+			double rA = m_irpA.r(a_option->m_assetA, t);
+			double rB = m_irpB.r(a_option->m_assetB, t);
+			double rateDiff = std::max<double>(rB - rA, 0.0);
+			
+			// integrated rates:
+			integrAB += rateDiff * tau;
+			m_DFA[j+1] = m_DFA[j] * exp(- rA * tau);
+			m_DFB[j+1] = m_DFB[j] * exp(- rB * tau);
+
+			// E[St]:
+			m_ES[j+1] = a_S0 * exp(integrAB); 
+		
+			// Var[St]:
+			double sigma = a_diff->sigma(m_ES[j], t);
+			m_VarS[j+1]  = m_VarS[j] + sigma * sigma * tau;
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// "MkDiffCoeffs" implementation:                                         //
+	//------------------------------------------------------------------------//
+	template                                                                      
+	<                                                                             
+		typename Diffusion1D, typename AProvider, typename BProvider,               
+		typename AssetClassA, typename AssetClassB                                  
+	>
+	inline void GridNOP1D_S3_RKC1<Diffusion1D, AProvider,
+															BProvider, AssetClassA, AssetClassB>::
+	MkDiffCoeffs(Diffusion1D const* a_diff, double a_t, double a_h) {
+		// (jumps would make it a PIDE, with an integral term on the S-grid):
+		static_assert(!HasJumps<Diffusion1D>::value,
+									"jump-diffusions are not supported by the 1D grid");
+
+		double D2 = 2 * a_h * a_h; // denum in the diffusive term
+
+		if constexpr (HasBatchCoeffs<Diffusion1D>::value) {
+			a_diff->sigma(m_S, a_t, m_diffC, m_N);
+			for (int i = 0; i < m_N; ++i)
+				m_diffC[i] = m_diffC[i] * m_diffC[i] / D2;
+		}
+		else
+			for (int i = 0; i < m_N; ++i) {
+				double sigma = a_diff->sigma(m_S[i], a_t);
+				m_diffC[i] = sigma * sigma / D2;
+			}
+	}
+
+	//------------------------------------------------------------------------//
+	// "MkSpline0" implementation:                                            //
+	//------------------------------------------------------------------------//
+	// Natural cubic spline on the uniform S-line: M[0] = M[N-1] = 0 and      //
+	// M[i-1] + 4 M[i] + M[i+1] = 6 (f[i+1] - 2 f[i] + f[i-1]) / h^2, solved  //
+	// by the Thomas algorithm:                                               //
+	//------------------------------------------------------------------------//
+	template                                                                      
+	<                                                                             
+		typename Diffusion1D, typename AProvider, typename BProvider,               
+		typename AssetClassA, typename AssetClassB                                  
+	>
+	void GridNOP1D_S3_RKC1<Diffusion1D, AProvider,
+															BProvider, AssetClassA, AssetClassB>::
+	MkSpline0() {
+		double const* f0 = m_grid; // j=0
+		double* 			M  = m_D2f0;
+		double* 			c  = m_diffC; // scratch: modified super-diag coeffs
+		double h  = m_S[1] - m_S[0];
+		double R  = 6 / (h * h);
+
+		M[0] = 0;
+		c[0] = 0;
+
+		// Forward sweep:
+		for (int i = 1; i <= m_N - 2; ++i) {
+			double den = 4 - c[i - 1];
+			c[i] = 1 / den;
+			M[i] = (R * (f0[i + 1] - 2 * f0[i] + f0[i - 1]) - M[i - 1]) / den;
+		}
+		M[m_N - 1] = 0;
+
+		// Back substitution:
+		for (int i = m_N - 3; i >= 1; --i)
+			M[i] -= c[i] * M[i + 1];
 	}
 
 	//------------------------------------------------------------------------//
@@ -244,18 +869,18 @@ namespace SiriusFM {
 															BProvider,  AssetClassA, AssetClassB>::
 	GetPxDeltaGamma0() const {
 
-		if (m_M == 0 || m_N == 0)
+		if (m_M == 0 || m_N == 0 || !m_hasGrid)
 			throw std::runtime_error("Run BI first");
 
 		assert(0 <= m_i0 && m_i0 < m_N);
 		
-		double h = m_S[1] = m_S[0];
+		double h = m_S[1] - m_S[0];
 		double px = m_grid[m_i0]; // j=0
 		double delta = 0;
 		double gamma = 0;
 
 		if (0 < m_i0 && m_i0 <= m_N - 2) {
-			delta = (m_grid[m_i0 + 1] - m_grid[m_i0 + 1]) / (2 * h);
+			delta = (m_grid[m_i0 + 1] - m_grid[m_i0 - 1]) / (2 * h);
 			gamma = (m_grid[m_i0 + 1] - 2 * m_grid[m_i0]
 																						+ m_grid[m_i0 - 1]) / (h * h);
 		}
@@ -263,10 +888,198 @@ namespace SiriusFM {
 			delta = (m_grid[1] - m_grid[0]) / h; // gamma remains 0
 		
 		else {
-			assert(m_i0 = m_N - 1);
+			assert(m_i0 == m_N - 1);
 			delta = (m_grid[m_N - 1] - m_grid[m_N - 2]) / h; // gamma remains 0
 		}
 
 		return std::make_tuple(px, delta, gamma);
 	}
+
+	//------------------------------------------------------------------------//
+	// GetPxDeltaGamma0 at arbitrary S implementation:                        //
+	//------------------------------------------------------------------------//
+	template                                                                      
+	<                                                                             
+		typename Diffusion1D, typename AProvider, typename BProvider,               
+		typename AssetClassA, typename AssetClassB                                  
+	>
+	std::tuple<double, double, double> GridNOP1D_S3_RKC1<Diffusion1D, AProvider,
+															BProvider,  AssetClassA, AssetClassB>::
+	GetPxDeltaGamma0(double a_S) const {
+		double px, delta, gamma;
+		GetPxDeltaGamma0(&a_S, 1, &px, &delta, &gamma);
+		return std::make_tuple(px, delta, gamma);
+	}
+
+	template                                                                      
+	<                                                                             
+		typename Diffusion1D, typename AProvider, typename BProvider,               
+		typename AssetClassA, typename AssetClassB                                  
+	>
+	void GridNOP1D_S3_RKC1<Diffusion1D, AProvider,
+															BProvider,  AssetClassA, AssetClassB>::
+	GetPxDeltaGamma0
+	(
+		double const* a_Ss,
+		int 					a_n,
+		double* 			a_pxs,
+		double* 			a_deltas,
+		double* 			a_gammas
+	) const
+	{
+		if (m_M == 0 || m_N == 0 || m_isFwd || !m_hasGrid)
+			throw std::runtime_error("Run BI first");
+
+		assert(a_Ss != nullptr && a_n >= 0);
+
+		double const* f0 = m_grid; // j=0
+		double const* M  = m_D2f0;
+		double h  = m_S[1] - m_S[0];
+		double B  = m_S[m_N - 1];
+
+		for (int k = 0; k < a_n; ++k) {
+			double S = a_Ss[k];
+
+			if (!(0 <= S && S <= B))
+				throw std::invalid_argument("S is out of the grid");
+
+			// S is in [S_m, S_{m+1}]:
+			int m = std::min<int>(int(S / h), m_N - 2);
+			double b = (S - m_S[m]) / h;
+			double a = 1 - b;
+
+			if (a_pxs != nullptr)
+				a_pxs[k] = a * f0[m] + b * f0[m + 1]
+						+ ((a * a * a - a) * M[m] + (b * b * b - b) * M[m + 1]) * h * h / 6;
+
+			if (a_deltas != nullptr)
+				a_deltas[k] = (f0[m + 1] - f0[m]) / h
+						- ((3 * a * a - 1) * M[m] - (3 * b * b - 1) * M[m + 1]) * h / 6;
+
+			if (a_gammas != nullptr)
+				a_gammas[k] = a * M[m] + b * M[m + 1];
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// "GetEurPxsFwd" implementation:                                         //
+	//------------------------------------------------------------------------//
+	template                                                                      
+	<                                                                             
+		typename Diffusion1D, typename AProvider, typename BProvider,               
+		typename AssetClassA, typename AssetClassB                                  
+	>
+	void GridNOP1D_S3_RKC1<Diffusion1D, AProvider,
+															BProvider, AssetClassA, AssetClassB>::
+	GetEurPxsFwd
+	(
+		double const* a_Ks,
+		int 					a_nK,
+		double* 			a_calls,
+		double* 			a_puts
+	) const
+	{
+		if (m_M == 0 || m_N == 0 || !m_isFwd || !m_hasGrid)
+			throw std::runtime_error("Run FI first");
+
+		double* P0 = new double[2 * m_N];
+
+		for (int j = 0; j < m_M; ++j)
+			EurPxsFwdLayer(j, a_Ks, a_nK,
+										 (a_calls != nullptr) ? a_calls + j * a_nK : nullptr,
+										 (a_puts  != nullptr) ? a_puts  + j * a_nK : nullptr, P0);
+		delete[] P0;
+	}
+
+	template                                                                      
+	<                                                                             
+		typename Diffusion1D, typename AProvider, typename BProvider,               
+		typename AssetClassA, typename AssetClassB                                  
+	>
+	void GridNOP1D_S3_RKC1<Diffusion1D, AProvider,
+															BProvider, AssetClassA, AssetClassB>::
+	GetEurPxsFwd
+	(
+		int 					a_j,
+		double const* a_Ks,
+		int 					a_nK,
+		double* 			a_calls,
+		double* 			a_puts
+	) const
+	{
+		if (m_M == 0 || m_N == 0 || !m_isFwd || !m_hasGrid)
+			throw std::runtime_error("Run FI first");
+
+		if (a_j < 0 || a_j >= m_M)
+			throw std::invalid_argument("t-index out of range");
+
+		double* P0 = new double[2 * m_N];
+		EurPxsFwdLayer(a_j, a_Ks, a_nK, a_calls, a_puts, P0);
+		delete[] P0;
+	}
+
+	//------------------------------------------------------------------------//
+	// "EurPxsFwdLayer" implementation:                                       //
+	//------------------------------------------------------------------------//
+	// The density f(S) is linear between the S-nodes, so the integrals of    //
+	// f(S) and S f(S) over each S-interval are exact. Their prefix sums give //
+	// Put(K) = Int_0^K (K - S) f(S) dS in O(1) for any K: K P0[m] - P1[m]    //
+	// plus the partial interval [S_m, K]. Calls are obtained from the        //
+	// Call-Put parity with the exact forward, as the density mass beyond the //
+	// upper bound (absorbed there by the Fwd run) only affects Calls:        //
+	//------------------------------------------------------------------------//
+	template                                                                      
+	<                                                                             
+		typename Diffusion1D, typename AProvider, typename BProvider,               
+		typename AssetClassA, typename AssetClassB                                  
+	>
+	void GridNOP1D_S3_RKC1<Diffusion1D, AProvider,
+															BProvider, AssetClassA, AssetClassB>::
+	EurPxsFwdLayer
+	(
+		int 					a_j,
+		double const* a_Ks,
+		int 					a_nK,
+		double* 			a_calls,
+		double* 			a_puts,
+		double* 			a_P0
+	) const
+	{
+		assert(a_Ks != nullptr && a_nK > 0 && a_P0 != nullptr);
+
+		double h  = m_S[1] - m_S[0];
+		double S0 = m_S[m_i0];
+		double* P0 = a_P0; 					// prefix sums of Int f(S) dS
+		double* P1 = a_P0 + m_N; 		// prefix sums of Int S f(S) dS
+		double const* fj = m_grid + a_j * m_N;
+
+		P0[0] = 0;
+		P1[0] = 0;
+
+		for (int i = 1; i < m_N; ++i) {
+			P0[i] = P0[i - 1] + h * (fj[i - 1] + fj[i]) / 2;
+			P1[i] = P1[i - 1] + h * (m_S[i - 1] * (fj[i - 1] + fj[i]) / 2
+														 + h * (fj[i - 1] + 2 * fj[i]) / 6);
+		}
+
+		for (int k = 0; k < a_nK; ++k) {
+			double K = a_Ks[k];
+			assert(K > 0);
+
+			int m = std::min<int>(int(K / h), m_N - 1); // K is in [S_m, S_{m+1})
+			double put = K * P0[m] - P1[m];
+
+			if (m < m_N - 1) {
+				double uK = (K - m_S[m]) / h;
+				put += h * h * uK * uK * (fj[m] / 2 + (fj[m + 1] - fj[m]) * uK / 6);
+			}
+			put *= m_DFB[a_j];
+
+			if (a_puts != nullptr)
+				a_puts [k] = put;
+
+			if (a_calls != nullptr)
+				a_calls[k] = put + S0 * m_DFA[a_j] - K * m_DFB[a_j];
+		}
+	}
 }
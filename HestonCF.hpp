@@ -0,0 +1,171 @@
+//==========================================================================//
+//                                "HestonCF.hpp"                            //
+// Semi-analytic Heston prices of European options from the characteristic  //
+// function (Lewis' single-integral formula)                                //
+//--------------------------------------------------------------------------//
+//   C = S0 e^{-rA T} - sqrt(S0 K) e^{-(rA + rB) T / 2} / Pi *              //
+//       Int_0^Inf Re[e^{i u k} phi(u - i/2)] / (u^2 + 1/4) du,             //
+//   k = log(S0 / K) + (rB - rA) T,                                         //
+// phi being the CF of log(S_T / S0) - (rB - rA) T ("little trap" form, so  //
+// the complex log needs no branch tracking). The integrand, but for the    //
+// e^{i u k} factor, does not depend on K, so all the strikes of an expiry  //
+// are priced by one quadrature. Puts are by the Call-Put parity. Used for  //
+// calibration and as the control variate of MC pricing                     //
+//==========================================================================//
+
+#pragma once
+
+#include "DiffusionHeston.h"
+
+#include <complex>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// "HestonCF": E[exp(i u X_T)], X_T = log(S_T / S0) - drift * T:          //
+	//------------------------------------------------------------------------//
+	inline std::complex<double> HestonCF
+	(
+		std::complex<double> 		a_u,
+		double 									a_TTE,
+		DiffusionHeston const& 	a_diff
+	)
+	{
+		using C = std::complex<double>;
+		C const I(0.0, 1.0);
+
+		double kappa = a_diff.GetKappa();
+		double theta = a_diff.GetTheta();
+		double xi 	 = a_diff.GetXi();
+		double rho 	 = a_diff.GetRho();
+		double x2 	 = xi * xi;
+
+		C b 	= kappa - rho * xi * I * a_u;
+		C d 	= sqrt(b * b + x2 * (I * a_u + a_u * a_u));
+		C g 	= (b - d) / (b + d);
+		C e 	= exp(-d * a_TTE);
+		C A 	= kappa * theta / x2 *
+						((b - d) * a_TTE - 2.0 * log((1.0 - g * e) / (1.0 - g)));
+		C B 	= (b - d) / x2 * (1.0 - e) / (1.0 - g * e);
+		return exp(A + B * a_diff.GetV0());
+	}
+
+	//------------------------------------------------------------------------//
+	// "HestonPxBatch": prices of "a_n" Calls/Puts of the same expiry:        //
+	//------------------------------------------------------------------------//
+	inline void HestonPxBatch
+	(
+		DiffusionHeston const& a_diff,
+		int 									 a_n,
+		bool const* 					 a_isCall,
+		double const* 				 a_Ks,
+		double 								 a_S0,
+		double 								 a_TTE,
+		double 								 a_rateA,
+		double 								 a_rateB,
+		double* 							 a_pxs
+	)
+	{
+		assert(a_n >= 0 && a_S0 > 0 && a_isCall != nullptr && a_Ks != nullptr &&
+					 a_pxs != nullptr);
+
+		if (a_TTE <= 0) {
+			for (int j = 0; j < a_n; ++j)
+				a_pxs[j] = a_isCall[j] ? std::max<double>(a_S0 - a_Ks[j], 0.0)
+															 : std::max<double>(a_Ks[j] - a_S0, 0.0);
+			return;
+		}
+
+		// 16-point Gauss-Legendre (positive nodes and their weights):
+		constexpr int 	 NGL = 8;
+		constexpr double GLx[NGL] =
+		{
+			0.095012509837637441, 0.28160355077925892, 0.45801677765722737,
+			0.61787624440264377, 	0.755404408355003, 	 0.86563120238783176,
+			0.9445750230732326, 	0.98940093499164994
+		};
+		constexpr double GLw[NGL] =
+		{
+			0.18945061045506847, 	0.18260341504492361, 0.16915651939500256,
+			0.14959598881657682, 	0.12462897125553395, 0.095158511682492897,
+			0.062253523938647776, 0.027152459411754058
+		};
+		// Truncation: the envelope of the integrand relative to its value at 0:
+		constexpr double Eps 			 = 1e-14;
+		constexpr int 	 MaxPanels = 4000;
+
+		double 	drift = (a_rateB - a_rateA) * a_TTE;
+		double 	kMax  = 0;
+		double* ks 		= new double[a_n];
+		for (int j = 0; j < a_n; ++j) {
+			assert(a_Ks[j] > 0);
+			ks[j] = log(a_S0 / a_Ks[j]) + drift;
+			kMax 	= std::max<double>(kMax, fabs(ks[j]));
+		}
+
+		// Panel widths: near 0, limited by the poles of 1 / (u^2 + 1/4) at
+		// +-i/2 (so the panels grow geometrically from 1/2), and everywhere by
+		// the decay (the log-spot StD "s") and the oscillation of e^{i u k}:
+		double vMax = std::max<double>(a_diff.GetV0(), a_diff.GetTheta());
+		double s 		= sqrt(std::max<double>(vMax * a_TTE, 1e-8));
+		double WMax = std::min<double>(1.0 / s,
+																	 M_PI / std::max<double>(kMax, 1e-3));
+
+		for (int j = 0; j < a_n; ++j)
+			a_pxs[j] = 0;
+
+		std::complex<double> const Ih(0.0, 0.5);
+		double a = 0; // panel start
+		for (int k = 0; k < MaxPanels; ++k) {
+			double W 	 = std::min<double>(std::max<double>(a, 0.5), WMax);
+			double c 	 = a + 0.5 * W;
+			double env = 0;
+			a += W;
+			for (int i = 0; i < 2 * NGL; ++i) {
+				double x 	= (i < NGL) ? -GLx[i] : GLx[i - NGL];
+				double w 	= GLw[i < NGL ? i : i - NGL] * 0.5 * W;
+				double u 	= c + 0.5 * W * x;
+				auto 	 ph = HestonCF(u - Ih, a_TTE, a_diff) / (u * u + 0.25);
+				env 			= std::max<double>(env, std::abs(ph));
+				for (int j = 0; j < a_n; ++j)
+					a_pxs[j] += w * (ph.real() * cos(u * ks[j]) -
+													 ph.imag() * sin(u * ks[j]));
+			}
+			if (env < Eps * 4.0) // the integrand at 0 is ~ 4
+				break;
+		}
+		delete[] ks;
+
+		double dfA = exp(-a_rateA * a_TTE);
+		double dfB = exp(-a_rateB * a_TTE);
+		for (int j = 0; j < a_n; ++j) {
+			double K 	= a_Ks[j];
+			double C 	= a_S0 * dfA - sqrt(a_S0 * K * dfA * dfB) / M_PI * a_pxs[j];
+			C 				= std::max<double>(C, std::max<double>(a_S0 * dfA - K * dfB, 0.0));
+			a_pxs[j] 	= a_isCall[j] ? C : C - a_S0 * dfA + K * dfB;
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// "HestonPx": single option:                                             //
+	//------------------------------------------------------------------------//
+	inline double HestonPx
+	(
+		DiffusionHeston const& a_diff,
+		bool 									 a_isCall,
+		double 								 a_K,
+		double 								 a_S0,
+		double 								 a_TTE,
+		double 								 a_rateA,
+		double 								 a_rateB
+	)
+	{
+		double px = 0;
+		HestonPxBatch(a_diff, 1, &a_isCall, &a_K, a_S0, a_TTE, a_rateA, a_rateB,
+									&px);
+		return px;
+	}
+}
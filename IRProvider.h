@@ -1,7 +1,7 @@
 //==========================================================================//
 //                               "IRProvider.h"                             //
-// Fully generic IRProvider parameterized by mode (only "Const" mode is     //
-// implemented)                                                             //
+// Fully generic IRProvider parameterized by mode ("Const", "FwdCurve" and  //
+// "Mapped" modes are implemented)                                          //
 // -------------------------------------------------------------------------//
 // Modes and Ccy types are implemented as enumerators                       //
 //==========================================================================//
@@ -10,6 +10,7 @@
 
 #include <stdexcept>
 #include <cstring>
+#include <cstdint>
 
 namespace SiriusFM {
 	enum class CcyE {
@@ -23,10 +24,52 @@ namespace SiriusFM {
 		N = 6
 	};
 
+	//------------------------------------------------------------------------//
+	// Open-ended Ccy IDs: the code (up to 4 chars of [A-Z0-9]) packed into   //
+	// uint32_t, so any ccy can be used without extending "CcyE":             //
+	//------------------------------------------------------------------------//
+	enum class CcyID : uint32_t {
+		UNDEFINED = 0
+	};
+
+	constexpr CcyID MkCcyID(char const* a_code) {
+		uint32_t id = 0;
+		for (int i = 0; i < 4 && a_code[i] != '\0'; ++i) {
+			char c = a_code[i];
+			if (!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')))
+				throw std::invalid_argument("invalid ccy code");
+			id |= uint32_t(uint8_t(c)) << (8 * i);
+		}
+		return CcyID(id);
+	}
+
+	// "a_buf" must hold at least 5 chars:
+	inline char const* CcyID2Str(CcyID a_ccy, char* a_buf) {
+		uint32_t id = uint32_t(a_ccy);
+		int i = 0;
+		for (; i < 4 && (id >> (8 * i)) != 0; ++i)
+			a_buf[i] = char((id >> (8 * i)) & 0xFF);
+		a_buf[i] = '\0';
+		return a_buf;
+	}
+
+	constexpr CcyID ToCcyID(CcyE a_ccy) {
+		switch (a_ccy) {
+			case CcyE::USD: 	return MkCcyID("USD");
+			case CcyE::EUR: 	return MkCcyID("EUR");
+			case CcyE::GBP: 	return MkCcyID("GBP");
+			case CcyE::CHF: 	return MkCcyID("CHF");
+			case CcyE::RUB: 	return MkCcyID("RUB");
+			case CcyE::ZERO: 	return MkCcyID("ZERO");
+			default: 					return CcyID::UNDEFINED;
+		}
+	}
+
 	enum class IRModeE {
 		Const = 0,
 		FwdCurve = 1,
-		Stoch = 2
+		Stoch = 2, 	// short rate of ccy B simulated by "MCEngine2F"
+		Mapped = 3 	// FwdCurves from a memory-mapped binary snapshot
 	};
 	
 	template<IRModeE IRM>
@@ -0,0 +1,182 @@
+//==========================================================================//
+//                           "IRProviderFwdCurve.cpp"                       //
+// We read the zero-rate curves from a file and build the bucketed fwds     //
+//==========================================================================//
+
+#include "IRProviderFwdCurve.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace SiriusFM {
+
+	IRProvider<IRModeE::FwdCurve>::IRProvider(const char* a_file)
+	: m_t0(0),
+		m_nB(1)
+	{
+	constexpr int BUF_SIZE 		= 64;
+	constexpr int CCY_SIZE 		= 3;
+	constexpr int MAX_TENORS 	= 128; // per ccy
+
+		// Tenors (in years) and zero rates from the file, per ccy:
+		double Ts[int(CcyE::N)][MAX_TENORS];
+		double Rs[int(CcyE::N)][MAX_TENORS];
+		int 	 nTs[int(CcyE::N)];
+		bool 	 hasBase = false;
+
+		for (int c = 0; c < int(CcyE::N); ++c) {
+			nTs[c] 		= 0;
+			m_fwds[c] = nullptr;
+			m_ints[c] = nullptr;
+		}
+
+		if (a_file != nullptr && *a_file != '\0') {
+			FILE* src = fopen(a_file, "r");
+
+			if (src == nullptr)
+				throw std::runtime_error("Cannot open file");
+
+			char buf[BUF_SIZE];
+			char ccy[CCY_SIZE + 1] = "XXX";
+
+			while (fgets(buf, BUF_SIZE, src) != nullptr) {
+				if (*buf == '\0' || *buf == '\n' || *buf == '#')
+					continue;
+
+				if (strncmp(buf, "BASE", 4) == 0) {
+					int y = 0, m = 0, d = 0;
+
+					if (sscanf(buf + 4, "%d-%d-%d", &y, &m, &d) != 3) {
+						fclose(src);
+						throw std::invalid_argument("invalid BASE date");
+					}
+					m_t0 		= YearFrac(MkDate(y, m, d));
+					hasBase = true;
+					continue;
+				}
+
+				strncpy(ccy, buf, CCY_SIZE);
+				int c = int(Str2CcyE(ccy));
+
+				int 	 n 	 = 0;
+				char 	 unit = '\0';
+				double rate = 0;
+
+				if (sscanf(buf + CCY_SIZE, "%d%c %lf", &n, &unit, &rate) != 3 ||
+						n <= 0 || nTs[c] >= MAX_TENORS)
+				{
+					fclose(src);
+					throw std::invalid_argument("invalid tenor line");
+				}
+
+				double T = TenorYears(n, unit);
+				if (T <= 0) {
+					fclose(src);
+					throw std::invalid_argument("invalid tenor unit");
+				}
+
+				// Insert in ascending order of tenors:
+				int i = nTs[c]++;
+				for (; i > 0 && Ts[c][i - 1] > T; --i) {
+					Ts[c][i] = Ts[c][i - 1];
+					Rs[c][i] = Rs[c][i - 1];
+				}
+				Ts[c][i] = T;
+				Rs[c][i] = rate;
+			}
+			fclose(src);
+
+			bool hasTenors = false;
+			for (int c = 0; c < int(CcyE::N); ++c)
+				hasTenors |= (nTs[c] > 0);
+
+			if (hasTenors && !hasBase)
+				throw std::invalid_argument("no BASE date in the curve file");
+		}
+
+		// The buckets cover all the tenors (beyond them the fwds are flat):
+		double maxT = 0;
+		for (int c = 0; c < int(CcyE::N); ++c)
+			if (nTs[c] > 0)
+				maxT = std::max<double>(maxT, Ts[c][nTs[c] - 1]);
+
+		m_nB = int(ceil(maxT / DT)) + 1;
+
+		// A ccy not in the file has zero rates:
+		for (int c = 0; c < int(CcyE::N); ++c) {
+			m_fwds[c] = new double[m_nB];
+			m_ints[c] = new double[m_nB];
+			MkBucketedCurve(Ts[c], Rs[c], nTs[c], DT, m_nB, m_fwds[c], m_ints[c]);
+		}
+	}
+
+	IRProvider<IRModeE::FwdCurve>::~IRProvider() {
+		for (int c = 0; c < int(CcyE::N); ++c) {
+			delete[] m_fwds[c];
+			delete[] m_ints[c];
+			m_fwds[c] = nullptr;
+			m_ints[c] = nullptr;
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// "TenorYears":                                                          //
+	//------------------------------------------------------------------------//
+	double TenorYears(int a_n, char a_unit) {
+		switch (a_unit) {
+			case 'D': return double(a_n) / AVG_DAYS_IN_YEAR;
+			case 'W': return double(7 * a_n) / AVG_DAYS_IN_YEAR;
+			case 'M': return double(a_n) / 12.0;
+			case 'Y': return double(a_n);
+			default: 	return 0;
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// "MkBucketedCurve":                                                     //
+	//------------------------------------------------------------------------//
+	// Z(tau) = Int_0^tau fwd = tau R(tau) is piece-wise linear between the   //
+	// tenors (as the fwd is piece-wise const); the bucket fwd is the average //
+	// of the fwd over the bucket, so the integrals are exact at the bucket   //
+	// ends:                                                                  //
+	//------------------------------------------------------------------------//
+	void MkBucketedCurve
+	(
+		double const* a_Ts,
+		double const* a_Rs,
+		int 					a_nT,
+		double 				a_dt,
+		int 					a_nB,
+		double* 			a_fwds,
+		double* 			a_ints
+	) {
+		double const* T = a_Ts;
+		double const* R = a_Rs;
+		int 					nT = a_nT;
+
+		auto Z = [T, R, nT](double a_tau) {
+			if (nT == 0)
+				return 0.0;
+			if (a_tau <= T[0])
+				return R[0] * a_tau;
+
+			int i = 1;
+			while (i < nT && T[i] < a_tau)
+				++i;
+
+			// Fwd in (T[i-1], T[i]] (the last one extrapolated flat):
+			int 	 j 	 = std::min<int>(i, nT - 1);
+			double fwd = (j == 0) ? R[0] :
+									 (R[j] * T[j] - R[j - 1] * T[j - 1]) / (T[j] - T[j - 1]);
+			return R[i - 1] * T[i - 1] + fwd * (a_tau - T[i - 1]);
+		};
+
+		double Z0 = 0;
+		for (int k = 0; k < a_nB; ++k) {
+			double Z1 	= Z(double(k + 1) * a_dt);
+			a_ints[k] 	= Z0;
+			a_fwds[k] 	= (Z1 - Z0) / a_dt;
+			Z0 					= Z1;
+		}
+	}
+}
@@ -0,0 +1,91 @@
+//==========================================================================//
+//                           "IRProviderFwdCurve.h"                         //
+// Implementation of IRProvider class in "FwdCurve" mode                    //
+//--------------------------------------------------------------------------//
+// The file contains the curve base date and zero rates (continuously-      //
+// compounded) at tenors, per ccy:                                          //
+//   BASE 2024-01-15                                                        //
+//   USD 1M 0.0531                                                          //
+//   USD 1Y 0.0480 ...                                                      //
+// (tenors in D, W, M or Y). The instantaneous fwd rate is piece-wise const //
+// between the tenors and flat outside of them. It is sampled on a uniform  //
+// grid of "DT" buckets in YearFrac, together with its integral from the    //
+// base date, so "r" and "DF" are O(1) lookups (no search)                  //
+//==========================================================================//
+
+#pragma once
+
+#include "IRProvider.h"
+#include "Time.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace SiriusFM {
+	template<>
+	class IRProvider<IRModeE::FwdCurve> {
+		private:
+			// Bucket size (1 day in years):
+			static constexpr double DT = 1.0 / AVG_DAYS_IN_YEAR;
+
+			double 	m_t0; 								// base date (YearFrac)
+			int 		m_nB; 								// # of buckets
+			double* m_fwds[int(CcyE::N)]; // [m_nB]: fwd rate in each bucket
+			double* m_ints[int(CcyE::N)]; // [m_nB]: Int_{t0}^{bucket start} fwd
+
+			// Bucket index of "a_t" (YearFrac), clamped to [0, m_nB-1]: the rate is
+			// extrapolated flat beyond the ends:
+			int Bucket(double a_t) const {
+				double u = (a_t - m_t0) * (1.0 / DT);
+				u = std::min<double>(std::max<double>(u, 0.0), double(m_nB - 1));
+				return int(u);
+			}
+
+			// Int_{t0}^{t} fwd (may be negative for t < t0):
+			double Int(CcyE a_ccy, double a_t) const {
+				int k = Bucket(a_t);
+				return m_ints[int(a_ccy)][k] +
+							 (a_t - (m_t0 + double(k) * DT)) * m_fwds[int(a_ccy)][k];
+			}
+
+		public:
+			IRProvider(char const* a_file);
+			~IRProvider();
+
+			IRProvider(IRProvider const&) = delete;
+			IRProvider& operator=(IRProvider const&) = delete;
+
+			// Instantaneous continiously-compound IR:
+			double r(CcyE a_ccy, double a_t) const {
+				return m_fwds[int(a_ccy)][Bucket(a_t)];
+			}
+
+		// Discount Factor:
+		double DF(CcyE a_ccy, time_t a_t0, time_t a_t1) const {
+			return exp(- (Int(a_ccy, YearFrac(a_t1)) - Int(a_ccy, YearFrac(a_t0))));
+		}
+	};
+
+	// Alias:
+	using IRPFwdCurve = IRProvider<IRModeE::FwdCurve>;
+
+	//------------------------------------------------------------------------//
+	// Curve building blocks (also used by the "MkCurveStore" converter):     //
+	//------------------------------------------------------------------------//
+	// Tenor "a_n" of "a_unit" (D, W, M, Y) in years (0 if the unit is bad):
+	double TenorYears(int a_n, char a_unit);
+
+	// Samples the fwd curve given by zero rates "a_Rs" at ascending tenors
+	// "a_Ts" on "a_nB" buckets of "a_dt" years: the average fwd in each bucket
+	// and its integral up to the bucket start (zero curve if "a_nT" == 0):
+	void MkBucketedCurve
+	(
+		double const* a_Ts,
+		double const* a_Rs,
+		int 					a_nT,
+		double 				a_dt,
+		int 					a_nB,
+		double* 			a_fwds,
+		double* 			a_ints
+	);
+}
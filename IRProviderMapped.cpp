@@ -0,0 +1,94 @@
+//==========================================================================//
+//                            "IRProviderMapped.cpp"                        //
+// We map a binary CurveStore snapshot into memory and validate it          //
+//==========================================================================//
+
+#include "IRProviderMapped.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace SiriusFM {
+
+	IRProvider<IRModeE::Mapped>::IRProvider(const char* a_file)
+	: m_map 	(nullptr),
+		m_size 	(0),
+		m_slots (nullptr),
+		m_nSlots(0),
+		m_curves(nullptr),
+		m_nB 		(1),
+		m_t0 		(0),
+		m_dt 		(1)
+	{
+		if (a_file == nullptr || *a_file == '\0') // all rates are zero
+			return;
+
+		int fd = open(a_file, O_RDONLY);
+		if (fd < 0)
+			throw std::runtime_error("Cannot open file");
+
+		struct stat st;
+		if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(CurveStoreHdr)) {
+			close(fd);
+			throw std::runtime_error("Invalid CurveStore file");
+		}
+		m_size = size_t(st.st_size);
+		m_map  = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd); 	// the mapping stays valid
+
+		if (m_map == MAP_FAILED) {
+			m_map = nullptr;
+			throw std::runtime_error("Cannot mmap file");
+		}
+
+		CurveStoreHdr const* hdr = static_cast<CurveStoreHdr const*>(m_map);
+		size_t expSize = sizeof(CurveStoreHdr)
+									 + size_t(hdr->m_nSlots) * sizeof(CurveStoreSlot)
+									 + size_t(hdr->m_nCcys) * 2 * hdr->m_nB * sizeof(double);
+
+		if (memcmp(hdr->m_magic, CurveStoreMagic, sizeof(CurveStoreMagic)) != 0
+				|| hdr->m_nB == 0 || !(hdr->m_dt > 0)
+				|| hdr->m_nSlots < 2 * hdr->m_nCcys
+				|| (hdr->m_nSlots & (hdr->m_nSlots - 1)) != 0
+				|| expSize != m_size)
+		{
+			munmap(const_cast<void*>(m_map), m_size);
+			m_map = nullptr;
+			throw std::runtime_error("Invalid CurveStore file");
+		}
+
+		m_slots  = reinterpret_cast<CurveStoreSlot const*>(hdr + 1);
+		m_nSlots = hdr->m_nSlots;
+		m_curves = reinterpret_cast<double const*>(m_slots + m_nSlots);
+		m_nB 		 = int(hdr->m_nB);
+		m_t0 		 = hdr->m_t0;
+		m_dt 		 = hdr->m_dt;
+
+		// Every used slot must index a curve of the file, and at least one
+		// slot must be empty (it ends the probing for a missing ccy):
+		uint32_t nEmpty = 0;
+		bool 		 okIdx 	= true;
+		for (uint32_t s = 0; s < m_nSlots; ++s) {
+			if (m_slots[s].m_id == uint32_t(CcyID::UNDEFINED))
+				++nEmpty;
+			else if (m_slots[s].m_idx >= hdr->m_nCcys)
+				okIdx = false;
+		}
+		if (!okIdx || (m_nSlots > 0 && nEmpty == 0)) {
+			munmap(const_cast<void*>(m_map), m_size);
+			m_map = nullptr;
+			throw std::runtime_error("Invalid CurveStore file");
+		}
+
+		// The curves are small and used right away:
+		madvise(const_cast<void*>(m_map), m_size, MADV_WILLNEED);
+	}
+
+	IRProvider<IRModeE::Mapped>::~IRProvider() {
+		if (m_map != nullptr)
+			munmap(const_cast<void*>(m_map), m_size);
+		m_map = nullptr;
+	}
+}
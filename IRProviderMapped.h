@@ -0,0 +1,93 @@
+//==========================================================================//
+//                            "IRProviderMapped.h"                          //
+// Implementation of IRProvider class in "Mapped" mode                      //
+//--------------------------------------------------------------------------//
+// The FwdCurves are read from a binary "CurveStore" snapshot which is      //
+// memory-mapped read-only, so the construction is O(1) and all providers   //
+// using the same file share the same physical pages. Ccys are open-ended   //
+// (CcyID); CcyE is also accepted. A ccy not in the snapshot has zero rates //
+//==========================================================================//
+
+#pragma once
+
+#include "IRProvider.h"
+#include "CurveStore.h"
+#include "Time.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace SiriusFM {
+	template<>
+	class IRProvider<IRModeE::Mapped> {
+		private:
+			void const* 					m_map;
+			size_t 								m_size;
+			CurveStoreSlot const* m_slots;
+			uint32_t 							m_nSlots;
+			double const* 				m_curves;
+			int 									m_nB;
+			double 								m_t0;
+			double 								m_dt;
+
+			// The curve (fwds, followed by ints) of "a_ccy", or NULL (the
+			// probing ends at an empty slot, which the ctor has checked there
+			// is, but is bounded by "m_nSlots" anyway):
+			double const* Curve(CcyID a_ccy) const {
+				if (m_nSlots == 0)
+					return nullptr;
+
+				uint32_t s = CurveStoreHash(a_ccy, m_nSlots);
+				for (uint32_t n = 0; n < m_nSlots; ++n, s = (s + 1) & (m_nSlots - 1))
+				{
+					if (m_slots[s].m_id == uint32_t(a_ccy))
+						return m_curves + 2 * size_t(m_nB) * m_slots[s].m_idx;
+					if (m_slots[s].m_id == uint32_t(CcyID::UNDEFINED))
+						return nullptr;
+				}
+				return nullptr;
+			}
+
+			int Bucket(double a_t) const {
+				double u = (a_t - m_t0) / m_dt;
+				u = std::min<double>(std::max<double>(u, 0.0), double(m_nB - 1));
+				return int(u);
+			}
+
+			double Int(double const* a_curve, double a_t) const {
+				int k = Bucket(a_t);
+				return a_curve[m_nB + k] + (a_t - (m_t0 + double(k) * m_dt)) * a_curve[k];
+			}
+
+		public:
+			IRProvider(char const* a_file);
+			~IRProvider();
+
+			IRProvider(IRProvider const&) = delete;
+			IRProvider& operator=(IRProvider const&) = delete;
+
+			// Instantaneous continiously-compound IR:
+			double r(CcyID a_ccy, double a_t) const {
+				double const* c = Curve(a_ccy);
+				return (c == nullptr) ? 0.0 : c[Bucket(a_t)];
+			}
+
+			double r(CcyE a_ccy, double a_t) const {
+				return r(ToCcyID(a_ccy), a_t);
+			}
+
+		// Discount Factor:
+		double DF(CcyID a_ccy, time_t a_t0, time_t a_t1) const {
+			double const* c = Curve(a_ccy);
+			return (c == nullptr) ? 1.0
+						 : exp(- (Int(c, YearFrac(a_t1)) - Int(c, YearFrac(a_t0))));
+		}
+
+		double DF(CcyE a_ccy, time_t a_t0, time_t a_t1) const {
+			return DF(ToCcyID(a_ccy), a_t0, a_t1);
+		}
+	};
+
+	// Alias:
+	using IRPMapped = IRProvider<IRModeE::Mapped>;
+}
@@ -0,0 +1,146 @@
+//==========================================================================//
+//                                  "Instr.h"                               //
+// Compile-time switchable instrumentation of the hot paths: per-phase      //
+// timers (by the CPU time-stamp counter) and work counters                 //
+//--------------------------------------------------------------------------//
+// Enabled by -DSIRIUSFM_INSTR (see the Makefile); otherwise the SFM_INSTR  //
+// and SFM_LAP macros expand to nothing, so there is no cost at all. The    //
+// stats are accumulated per thread in "g_instr" (no atomics needed) and    //
+// are queried / cleared by "GetInstrStats" / "ResetInstrStats". A phase is //
+// timed by "laps": SFM_LAP(tc, ph) adds the ticks since "tc" to phase "ph" //
+// and restarts "tc", so consecutive phases need one TSC read each          //
+//==========================================================================//
+
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#	include <x86intrin.h>
+#endif
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// Timed phases:                                                          //
+	//------------------------------------------------------------------------//
+	enum class PhaseE: int {
+		RNG 				= 0, 	// MC: normals
+		Coeffs 			= 1, 	// MC: mu and sigma; Grid: the diffusive coeffs
+		Step 				= 2, 	// MC: the Euler / QE step and jumps; Grid: the stencil
+		Store 			= 3, 	// MC: writing out path points
+		Eval 				= 4, 	// MC: the "PathEvaluator" callback
+		N 					= 5
+	};
+
+	constexpr char const* PhaseNames[int(PhaseE::N)] =
+		{"RNG", "Coeffs", "Step", "Store", "Eval"};
+
+	//------------------------------------------------------------------------//
+	// "InstrStats":                                                          //
+	//------------------------------------------------------------------------//
+	struct InstrStats {
+		uint64_t m_ticks[int(PhaseE::N)]; // TSC ticks per phase
+		uint64_t m_paths; 			// MC paths generated (incl antithetic)
+		uint64_t m_steps; 			// MC path steps
+		uint64_t m_batches; 		// MC path blocks stepped together
+		uint64_t m_bytes; 			// path points written, bytes
+		uint64_t m_evalCalls; 	// "PathEvaluator" calls
+		uint64_t m_payoffs; 		// payoffs evaluated by the evaluators
+		uint64_t m_deltaCalls; 	// delta function calls by "OHPathEval"
+		uint64_t m_gridNodes; 	// grid node updates
+		uint64_t m_gridLayers; 	// grid t-layers
+	};
+
+	inline thread_local InstrStats g_instr = {};
+
+	inline InstrStats const& GetInstrStats() {
+		return g_instr;
+	}
+
+	inline void ResetInstrStats() {
+		g_instr = InstrStats{};
+	}
+
+	// Adds "a_from" to "a_to" (eg the stats of worker threads to those of the
+	// thread which has started them):
+	inline void AddInstrStats(InstrStats& a_to, InstrStats const& a_from) {
+		for (int ph = 0; ph < int(PhaseE::N); ++ph)
+			a_to.m_ticks[ph] += a_from.m_ticks[ph];
+		a_to.m_paths 			+= a_from.m_paths;
+		a_to.m_steps 			+= a_from.m_steps;
+		a_to.m_batches 		+= a_from.m_batches;
+		a_to.m_bytes 			+= a_from.m_bytes;
+		a_to.m_evalCalls 	+= a_from.m_evalCalls;
+		a_to.m_payoffs 		+= a_from.m_payoffs;
+		a_to.m_deltaCalls += a_from.m_deltaCalls;
+		a_to.m_gridNodes 	+= a_from.m_gridNodes;
+		a_to.m_gridLayers += a_from.m_gridLayers;
+	}
+
+	//------------------------------------------------------------------------//
+	// "ReadTSC":                                                             //
+	//------------------------------------------------------------------------//
+	inline uint64_t ReadTSC() {
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>
+			(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+	}
+
+	//------------------------------------------------------------------------//
+	// "TSCPerSec": the TSC rate, measured once against "steady_clock" over   //
+	// ~20 ms (so call it outside of the timed code):                         //
+	//------------------------------------------------------------------------//
+	inline double TSCPerSec() {
+		static double const rate = []() {
+			using Clock = std::chrono::steady_clock;
+			auto 		 t0 = Clock::now();
+			uint64_t c0 = ReadTSC();
+			while (Clock::now() - t0 < std::chrono::milliseconds(20)) {}
+			uint64_t c1 = ReadTSC();
+			return double(c1 - c0) /
+						 std::chrono::duration<double>(Clock::now() - t0).count();
+		}();
+		return rate;
+	}
+
+	//------------------------------------------------------------------------//
+	// "PrintInstrStats":                                                     //
+	//------------------------------------------------------------------------//
+	inline void PrintInstrStats(std::ostream& a_os, InstrStats const& a_st) {
+		double rate = TSCPerSec();
+		for (int ph = 0; ph < int(PhaseE::N); ++ph)
+			a_os << PhaseNames[ph] << ": " << double(a_st.m_ticks[ph]) / rate
+					 << " s\n";
+		a_os << "paths: " 			<< a_st.m_paths 			<< "\n"
+				 << "steps: " 			<< a_st.m_steps 			<< "\n"
+				 << "batches: " 		<< a_st.m_batches 		<< "\n"
+				 << "bytes: " 			<< a_st.m_bytes 			<< "\n"
+				 << "evalCalls: " 	<< a_st.m_evalCalls 	<< "\n"
+				 << "payoffs: " 		<< a_st.m_payoffs 		<< "\n"
+				 << "deltaCalls: " 	<< a_st.m_deltaCalls 	<< "\n"
+				 << "gridNodes: " 	<< a_st.m_gridNodes 	<< "\n"
+				 << "gridLayers: " 	<< a_st.m_gridLayers 	<< "\n";
+	}
+}
+
+//--------------------------------------------------------------------------//
+// The instrumentation macros:                                              //
+//--------------------------------------------------------------------------//
+#ifdef SIRIUSFM_INSTR
+#	define SFM_INSTR(...) __VA_ARGS__
+#	define SFM_LAP(a_tc, a_phase) \
+	{ \
+		uint64_t sfmTn = SiriusFM::ReadTSC(); \
+		SiriusFM::g_instr.m_ticks[int(a_phase)] += sfmTn - (a_tc); \
+		(a_tc) = sfmTn; \
+	}
+#else
+#	define SFM_INSTR(...)
+#	define SFM_LAP(a_tc, a_phase)
+#endif
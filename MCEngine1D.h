@@ -8,29 +8,234 @@
 #include "Time.h"
 
 #include <cmath>
+#include <cstdint>
 #include <stdexcept>
 #include <new>
 #include <tuple>
+#include <random>
+#include <ostream>
+#include <type_traits>
+#include <utility>
 
 namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// Variance reduction modes, on top of the antithetic paths:              //
+	//------------------------------------------------------------------------//
+	enum class VarRedE: int {
+		None 				= 0,
+		// stratified terminal Brownian value (one stratum per path of a
+		// batch), the path being its Brownian bridge:
+		StratTerm 	= 1,
+		// the terminal Brownian values of a batch shifted and scaled to the
+		// sample mean 0 and variance T, the paths being their Brownian
+		// bridges:
+		MomentMatch = 2
+	};
+
+	//------------------------------------------------------------------------//
+	// "AcceptsWeights": the "PathEvaluator" also has the weighted form       //
+	//   (L, PM, Real const* paths, double const* ts, double const* wts),     //
+	// where "wts[p]" is the likelihood ratio of path "p", as required by the //
+	// importance sampling mode (see "MCEngine1D::SetImpSampling"):           //
+	//------------------------------------------------------------------------//
+	template<typename PathEvaluator, typename Real, typename = void>
+	struct AcceptsWeights: std::false_type {};
+
+	template<typename PathEvaluator, typename Real>
+	struct AcceptsWeights
+	<
+		PathEvaluator, Real,
+		std::void_t
+		<
+			decltype(std::declval<PathEvaluator&>()
+				(0L, 0L, std::declval<Real const*>(), std::declval<double const*>(),
+				 std::declval<double const*>()))
+		>
+	>
+	: std::true_type {};
+
+	//------------------------------------------------------------------------//
+	// "MCPipelineStats": stage timings of the last "Simulate" run:           //
+	//------------------------------------------------------------------------//
+	struct MCPipelineStats {
+		int 	 m_nProducers; 		// 0: serial mode (the caller generates)
+		int 	 m_nBufs; 				// in-memory path batches
+		long 	 m_batches; 			// batches evaluated
+		double m_wallSecs;
+		double m_genSecs; 			// generating, summed over the producers
+		double m_evalSecs; 			// in the "PathEvaluator"
+		double m_genWaitSecs; 	// producers waiting for a free buffer
+		double m_evalWaitSecs; 	// the evaluator waiting for a batch
+
+		// Busy fractions of the wall time (per producer on average):
+		double GenUtil() const {
+			int n = (m_nProducers > 0) ? m_nProducers : 1;
+			return (m_wallSecs > 0) ? m_genSecs / (n * m_wallSecs) : 0.0;
+		}
+
+		double EvalUtil() const {
+			return (m_wallSecs > 0) ? m_evalSecs / m_wallSecs : 0.0;
+		}
+	};
+
+	inline void PrintMCPipelineStats
+		(std::ostream& a_os, MCPipelineStats const& a_st)
+	{
+		a_os << "MC pipeline: producers: " << a_st.m_nProducers
+				 << ", buffers: " 					<< a_st.m_nBufs
+				 << ", batches: " 					<< a_st.m_batches
+				 << ", wall: " 							<< a_st.m_wallSecs << " s\n"
+				 << "  gen:  util " 				<< a_st.GenUtil()
+				 << " (busy " 							<< a_st.m_genSecs
+				 << " s, back-pressure " 		<< a_st.m_genWaitSecs << " s)\n"
+				 << "  eval: util " 				<< a_st.EvalUtil()
+				 << " (busy " 							<< a_st.m_evalSecs
+				 << " s, starved " 					<< a_st.m_evalWaitSecs << " s)\n";
+	}
+
+	//------------------------------------------------------------------------//
+	// "MCEngine1D": "Real" is the type of the stored path points (double or  //
+	// float: single precision halves the memory and the bandwidth of the     //
+	// path store and of its reads by the "PathEvaluator"). The evaluator is  //
+	// called as (L, PM, Real const* paths, double const* ts); the timeline   //
+	// stays in double, as the times are abs year fractions:                  //
+	//------------------------------------------------------------------------//
 	template
 	<
 		typename Diffusion1D, typename AProvider, typename BProvider, 
-		typename AssetClassA, typename AssetClassB,	typename PathEvaluator
+		typename AssetClassA, typename AssetClassB,	typename PathEvaluator,
+		typename Real = double
 	>
 	class MCEngine1D {
+		static_assert(std::is_floating_point_v<Real>, "Real must be float/double");
+
 		private:
+			// # of paths (and as many antithetic ones) stepped together:
+			static constexpr long BlockPMh = 128;
+			// # of points buffered per path before writing them out:
+			static constexpr long BufL 		 = 8;
+
 			long 		const m_MaxL; // max path length
 			long 		const m_MaxPM; // max # of paths stored in memory
-			double* const m_paths;
+			Real* 	const m_paths;
 			double* const m_ts;
+			int 					m_nProducers; // pipelined mode if > 0
+			int 					m_nBufs;
+			MCPipelineStats m_plStats;
+			VarRedE 			m_varRed;
+			double 				m_isTarget; // NaN: no importance sampling
+			double 				m_isTheta; 	// the drift shift of the last run
+			double* 			m_wts; 			// the likelihood ratios of the paths
+			long 					m_wtsN; 		// size of "m_wts"
+
+			//--------------------------------------------------------------------//
+			// The params of a run, shared by all generating threads:             //
+			//--------------------------------------------------------------------//
+			struct RunCtx {
+				long 		m_L;
+				double 	m_tau;
+				double 	m_tlast;
+				double 	m_stau;
+				double 	m_slast;
+				double 	m_lambda; 	// jump intensity
+				double 	m_jComp; 		// RN drift compensator of the jumps
+				double 	m_T; 				// the whole path (years)
+				VarRedE m_varRed;
+				bool 		m_isIS; 		// importance sampling,
+				double 	m_theta; 		// with this drift of the driving BM
+				Diffusion1D const* m_diff;
+				AProvider 	const* m_rateA;
+				BProvider 	const* m_rateB;
+				AssetClassA 		 	 m_assetA;
+				AssetClassB 		 	 m_assetB;
+			};
+
+			//--------------------------------------------------------------------//
+			// SoA state of a block of paths, per generating thread:              //
+			//--------------------------------------------------------------------//
+			struct BlockWS {
+				double* const m_S;
+				double* const m_mus; 	// drifts, or variances (SV)
+				double* const m_sig; 	// vols, or S (SV)
+				double* const m_Z; 		// normals: [nb] (+[nb] if SV)
+				double* const m_buf; 	// see "StorePoints"
+				double* const m_W; 		// Brownian bridge (StratTerm, MomentMatch):
+				double* const m_WT; 	// current and terminal values
+				double* const m_X; 		// sum of the driving increments (IS)
+				double* 			m_WTs; 	// terminal values of a batch (MomentMatch)
+				long 					m_WTsN; // size of "m_WTs"
+
+				BlockWS()
+				: m_S 	(new double[2 * BlockPMh]),
+					m_mus (new double[2 * BlockPMh]),
+					m_sig (new double[2 * BlockPMh]),
+					m_Z 	(new double[2 * BlockPMh]),
+					m_buf (new double[2 * BlockPMh * BufL]),
+					m_W 	(new double[BlockPMh]),
+					m_WT 	(new double[BlockPMh]),
+					m_X 	(new double[BlockPMh]),
+					m_WTs (nullptr),
+					m_WTsN(0)
+				{}
+
+				~BlockWS() {
+					delete[] m_S;
+					delete[] m_mus;
+					delete[] m_sig;
+					delete[] m_Z;
+					delete[] m_buf;
+					delete[] m_W;
+					delete[] m_WT;
+					delete[] m_X;
+					delete[] m_WTs;
+				}
+
+				BlockWS(BlockWS const&) = delete;
+				BlockWS& operator=(BlockWS const&) = delete;
+			};
+
+			// Generates a batch of "a_PMh" paths and their antithetic ones into
+			// "a_paths" (on the timeline "m_ts"), and their likelihood ratios
+			// into "a_wts" (importance sampling only):
+			template<bool IsRN>
+			void GenBatch(RunCtx const& a_ctx, long a_PMh, Real* a_paths,
+										double* a_wts, std::mt19937_64& a_U,
+										std::normal_distribution<>& a_N01, BlockWS& a_ws) const;
+
+			// The pipelined mode of "Simulate":
+			template<bool IsRN>
+			void RunPipelined(RunCtx const& a_ctx, long a_PM, long a_PI,
+												uint64_t a_seed, PathEvaluator* a_PathEval);
+
+			static void StorePoints(double const* a_S, long a_nb, long a_l,
+															long a_L, double* a_buf, Real* a_paths0,
+															Real* a_paths1);
+
+			static void AddJumps(Diffusion1D const* a_diff, double a_ldt, long a_n,
+													 double* a_S, std::mt19937_64& a_U);
+
+			static void MatchMoments(double* a_Z, long a_n);
+
+			// Calls "a_PathEval" on a batch, with the weights if not NULL:
+			static void EvalBatch(PathEvaluator* a_PathEval, long a_L, long a_PM,
+														Real const* a_paths, double const* a_ts,
+														double const* a_wts);
 
 		public:
 			MCEngine1D(long a_MaxL, long a_MaxPM)
 			: m_MaxL(a_MaxL),
 				m_MaxPM(a_MaxPM),
-				m_paths(new double[m_MaxL * m_MaxPM]),
-				m_ts(new double[m_MaxL])
+				m_paths(new Real[m_MaxL * m_MaxPM]),
+				m_ts(new double[m_MaxL]),
+				m_nProducers(0),
+				m_nBufs(1),
+				m_plStats{},
+				m_varRed(VarRedE::None),
+				m_isTarget(NAN),
+				m_isTheta(0),
+				m_wts(nullptr),
+				m_wtsN(0)
 			{
 				if (m_MaxL <= 0 || m_MaxPM <= 0)
 					throw std::invalid_argument("invalid max path size");
@@ -46,12 +251,75 @@ namespace SiriusFM {
 			~MCEngine1D() {
 				delete[] m_paths;
 				delete[] m_ts;
+				delete[] m_wts;
 			}
 
 			MCEngine1D(MCEngine1D const&) = delete; // no copy-constructor
 
 			MCEngine1D& operator=(MCEngine1D const&) = delete; // no operator=
-			
+
+			//--------------------------------------------------------------------//
+			// Pipelined mode: "a_nProducers" threads generate the path batches   //
+			// into "a_nBufs" buffers (each 1/a_nBufs of the in-memory paths),    //
+			// while the calling thread evaluates them, in order. With 0          //
+			// producers, the paths are generated and evaluated serially:         //
+			//--------------------------------------------------------------------//
+			void SetPipeline(int a_nProducers, int a_nBufs = 3) {
+				if (a_nProducers < 0 || (a_nProducers > 0 && a_nBufs < 2))
+					throw std::invalid_argument("invalid pipeline params");
+				m_nProducers = a_nProducers;
+				m_nBufs 		 = (a_nProducers > 0) ? a_nBufs : 1;
+			}
+
+			// The variance reduction mode (see "VarRedE"):
+			void SetVarRed(VarRedE a_varRed) {
+				m_varRed = a_varRed;
+			}
+
+			VarRedE GetVarRed() const {
+				return m_varRed;
+			}
+
+			//--------------------------------------------------------------------//
+			// Importance sampling: the Brownian motion driving S gets a constant //
+			// drift "theta" (Girsanov), chosen so that the median of S(T) is at  //
+			// "a_target" (eg the strike of a deep OTM option), and each path is  //
+			// passed to the "PathEvaluator" with its likelihood ratio            //
+			//   exp(- theta W(T) - theta^2 T / 2),                               //
+			// so the evaluator must accept weights ("AcceptsWeights"). NaN turns //
+			// it off:                                                            //
+			//--------------------------------------------------------------------//
+			void SetImpSampling(double a_target) {
+				if (!std::isnan(a_target)) {
+					if (!(a_target > 0) || !std::isfinite(a_target))
+						throw std::invalid_argument("invalid IS target");
+					if constexpr (!AcceptsWeights<PathEvaluator, Real>::value)
+						throw std::invalid_argument("PathEvaluator takes no weights");
+				}
+				m_isTarget = a_target;
+			}
+
+			double GetImpSampling() const {
+				return m_isTarget;
+			}
+
+			// The drift shift "theta" of the last run (0 without IS):
+			double GetISTheta() const {
+				return m_isTheta;
+			}
+
+			int GetNProducers() const {
+				return m_nProducers;
+			}
+
+			int GetNBufs() const {
+				return m_nBufs;
+			}
+
+			MCPipelineStats const& GetPipelineStats() const {
+				return m_plStats;
+			}
+
 			template<bool IsRN>
 			void Simulate
 			(
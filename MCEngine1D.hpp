@@ -2,26 +2,51 @@
 //                              "MCEngine1D.hpp"                            //
 // Implementation of "Simulate" method: generates diffusion paths and calls //
 // "PathEvaluator" for option pricing/hedging/etc                           //
+//--------------------------------------------------------------------------//
+// The in-memory paths are generated in blocks: all paths of a block are    //
+// stepped together, one t-point at a time, on SoA state, so the diffusion  //
+// coeffs are computed by the batch "mu" / "sigma" if the model has them.   //
+// For a jump-diffusion ("HasJumps"), the jumps of each step are applied to //
+// the block after the Euler step of the continuous part, and the RN drift  //
+// is compensated by lambda (E[e^J] - 1). In the pipelined mode (see        //
+// "SetPipeline"), the batches are generated by producer threads while the  //
+// calling thread evaluates the previous ones (see "RunPipelined"). The     //
+// paths are stored as "Real"s (double or float): the blocks are stepped in //
+// double, and each point is rounded once, as it is written out. Variance   //
+// reduction beyond the antithetic paths is selected by "SetVarRed", and    //
+// importance sampling (weighted paths) by "SetImpSampling"                 //
 //==========================================================================//
 
 #pragma once
 
 #include "MCEngine1D.h"
+#include "DiffusionTraits.h"
+#include "FastMath.h"
+#include "Instr.h"
 
 #include <random>
 #include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <exception>
 
 namespace SiriusFM {
 	template
 	<
 		typename Diffusion1D,	typename AProvider,	typename BProvider,
-		typename AssetClassA,	typename AssetClassB,	typename PathEvaluator
+		typename AssetClassA,	typename AssetClassB,	typename PathEvaluator,
+		typename Real
 	>
 	template<bool IsRN>
 	inline void MCEngine1D
 	<
 		Diffusion1D, AProvider,	BProvider,
-		AssetClassA, AssetClassB,	PathEvaluator
+		AssetClassA, AssetClassB,	PathEvaluator, Real
 	>::
 	Simulate
 	(
@@ -46,7 +71,7 @@ namespace SiriusFM {
 			&& a_assetA  	!= AssetClassA::UNDEFINED 
 			&& a_assetB  	!= AssetClassB::UNDEFINED 
 			&& a_t0 		 	<= a_T 
-			&& a_tau_min 	> 0 
+			&& a_tauMins 	> 0 
 			&& a_P				> 0
 			&& a_PathEval != nullptr);
 		
@@ -76,89 +101,690 @@ namespace SiriusFM {
 		if (L > m_MaxL)
 			throw std::invalid_argument("invalid path parameters");
 
-		std::normal_distribution<> N01(0.0, 1.0); 
-																			// create standard normal distribution
-		std::mt19937_64 U(a_useTimerSeed ? time(nullptr) : 0);
-																			// uniform random number generator
-		
-		long PM = (m_MaxL * m_MaxPM) / L; // PM: # of paths stored in memory
+		// the jump intensity and the RN drift compensator:
+		double lambda = 0;
+		double jComp 	= 0;
+		if constexpr (HasJumps<Diffusion1D>::value) {
+			lambda = a_diff->GetLambda();
+			jComp  = lambda * a_diff->GetJumpComp();
+		}
+
+		// importance sampling: "theta" moves the median of S(T) to the target
+		// as if S were a GBM with the drift and vol at (S0, t0); the paths
+		// are weighted by their likelihood ratios, so the estimates are
+		// unbiased whatever "theta" is, and this choice only has to be good:
+		double T 			= double(L - 2) * tau + tlast;
+		bool 	 isIS 	= !std::isnan(m_isTarget);
+		double theta 	= 0;
+		if (isIS) {
+			double S0 	= a_diff->GetS0();
+			double mu 	= 0;
+			double vol 	= 0;
+			if constexpr (IsStochVol<Diffusion1D>::value) {
+				// (the shift is of the S-driving normals only, so with a
+				// correlated variance it falls short of the target):
+				mu 	= a_diff->GetMu();
+				vol = sqrt(a_diff->GetV0());
+			}
+			else {
+				mu 	= a_diff->mu(S0, y0) / S0;
+				vol = a_diff->sigma(S0, y0) / S0;
+			}
+			if (IsRN)
+				mu = a_rateB->r(a_assetB, y0) - a_rateA->r(a_assetA, y0) - jComp;
+			if (vol > 0)
+				theta = (log(m_isTarget / S0) - (mu - 0.5 * vol * vol) * T) /
+								(vol * T);
+		}
+		m_isTheta = theta;
+
+		RunCtx ctx{L, tau, tlast, stau, slast, lambda, jComp, T, m_varRed, isIS,
+							 theta, a_diff, a_rateA, a_rateB, a_assetA, a_assetB};
+
+		// PM: # of paths stored in memory (no more than needed), in each of
+		// the "m_nBufs" buffers:
+		long PM = std::min<long>((m_MaxL * m_MaxPM) / (m_nBufs * L), P);
 
 		if (PM % 2 != 0)
 			--PM;
 
-		assert(PM > 0 && PM % 2 == 0);
-		
+		if (PM <= 0)
+			throw std::invalid_argument("invalid path parameters");
+
 		long PMh = PM / 2;
 
+		// the likelihood ratios of the paths of all buffers:
+		if (isIS && m_wtsN < m_nBufs * PM) {
+			delete[] m_wts;
+			m_wtsN = 0;
+			m_wts  = new double[m_nBufs * PM];
+			m_wtsN = m_nBufs * PM;
+		}
+		double* wts = isIS ? m_wts : nullptr;
+
 		// PI: # of outer P iterations:
 		long PI = (P  % PM == 0) ? P / PM : (P / PM) + 1;
 		
 		// Construct the TimeLine:
 		for (long l = 0; l < L - 1; ++l)
-			m_ts[l] = y0 + double(L) * tau;
+			m_ts[l] = y0 + double(l) * tau;
 
 		m_ts[L - 1] = m_ts[L - 2] + tlast;
 
+		uint64_t seed = a_useTimerSeed ? uint64_t(time(nullptr)) : 0;
+
+		if (m_nProducers > 0) {
+			RunPipelined<IsRN>(ctx, PM, PI, seed, a_PathEval);
+			return;
+		}
+
+		using Clock = std::chrono::steady_clock;
+		auto 	 t0 	= Clock::now();
+		double gen 	= 0;
+		double eval = 0;
+
+		std::normal_distribution<> N01(0.0, 1.0); 
+																			// create standard normal distribution
+		std::mt19937_64 U(seed); 					// uniform random number generator
+		BlockWS 				ws;
+
 		// main simulation loop:
 		for (long i = 0; i < PI; ++i) {
+			auto tg = Clock::now();
+			GenBatch<IsRN>(ctx, PMh, m_paths, wts, U, N01, ws);
+			auto te = Clock::now();
 
-			// generate in-memory paths
-			for (long p = 0; p < PMh; ++p) {
-				
-				double* path0 = m_paths + 2 * p * L;
-				double* path1 = path0 + L;
+			// Evaluate the in-memory paths
+			SFM_INSTR(uint64_t tc = ReadTSC(); g_instr.m_evalCalls += 1;)
+			EvalBatch(a_PathEval, L, PM, m_paths, m_ts, wts);
+			SFM_LAP(tc, PhaseE::Eval)
 
-				path0[0] = a_diff->GetS0(); // starting points
-				path1[0] = a_diff->GetS0();
+			gen  += std::chrono::duration<double>(te - tg).count();
+			eval += std::chrono::duration<double>(Clock::now() - te).count();
+		} // end of i-loop
+
+		m_plStats = MCPipelineStats{0, 1, PI,
+			std::chrono::duration<double>(Clock::now() - t0).count(), gen, eval,
+			0.0, 0.0};
+	}
+
+	//------------------------------------------------------------------------//
+	// "GenBatch":                                                            //
+	//------------------------------------------------------------------------//
+	// The paths are generated in blocks of "BlockPMh" paths and as many      //
+	// antithetic ones (at "a_PMh" + p), stepped together:                    //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D,	typename AProvider,	typename BProvider,
+		typename AssetClassA,	typename AssetClassB,	typename PathEvaluator,
+		typename Real
+	>
+	template<bool IsRN>
+	inline void MCEngine1D
+	<
+		Diffusion1D, AProvider,	BProvider,
+		AssetClassA, AssetClassB,	PathEvaluator, Real
+	>::
+	GenBatch
+	(
+		RunCtx const& 							a_ctx,
+		long 												a_PMh,
+		Real* 											a_paths,
+		double* 										a_wts,
+		std::mt19937_64& 						a_U,
+		std::normal_distribution<>& a_N01,
+		BlockWS& 										a_ws
+	)
+	const
+	{
+		// SoA state of a block of "nb" paths and their "nb" antithetic ones
+		// (at [nb + j]); for a stoch vol model, S is log S:
+		constexpr bool IsSV 		= IsStochVol<Diffusion1D>::value;
+		constexpr bool IsBatch 	= HasBatchCoeffs<Diffusion1D>::value;
+		constexpr bool IsJD 		= HasJumps<Diffusion1D>::value;
+		static_assert(!(IsSV && IsJD), "jumps of stoch vol models unsupported");
 
-				double S_p0 = a_diff->GetS0(); // previous points
-				double S_p1 = a_diff->GetS0();
+		Diffusion1D const* diff = a_ctx.m_diff;
+		long 	 L 			= a_ctx.m_L;
+		double lambda = a_ctx.m_lambda;
 
-				for (long l = 1; l < L; ++l) {
-					// compute the trend:
-					double mu0 = 0.0; // 2 paths
-					double mu1 = 0.0;
-					double y = m_ts[l - 1]; // l is the next point
+		double* S 	= a_ws.m_S;
+		double* mus = a_ws.m_mus;
+		double* sig = a_ws.m_sig;
+		double* Z 	= a_ws.m_Z;
+		double* buf = a_ws.m_buf;
+		double* W 	= a_ws.m_W;
+		double* WT 	= a_ws.m_WT;
+		double* X 	= a_ws.m_X;
 
-					if (IsRN) { // risk-neutral case
-						double delta_r = a_rateB->r(a_assetB, y) - a_rateA->r(a_assetA, y);
-						mu0 = delta_r * S_p0;
-						mu1 = delta_r * S_p1;
+		bool isStrat 	= (a_ctx.m_varRed == VarRedE::StratTerm);
+		bool isMM 		= (a_ctx.m_varRed == VarRedE::MomentMatch);
+		bool isBridge = isStrat || isMM;
+		bool isIS 		= a_ctx.m_isIS;
+		double theta 	= a_ctx.m_theta;
+		double sT 		= sqrt(a_ctx.m_T);
+		// the normals which drive S (and are bridged), and their # per set:
+		long nZ = IsSV ? 2 : 1;
+
+		// moment-matched terminal values of the Brownian motion driving S,
+		// over the whole batch (those of the antithetic paths, the -WTs, then
+		// match too). Per step, the antithetic paths already match the mean,
+		// which leaves little to gain:
+		if (isMM) {
+			if (a_ws.m_WTsN < a_PMh) {
+				delete[] a_ws.m_WTs;
+				a_ws.m_WTsN = 0;
+				a_ws.m_WTs 	= new double[a_PMh];
+				a_ws.m_WTsN = a_PMh;
+			}
+			for (long j = 0; j < a_PMh; ++j)
+				a_ws.m_WTs[j] = a_N01(a_U);
+			MatchMoments(a_ws.m_WTs, a_PMh);
+		}
+
+		for (long b0 = 0; b0 < a_PMh; b0 += BlockPMh) {
+			long nb = std::min<long>(BlockPMh, a_PMh - b0);
+			Real* paths0 = a_paths + b0 * L; 					// paths
+			Real* paths1 = a_paths + (a_PMh + b0) * L; // antithetic ones
+
+			SFM_INSTR(
+				g_instr.m_batches += 1;
+				g_instr.m_paths 	+= 2 * nb;
+				g_instr.m_steps 	+= 2 * nb * (L - 1);
+				g_instr.m_bytes 	+= 2 * nb * L * sizeof(Real);
+				uint64_t tc = ReadTSC();
+			)
+
+			for (long j = 0; j < nb; ++j) {
+				paths0[j * L] = Real(diff->GetS0()); // starting points
+				paths1[j * L] = Real(diff->GetS0());
+			}
+
+			if constexpr (IsSV) {
+				for (long j = 0; j < 2 * nb; ++j) {
+					S  [j] = log(diff->GetS0());
+					mus[j] = diff->GetV0();
+				}
+			}
+			else {
+				for (long j = 0; j < 2 * nb; ++j)
+					S[j] = diff->GetS0();
+			}
+
+			// stratified terminal values of the Brownian motion driving S: the
+			// k-th path of the batch is in the k-th of "a_PMh" equiprobable
+			// strata (its antithetic one is then in the mirror stratum):
+			if (isStrat) {
+				for (long j = 0; j < nb; ++j) {
+					double u = (double(b0 + j) +
+											(double(a_U() >> 11) + 0.5) * 0x1p-53) / double(a_PMh);
+					u 		= std::min<double>(std::max<double>(u, 0x1p-60), 1.0 - 0x1p-53);
+					WT[j] = sT * InvPhi(u);
+					W[j] 	= 0;
+				}
+			}
+			else if (isMM) {
+				for (long j = 0; j < nb; ++j) {
+					WT[j] = sT * a_ws.m_WTs[b0 + j];
+					W[j] 	= 0;
+				}
+			}
+
+			if (isIS)
+				for (long j = 0; j < nb; ++j)
+					X[j] = 0;
+
+			for (long l = 1; l < L; ++l) {
+				double y 	 = m_ts[l - 1]; // l is the next point
+				double dt  = (l == L - 1) ? a_ctx.m_tlast : a_ctx.m_tau;
+				double sdt = (l == L - 1) ? a_ctx.m_slast : a_ctx.m_stau;
+
+				double delta_r =
+					IsRN ? a_ctx.m_rateB->r(a_ctx.m_assetB, y)
+								 - a_ctx.m_rateA->r(a_ctx.m_assetA, y) - a_ctx.m_jComp
+							 : 0.0;
+
+				for (long j = 0; j < (IsSV ? 2 * nb : nb); ++j)
+					Z[j] = a_N01(a_U);
+
+				if (isBridge) {
+					// the Brownian bridge from W[j] at "y" to WT[j] at the end (in
+					// "rem"): the increment is N(dt / rem (WT - W), dt (rem - dt) / rem)
+					// and Z its normalized value:
+					double rem = a_ctx.m_T - double(l - 1) * a_ctx.m_tau;
+					double a 	 = (l == L - 1) ? 1.0 : dt / rem;
+					double b 	 = (l == L - 1) ? 0.0
+											 : sqrt(std::max<double>(dt * (rem - dt) / rem, 0.0));
+					double* Zs = Z + (nZ - 1) * nb;
+					for (long j = 0; j < nb; ++j) {
+						double dW = a * (WT[j] - W[j]) + b * Zs[j];
+						W[j] 	+= dW;
+						Zs[j] = dW / sdt;
 					}
+				}
+
+				// IS: the S-driving normals of the paths are shifted by "h", and
+				// those of the antithetic ones too (ie -Z + h, not -(Z + h)), so
+				// both are pushed towards the target:
+				double h = theta * sdt;
+				if (isIS) {
+					double const* Zs = Z + (nZ - 1) * nb;
+					for (long j = 0; j < nb; ++j)
+						X[j] += sdt * Zs[j];
+				}
+				SFM_LAP(tc, PhaseE::RNG)
 
-					else {
-						mu0 = a_diff->mu(S_p0, y);
-						mu1 = a_diff->mu(S_p1, y);
+				if constexpr (IsSV) {
+					// (log S, v) stepped by the model`s own scheme:
+					auto 	 qc 		= diff->MkQEConsts(dt);
+					double drift 	= IsRN ? delta_r : diff->GetMu();
+
+					for (long j = 0; j < nb; ++j) {
+						double Zv = Z[j];
+						double Zs = Z[nb + j];
+						diff->StepQE(qc, drift,  Zv,  Zs + h, S + j, 			mus + j);
+						diff->StepQE(qc, drift, -Zv, -Zs + h, S + nb + j, mus + nb + j);
+						sig[j] 			= exp(S[j]);
+						sig[nb + j] = exp(S[nb + j]);
 					}
+					SFM_LAP(tc, PhaseE::Step)
+					StorePoints(sig, nb, l, L, buf, paths0, paths1);
+					SFM_LAP(tc, PhaseE::Store)
+				}
+				else {
+					// compute the trend and volatility for the whole block:
+					if (IsRN)
+						for (long j = 0; j < 2 * nb; ++j)
+							mus[j] = delta_r * S[j];
+					else if constexpr (IsBatch)
+						diff->mu(S, y, mus, 2 * nb);
+					else
+						for (long j = 0; j < 2 * nb; ++j)
+							mus[j] = diff->mu(S[j], y);
+
+					if constexpr (IsBatch)
+						diff->sigma(S, y, sig, 2 * nb);
+					else
+						for (long j = 0; j < 2 * nb; ++j)
+							sig[j] = diff->sigma(S[j], y);
+					SFM_LAP(tc, PhaseE::Coeffs)
 
-					// compute volatility
-					double sigma0 = a_diff->sigma(S_p0, y);
-					double sigma1 = a_diff->sigma(S_p1, y);
-				
-					// generate points
-					double Z = N01(U);
-					double S_n0 = 0;
-					double  S_n1 = 0;;
-
-					if (l == L - 1) { // last interval
-						S_n0 = S_p0 + mu0 * tlast + sigma0 * slast * Z;
-						S_n1 = S_p1 + mu1 * tlast - sigma1 * slast * Z;
+					// generate points:
+					for (long j = 0; j < nb; ++j) {
+						S[j] 			+= mus[j] * dt 			+ sig[j] * sdt * (Z[j] + h);
+						S[nb + j] += mus[nb + j] * dt - sig[nb + j] * sdt * (Z[j] - h);
 					}
 
-					else { // generic case
-						S_n0 = S_p0 + mu0 * tau + sigma0 * stau * Z;
-						S_n1 = S_p1 + mu1 * tau - sigma1 * stau * Z;
+					if constexpr (IsJD)
+						if (lambda > 0)
+							AddJumps(diff, lambda * dt, 2 * nb, S, a_U);
+					SFM_LAP(tc, PhaseE::Step)
+
+					StorePoints(S, nb, l, L, buf, paths0, paths1);
+					SFM_LAP(tc, PhaseE::Store)
+				}
+			} // end of l-loop
+
+			// the likelihood ratios: X is the unshifted W(T) of the path, and
+			// -X that of its antithetic one:
+			if (isIS) {
+				double c = 0.5 * theta * theta * a_ctx.m_T;
+				for (long j = 0; j < nb; ++j) {
+					a_wts[b0 + j] 				= exp(- theta * X[j] - c);
+					a_wts[a_PMh + b0 + j] = exp(theta * X[j] - c);
+				}
+			}
+		} // end of block loop
+	}
+
+	//------------------------------------------------------------------------//
+	// "RunPipelined":                                                        //
+	//------------------------------------------------------------------------//
+	// The "m_nBufs" buffers of "a_PM" paths each circulate between the       //
+	// producers and the evaluator (the calling thread) through 2 bounded     //
+	// queues: the free buffers, and the ready ones (tagged by their batch    //
+	// #). A producer takes a free buffer and the next batch #, generates     //
+	// the batch and tags the buffer with it; the evaluator waits for the     //
+	// batches in order and frees their buffers once evaluated. So the        //
+	// producers run at most "m_nBufs" - 1 batches ahead, and block when no   //
+	// buffer is free (back-pressure). Each batch has its own RNG, seeded by  //
+	// (seed, batch #), so the paths, and the results, do not depend on the   //
+	// # of producers or on the timing (but differ from the serial mode).     //
+	// The first exception of any thread aborts the run and is re-thrown:     //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D,	typename AProvider,	typename BProvider,
+		typename AssetClassA,	typename AssetClassB,	typename PathEvaluator,
+		typename Real
+	>
+	template<bool IsRN>
+	inline void MCEngine1D
+	<
+		Diffusion1D, AProvider,	BProvider,
+		AssetClassA, AssetClassB,	PathEvaluator, Real
+	>::
+	RunPipelined
+	(
+		RunCtx const& 	a_ctx,
+		long 						a_PM,
+		long 						a_PI,
+		uint64_t 				a_seed,
+		PathEvaluator* 	a_PathEval
+	)
+	{
+		using Clock = std::chrono::steady_clock;
+		auto secs 	= [](Clock::time_point a_t) {
+			return std::chrono::duration<double>(Clock::now() - a_t).count();
+		};
+		auto t0 = Clock::now();
+
+		long L 	= a_ctx.m_L;
+		int  nB = m_nBufs;
+		int  nP = int(std::min<long>(m_nProducers, a_PI));
+
+		std::mutex 							mtx;
+		std::condition_variable cvFree;
+		std::condition_variable cvReady;
+		std::deque<int> 				freeQ; 				// free buffers
+		long* 									ready 	= new long[nB]; // batch # or -1
+		long 										nextGen = 0;
+		bool 										abort 	= false;
+		std::exception_ptr 			err 		= nullptr;
+		double 									gen 		= 0; 	// (summed over the producers)
+		double 									genWait = 0;
+		SFM_INSTR(InstrStats prodInstr = {};)
+
+		for (int b = 0; b < nB; ++b) {
+			freeQ.push_back(b);
+			ready[b] = -1;
+		}
+
+		auto fail = [&]() {
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				if (err == nullptr)
+					err = std::current_exception();
+				abort = true;
+			}
+			cvFree.notify_all();
+			cvReady.notify_all();
+		};
+
+		auto produce = [&]() {
+			double myGen 	= 0;
+			double myWait = 0;
+			try {
+				BlockWS ws;
+				while (true) {
+					int  b;
+					long i;
+					{
+						auto tw = Clock::now();
+						std::unique_lock<std::mutex> lock(mtx);
+						cvFree.wait(lock, [&]() {
+							return abort || nextGen >= a_PI || !freeQ.empty();
+						});
+						myWait += secs(tw);
+						if (abort || nextGen >= a_PI)
+							break;
+						b = freeQ.front();
+						freeQ.pop_front();
+						i = nextGen++;
 					}
+					// the last batch is taken: the producers still waiting for a
+					// buffer (a "notify_one" of a freed one may have woken another
+					// producer) have nothing more to do, so release them all:
+					if (i == a_PI - 1)
+						cvFree.notify_all();
+					auto tg = Clock::now();
+					std::seed_seq ss{uint32_t(a_seed), uint32_t(a_seed >> 32),
+													 uint32_t(i), uint32_t(uint64_t(i) >> 32)};
+					std::mt19937_64 						U(ss);
+					std::normal_distribution<> 	N01(0.0, 1.0);
+					GenBatch<IsRN>(a_ctx, a_PM / 2, m_paths + b * a_PM * L,
+												 a_ctx.m_isIS ? m_wts + b * a_PM : nullptr, U, N01, ws);
+					myGen += secs(tg);
+					{
+						std::lock_guard<std::mutex> lock(mtx);
+						ready[b] = i;
+					}
+					cvReady.notify_one();
+				}
+			}
+			catch (...) {
+				fail();
+			}
+			std::lock_guard<std::mutex> lock(mtx);
+			gen 		+= myGen;
+			genWait += myWait;
+			SFM_INSTR(AddInstrStats(prodInstr, g_instr);)
+		};
 
-					path0[l] = S_n0;
-					path1[l] = S_n1;
-					S_p0 = S_n0;
-					S_p1 = S_n1;
-				} // end of l-loop
-			} // end of p-loop
+		double eval 		= 0;
+		double evalWait = 0;
+		std::vector<std::thread> threads;
+		try {
+			threads.reserve(nP);
+			for (int p = 0; p < nP; ++p)
+				threads.emplace_back(produce);
 
-			// Evaluate the in-memory paths
-			(*a_PathEval)(L, PM, m_paths, m_ts);
-		} // end of i-loop
+			for (long i = 0; i < a_PI; ++i) {
+				int b = -1;
+				{
+					auto tw = Clock::now();
+					std::unique_lock<std::mutex> lock(mtx);
+					cvReady.wait(lock, [&]() {
+						for (b = 0; b < nB; ++b)
+							if (ready[b] == i)
+								return true;
+						return abort;
+					});
+					evalWait += secs(tw);
+					if (abort)
+						break;
+				}
+				auto te = Clock::now();
+
+				// Evaluate the batch:
+				SFM_INSTR(uint64_t tc = ReadTSC(); g_instr.m_evalCalls += 1;)
+				EvalBatch(a_PathEval, L, a_PM, m_paths + b * a_PM * L, m_ts,
+									a_ctx.m_isIS ? m_wts + b * a_PM : nullptr);
+				SFM_LAP(tc, PhaseE::Eval)
+				eval += secs(te);
+
+				{
+					std::lock_guard<std::mutex> lock(mtx);
+					ready[b] = -1;
+					freeQ.push_back(b);
+				}
+				cvFree.notify_one();
+			}
+		}
+		catch (...) {
+			fail();
+		}
+		for (std::thread& th: threads)
+			th.join();
+		delete[] ready;
+		SFM_INSTR(AddInstrStats(g_instr, prodInstr);)
+
+		m_plStats = MCPipelineStats{m_nProducers, nB, a_PI, secs(t0), gen, eval,
+																genWait, evalWait};
+		if (err != nullptr)
+			std::rethrow_exception(err);
+	}
+
+	//------------------------------------------------------------------------//
+	// "StorePoints":                                                         //
+	//------------------------------------------------------------------------//
+	// Point "a_l" of the block paths goes to "a_buf" first; the paths are    //
+	// written "BufL" points (a cache line) at a time, as direct stores to    //
+	// the 2 * "a_nb" paths "L" apart would each touch another line:          //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D,	typename AProvider,	typename BProvider,
+		typename AssetClassA,	typename AssetClassB,	typename PathEvaluator,
+		typename Real
+	>
+	inline void MCEngine1D
+	<
+		Diffusion1D, AProvider,	BProvider,
+		AssetClassA, AssetClassB,	PathEvaluator, Real
+	>::
+	StorePoints
+	(
+		double const* a_S,
+		long 					a_nb,
+		long 					a_l,
+		long 					a_L,
+		double* 			a_buf,
+		Real* 				a_paths0,
+		Real* 				a_paths1
+	)
+	{
+		long lb = a_l % BufL;
+		for (long j = 0; j < 2 * a_nb; ++j)
+			a_buf[j * BufL + lb] = a_S[j];
+
+		if (lb != BufL - 1 && a_l != a_L - 1)
+			return;
+
+		long l0 = a_l - lb;
+		for (long j = 0; j < a_nb; ++j) {
+			Real* 				d0 = a_paths0 + j * a_L + l0;
+			Real* 				d1 = a_paths1 + j * a_L + l0;
+			double const* b0 = a_buf + j * BufL;
+			double const* b1 = a_buf + (a_nb + j) * BufL;
+			for (long k = 0; k <= lb; ++k) {
+				d0[k] = Real(b0[k]);
+				d1[k] = Real(b1[k]);
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// "MatchMoments": shifts and scales "a_Z" to the sample mean 0 and       //
+	// variance 1 (the antithetic paths, driven by -"a_Z", then match too):   //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D,	typename AProvider,	typename BProvider,
+		typename AssetClassA,	typename AssetClassB,	typename PathEvaluator,
+		typename Real
+	>
+	inline void MCEngine1D
+	<
+		Diffusion1D, AProvider,	BProvider,
+		AssetClassA, AssetClassB,	PathEvaluator, Real
+	>::
+	MatchMoments(double* a_Z, long a_n)
+	{
+		if (a_n < 2)
+			return;
+
+		double s1 = 0;
+		double s2 = 0;
+		for (long j = 0; j < a_n; ++j) {
+			s1 += a_Z[j];
+			s2 += a_Z[j] * a_Z[j];
+		}
+		double m 	 = s1 / double(a_n);
+		double var = s2 / double(a_n) - m * m;
+		if (!(var > 0))
+			return;
+
+		double k = 1.0 / sqrt(var);
+		for (long j = 0; j < a_n; ++j)
+			a_Z[j] = (a_Z[j] - m) * k;
+	}
+
+	//------------------------------------------------------------------------//
+	// "EvalBatch":                                                           //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D,	typename AProvider,	typename BProvider,
+		typename AssetClassA,	typename AssetClassB,	typename PathEvaluator,
+		typename Real
+	>
+	inline void MCEngine1D
+	<
+		Diffusion1D, AProvider,	BProvider,
+		AssetClassA, AssetClassB,	PathEvaluator, Real
+	>::
+	EvalBatch
+	(
+		PathEvaluator* 	a_PathEval,
+		long 						a_L,
+		long 						a_PM,
+		Real const* 		a_paths,
+		double const* 	a_ts,
+		double const* 	a_wts
+	)
+	{
+		if constexpr (AcceptsWeights<PathEvaluator, Real>::value)
+			if (a_wts != nullptr) {
+				(*a_PathEval)(a_L, a_PM, a_paths, a_ts, a_wts);
+				return;
+			}
+		assert(a_wts == nullptr);
+		(*a_PathEval)(a_L, a_PM, a_paths, a_ts);
+	}
+
+	//------------------------------------------------------------------------//
+	// "AddJumps":                                                            //
+	//------------------------------------------------------------------------//
+	// Jumps over a step of intensity * dt = "a_ldt" for the "a_n" paths at   //
+	// "a_S". Only the paths with non-zero Poisson counts are visited: the    //
+	// # of zero counts before the next non-zero one is geometric, ie         //
+	// floor(E / a_ldt) with E ~ Exp(1); the count itself is then drawn from  //
+	// the Poisson law conditional on >= 1, and the jump sizes only for it.   //
+	// So a step costs ~ (a_n * a_ldt + 1) draws rather than "a_n":           //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D,	typename AProvider,	typename BProvider,
+		typename AssetClassA,	typename AssetClassB,	typename PathEvaluator,
+		typename Real
+	>
+	inline void MCEngine1D
+	<
+		Diffusion1D, AProvider,	BProvider,
+		AssetClassA, AssetClassB,	PathEvaluator, Real
+	>::
+	AddJumps
+	(
+		Diffusion1D const* a_diff,
+		double 						 a_ldt,
+		long 							 a_n,
+		double* 					 a_S,
+		std::mt19937_64& 	 a_U
+	)
+	{
+		constexpr int MaxJumps = 1000; // per step (a guard only)
+		std::uniform_real_distribution<> U01(0.0, 1.0);
+
+		double p0 = exp(- a_ldt); // P[no jumps]
+		for (long j = -1; ; ) {
+			double g = floor(- log(1.0 - U01(a_U)) / a_ldt);
+			if (g >= double(a_n - 1 - j))
+				break;
+			j += long(g) + 1;
+
+			// the count by inversion of its CDF:
+			double u 	 = U01(a_U) * (1.0 - p0);
+			double pk  = a_ldt * p0;
+			double cdf = pk;
+			int 	 n 	 = 1;
+			while (u > cdf && n < MaxJumps) {
+				++n;
+				pk 	*= a_ldt / n;
+				cdf += pk;
+			}
+			a_S[j] *= exp(a_diff->LogJumps(n, a_U));
+		}
 	}
 }
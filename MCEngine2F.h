@@ -0,0 +1,112 @@
+//==========================================================================//
+//                               "MCEngine2F.h"                             //
+// "MCEngine2F" class declaration: joint MC of the spot S and the short     //
+// rate r of ccy B ("IRModeE::Stoch")                                       //
+//--------------------------------------------------------------------------//
+//   dS = (r - rA(t)) S dt + sigma(S, t) dW1  (or mu(S, t) dt + ..., non-RN)//
+//   dr = muR(r, t) dt + sigmaR(r, t) dW2,    d<W1, W2> = rho dt            //
+// where rA(t) is deterministic (from "AProvider") and "RateDiffusion" is   //
+// eg "DiffusionVasicek" or "DiffusionCIR" (which stops below 0, so with    //
+// 2 kappa theta >= sigma^2 and short steps). The in-memory paths are       //
+// stepped together (SoA: one t-layer for all of them at a time); only the  //
+// S paths are stored, the rate is integrated on the fly into the pathwise  //
+// DF = exp(-Int_{t0}^{T} r dt), which is passed to the "PathEvaluator":    //
+//   (*a_PathEval)(L, PM, paths, ts, DFs)                                   //
+//==========================================================================//
+
+#pragma once
+
+#include "Time.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <new>
+
+namespace SiriusFM {
+	template
+	<
+		typename Diffusion1D, typename RateDiffusion, typename AProvider,
+		typename AssetClassA, typename AssetClassB, typename PathEvaluator
+	>
+	class MCEngine2F {
+		private:
+			long 		const m_MaxL; // max path length
+			long 		const m_MaxPM; // max # of paths stored in memory
+			double* const m_paths; // [p * L + l]: S paths
+			double* const m_ts;
+
+			//--------------------------------------------------------------------//
+			// SoA state of the in-memory paths (freed on any exit from           //
+			// "Simulate", including the exceptions of "PathEvaluator"):          //
+			//--------------------------------------------------------------------//
+			struct StepWS {
+				double* const m_S;
+				double* const m_r;
+				double* const m_I; 	// Int_{t0}^{t} r, then the DFs
+				double* const m_Z1;
+				double* const m_Z2;
+
+				StepWS(long a_PM)
+				: m_S (new double[a_PM]),
+					m_r (new double[a_PM]),
+					m_I (new double[a_PM]),
+					m_Z1(new double[a_PM]),
+					m_Z2(new double[a_PM])
+				{}
+
+				~StepWS() {
+					delete[] m_S;
+					delete[] m_r;
+					delete[] m_I;
+					delete[] m_Z1;
+					delete[] m_Z2;
+				}
+
+				StepWS(StepWS const&) = delete;
+				StepWS& operator=(StepWS const&) = delete;
+			};
+
+		public:
+			MCEngine2F(long a_MaxL, long a_MaxPM)
+			: m_MaxL(a_MaxL),
+				m_MaxPM(a_MaxPM),
+				m_paths(new double[m_MaxL * m_MaxPM]),
+				m_ts(new double[m_MaxL])
+			{
+				if (m_MaxL <= 0 || m_MaxPM <= 0)
+					throw std::invalid_argument("invalid max path size");
+
+				for (long l = 0; l < m_MaxL; ++l)
+					m_ts[l] = 0;
+				for (long i = 0; i < m_MaxL * m_MaxPM; ++i)
+					m_paths[i] = 0;
+			}
+
+			~MCEngine2F() {
+				delete[] m_paths;
+				delete[] m_ts;
+			}
+
+			MCEngine2F(MCEngine2F const&) = delete; // no copy-constructor
+
+			MCEngine2F& operator=(MCEngine2F const&) = delete; // no operator=
+
+			// "a_rho": correlation of the S and r Brownian motions:
+			template<bool IsRN>
+			void Simulate
+			(
+				time_t a_t0,
+				time_t a_T,
+				int    a_tauMins,
+				long   a_P,
+				bool   a_useTimerSeed,
+				Diffusion1D 	const* a_diff,
+				RateDiffusion const* a_rateDiff,
+				double 							 a_rho,
+				AProvider 		const* a_rateA,
+				AssetClassA 	 a_assetA,
+				AssetClassB		 a_assetB,
+				PathEvaluator* a_PathEval
+			);
+	};
+}
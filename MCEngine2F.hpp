@@ -0,0 +1,169 @@
+//==========================================================================//
+//                              "MCEngine2F.hpp"                            //
+// Implementation of "Simulate" method: generates (S, r) paths, stores the  //
+// S paths with their pathwise DFs and calls "PathEvaluator"                //
+//==========================================================================//
+
+#pragma once
+
+#include "MCEngine2F.h"
+#include "DiffusionTraits.h"
+
+#include <random>
+#include <cassert>
+#include <algorithm>
+
+namespace SiriusFM {
+	template
+	<
+		typename Diffusion1D, typename RateDiffusion, typename AProvider,
+		typename AssetClassA, typename AssetClassB, typename PathEvaluator
+	>
+	template<bool IsRN>
+	inline void MCEngine2F
+	<
+		Diffusion1D, RateDiffusion, AProvider,
+		AssetClassA, AssetClassB, PathEvaluator
+	>::
+	Simulate
+	(
+		time_t a_t0,
+		time_t a_T,
+		int 	 a_tauMins,
+		long 	 a_P,
+		bool 	 a_useTimerSeed,
+		Diffusion1D 	const* a_diff,
+		RateDiffusion const* a_rateDiff,
+		double 							 a_rho,
+		AProvider 		const* a_rateA,
+		AssetClassA a_assetA,
+		AssetClassB a_assetB,
+		PathEvaluator* a_PathEval
+	)
+	{
+		// check parameters` validity:
+		assert(
+			a_diff 	   	 	!= nullptr
+			&& a_rateDiff != nullptr
+			&& a_rateA 	 	!= nullptr
+			&& a_assetA  	!= AssetClassA::UNDEFINED
+			&& a_assetB  	!= AssetClassB::UNDEFINED
+			&& a_t0 		 	<= a_T
+			&& a_tauMins 	> 0
+			&& a_P				> 0
+			&& a_PathEval != nullptr);
+
+		static_assert(!HasJumps<Diffusion1D>::value,
+									"jump-diffusions are not supported by this engine");
+
+		if (!(a_rho >= -1.0 && a_rho <= 1.0))
+			throw std::invalid_argument("invalid correlation");
+
+		time_t T_sec = a_T - a_t0;
+		time_t tau_sec = a_tauMins * SEC_IN_MIN;
+		long L_ints =
+			(T_sec % tau_sec == 0)
+			? T_sec / tau_sec
+			: T_sec / tau_sec + 1; // number of intervals
+
+		double tau = YearFracInt(tau_sec);
+
+		double tlast =
+			(T_sec % tau_sec == 0)
+			? tau
+			: YearFracInt(T_sec - (L_ints - 1) * tau_sec);
+
+		assert(tlast > 0 && tlast <= tau);
+		long L = L_ints + 1; // number of points
+		double y0 = YearFrac(a_t0);
+		assert(L >= 2); // at least 2 points
+		long P = 2 * a_P; // antithetic variables
+
+		if (L > m_MaxL)
+			throw std::invalid_argument("invalid path parameters");
+
+		std::normal_distribution<> N01(0.0, 1.0);
+		std::mt19937_64 U(a_useTimerSeed ? time(nullptr) : 0);
+
+		// PM: # of paths stored in memory (no more than needed):
+		long PM = std::min<long>((m_MaxL * m_MaxPM) / L, P);
+
+		if (PM % 2 != 0)
+			--PM;
+
+		assert(PM > 0 && PM % 2 == 0);
+
+		long PMh = PM / 2;
+
+		// PI: # of outer P iterations:
+		long PI = (P  % PM == 0) ? P / PM : (P / PM) + 1;
+
+		// Construct the TimeLine:
+		for (long l = 0; l < L - 1; ++l)
+			m_ts[l] = y0 + double(l) * tau;
+
+		m_ts[L - 1] = m_ts[L - 2] + tlast;
+
+		// SoA state of the in-memory paths (path p + PMh is the antithetic of
+		// path p):
+		StepWS ws(PM);
+		double* S  = ws.m_S;
+		double* r  = ws.m_r;
+		double* I  = ws.m_I;
+		double* Z1 = ws.m_Z1;
+		double* Z2 = ws.m_Z2;
+
+		double rhoC = sqrt(1.0 - a_rho * a_rho);
+
+		// main simulation loop:
+		for (long i = 0; i < PI; ++i) {
+
+			for (long p = 0; p < PM; ++p) {
+				S[p] = a_diff->GetS0();
+				r[p] = a_rateDiff->GetS0();
+				I[p] = 0;
+				m_paths[p * L] = S[p];
+			}
+
+			for (long l = 1; l < L; ++l) {
+				double y  = m_ts[l - 1]; // l is the next point
+				double dt = m_ts[l] - y;
+				double sdt = sqrt(dt);
+				double rA = IsRN ? a_rateA->r(a_assetA, y) : 0.0;
+
+				// correlated normals (antithetic in the 2nd half):
+				for (long p = 0; p < PMh; ++p) {
+					double W1 = N01(U);
+					double W2 = N01(U);
+					Z1[p] 			=  W1;
+					Z2[p] 			=  a_rho * W1 + rhoC * W2;
+					Z1[p + PMh] = -Z1[p];
+					Z2[p + PMh] = -Z2[p];
+				}
+
+				// Euler step of (S, r) for all paths at once; the rate is
+				// integrated by the trapezoid rule:
+				for (long p = 0; p < PM; ++p) {
+					double Sp = S[p];
+					double rp = r[p];
+					double mu = IsRN ? (rp - rA) * Sp : a_diff->mu(Sp, y);
+					double Sn = Sp + mu * dt + a_diff->sigma(Sp, y) * sdt * Z1[p];
+					double rn = rp + a_rateDiff->mu(rp, y) * dt +
+											a_rateDiff->sigma(rp, y) * sdt * Z2[p];
+					I[p] += 0.5 * (rp + rn) * dt;
+					S[p]  = Sn;
+					r[p]  = rn;
+				}
+
+				for (long p = 0; p < PM; ++p)
+					m_paths[p * L + l] = S[p];
+			} // end of l-loop
+
+			for (long p = 0; p < PM; ++p)
+				I[p] = exp(-I[p]);
+
+			// Evaluate the in-memory paths
+			(*a_PathEval)(L, PM, m_paths, m_ts, I);
+		} // end of i-loop
+	}
+}
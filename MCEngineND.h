@@ -0,0 +1,70 @@
+//==========================================================================//
+//                               "MCEngineND.h"                             //
+// "MCEngineND" class declaration: MC of N correlated 1D diffusions         //
+//--------------------------------------------------------------------------//
+// The correlation matrix of the Brownian motions is given at construction  //
+// and its Cholesky factor is computed once. At each t-step the independent //
+// normals of all the in-memory paths are correlated by a blocked lower-    //
+// triangular matrix kernel, and the N diffusions are stepped on SoA state. //
+// The paths are stored with all assets at a time point contiguous:         //
+//   m_paths[(p * L + l) * N + d]                                           //
+// The memory budget (MaxL * MaxPM points) is shared by all the N dims      //
+//==========================================================================//
+
+#pragma once
+
+#include "Time.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <memory>
+
+namespace SiriusFM {
+	template
+	<
+		typename Diffusion1D, typename AProvider, typename BProvider,
+		typename AssetClassA, typename AssetClassB,	typename PathEvaluator
+	>
+	class MCEngineND {
+		private:
+			// # of paths per block in the correlation kernel:
+			static constexpr long BlockP = 256;
+
+			long 		const m_MaxL; 	// max path length
+			long 		const m_MaxPM; 	// max # of 1D paths stored in memory
+			int 		const m_N; 			// # of dims
+			// (the buffers are freed on any exit, incl. the throws of the Ctor):
+			std::unique_ptr<double[]> const m_paths;
+			std::unique_ptr<double[]> const m_ts;
+			std::unique_ptr<double[]> const m_chol; // [N * N]: lower Cholesky
+																							// factor of corrs
+
+		public:
+			// "a_corr": N * N correlation matrix (row-major):
+			MCEngineND(long a_MaxL, long a_MaxPM, int a_N, double const* a_corr);
+
+			MCEngineND(MCEngineND const&) = delete; // no copy-constructor
+
+			MCEngineND& operator=(MCEngineND const&) = delete; // no operator=
+
+			int GetN() const { return m_N; }
+
+			// "a_diffs", "a_assetsA": [N]; the PathEvaluator is called as
+			// (*a_PathEval)(L, PM, paths, ts):
+			template<bool IsRN>
+			void Simulate
+			(
+				time_t a_t0,
+				time_t a_T,
+				int    a_tauMins,
+				long   a_P,
+				bool   a_useTimerSeed,
+				Diffusion1D const* const* a_diffs,
+				AProvider 	const* a_rateA,
+				BProvider 	const* a_rateB,
+				AssetClassA const* a_assetsA,
+				AssetClassB		 a_assetB,
+				PathEvaluator* a_PathEval
+			);
+	};
+}
@@ -0,0 +1,251 @@
+//==========================================================================//
+//                              "MCEngineND.hpp"                            //
+// Implementation of "MCEngineND" Ctor (Cholesky factorisation) and of      //
+// "Simulate" method: generates correlated N-dim paths and calls            //
+// "PathEvaluator" for option pricing/etc                                   //
+//==========================================================================//
+
+#pragma once
+
+#include "MCEngineND.h"
+#include "DiffusionTraits.h"
+
+#include <random>
+#include <cassert>
+#include <algorithm>
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// Non-Default Ctor:                                                      //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D,	typename AProvider,	typename BProvider,
+		typename AssetClassA,	typename AssetClassB,	typename PathEvaluator
+	>
+	MCEngineND
+	<
+		Diffusion1D, AProvider,	BProvider,
+		AssetClassA, AssetClassB,	PathEvaluator
+	>::
+	MCEngineND(long a_MaxL, long a_MaxPM, int a_N, double const* a_corr)
+	: m_MaxL	(a_MaxL),
+		m_MaxPM	(a_MaxPM),
+		m_N 		(a_N),
+		m_paths	(new double[m_MaxL * m_MaxPM]),
+		m_ts		(new double[m_MaxL]),
+		m_chol 	(new double[m_N > 0 ? m_N * m_N : 1])
+	{
+		if (m_MaxL <= 0 || m_MaxPM <= 0 || m_N <= 0 || a_corr == nullptr)
+			throw std::invalid_argument("invalid max path size or dims");
+
+		for (long l = 0; l < m_MaxL; ++l)
+			m_ts[l] = 0;
+
+		// Cholesky: corr = C C^T, C lower-triangular:
+		int N = m_N;
+		for (int i = 0; i < N; ++i)
+			for (int j = 0; j < N; ++j) {
+				double c = a_corr[i * N + j];
+				bool ok  = (i == j) ? (c == 1.0)
+														: (c >= -1.0 && c <= 1.0 && c == a_corr[j * N + i]);
+				if (!ok)
+					throw std::invalid_argument("invalid correlation matrix");
+			}
+
+		for (int i = 0; i < N; ++i) {
+			double* Ci = m_chol.get() + i * N;
+			for (int j = 0; j <= i; ++j) {
+				double const* Cj = m_chol.get() + j * N;
+				double s = a_corr[i * N + j];
+				for (int k = 0; k < j; ++k)
+					s -= Ci[k] * Cj[k];
+
+				if (j < i)
+					Ci[j] = s / Cj[j];
+				else if (s > 0)
+					Ci[i] = sqrt(s);
+				else
+					throw std::invalid_argument("correlation matrix is not PD");
+			}
+			for (int j = i + 1; j < N; ++j)
+				Ci[j] = 0;
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// "Simulate":                                                            //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D,	typename AProvider,	typename BProvider,
+		typename AssetClassA,	typename AssetClassB,	typename PathEvaluator
+	>
+	template<bool IsRN>
+	inline void MCEngineND
+	<
+		Diffusion1D, AProvider,	BProvider,
+		AssetClassA, AssetClassB,	PathEvaluator
+	>::
+	Simulate
+	(
+		time_t a_t0,
+		time_t a_T,
+		int 	 a_tauMins,
+		long 	 a_P,
+		bool 	 a_useTimerSeed,
+		Diffusion1D const* const* a_diffs,
+		AProvider 	const* a_rateA,
+		BProvider 	const* a_rateB,
+		AssetClassA const* a_assetsA,
+		AssetClassB a_assetB,
+		PathEvaluator* a_PathEval
+	)
+	{
+		// check parameters` validity:
+		assert(
+			a_diffs 	   	!= nullptr
+			&& a_rateA 	 	!= nullptr
+			&& a_rateB 	 	!= nullptr
+			&& a_assetsA 	!= nullptr
+			&& a_assetB  	!= AssetClassB::UNDEFINED
+			&& a_t0 		 	<= a_T
+			&& a_tauMins 	> 0
+			&& a_P				> 0
+			&& a_PathEval != nullptr);
+
+		static_assert(!HasJumps<Diffusion1D>::value,
+									"jump-diffusions are not supported by this engine");
+
+		int N = m_N;
+
+		time_t T_sec = a_T - a_t0;
+		time_t tau_sec = a_tauMins * SEC_IN_MIN;
+		long L_ints =
+			(T_sec % tau_sec == 0)
+			? T_sec / tau_sec
+			: T_sec / tau_sec + 1; // number of intervals
+
+		double tau = YearFracInt(tau_sec);
+
+		double tlast =
+			(T_sec % tau_sec == 0)
+			? tau
+			: YearFracInt(T_sec - (L_ints - 1) * tau_sec);
+
+		assert(tlast > 0 && tlast <= tau);
+		long L = L_ints + 1; // number of points
+		double y0 = YearFrac(a_t0);
+		assert(L >= 2); // at least 2 points
+		long P = 2 * a_P; // antithetic variables
+
+		if (L * N > m_MaxL * m_MaxPM / 2)
+			throw std::invalid_argument("invalid path parameters");
+
+		std::normal_distribution<> N01(0.0, 1.0);
+																			// create standard normal distribution
+		std::mt19937_64 U(a_useTimerSeed ? time(nullptr) : 0);
+																			// uniform random number generator
+
+		// PM: # of N-dim paths stored in memory (no more than needed):
+		long PM = std::min<long>((m_MaxL * m_MaxPM) / (L * N), P);
+
+		if (PM % 2 != 0)
+			--PM;
+
+		assert(PM > 0 && PM % 2 == 0);
+
+		long PMh = PM / 2;
+
+		// PI: # of outer P iterations:
+		long PI = (P  % PM == 0) ? P / PM : (P / PM) + 1;
+
+		// Construct the TimeLine:
+		for (long l = 0; l < L - 1; ++l)
+			m_ts[l] = y0 + double(l) * tau;
+
+		m_ts[L - 1] = m_ts[L - 2] + tlast;
+
+		// SoA state: S[d * PM + p] (path p + PMh is the antithetic of path p),
+		// normals Z[d * PMh + p] (freed on any exit, incl. the exceptions of
+		// "PathEvaluator"):
+		std::unique_ptr<double[]> SBuf(new double[N * PM]);
+		std::unique_ptr<double[]> ZBuf(new double[N * PMh]);
+		std::unique_ptr<double[]> rAs (new double[N]);
+		double* S = SBuf.get();
+		double* Z = ZBuf.get();
+
+		// main simulation loop:
+		for (long i = 0; i < PI; ++i) {
+
+			for (int d = 0; d < N; ++d) {
+				double S0 = a_diffs[d]->GetS0();
+				for (long p = 0; p < PM; ++p) {
+					S[d * PM + p] 			 = S0;
+					m_paths[p * L * N + d] = S0;
+				}
+			}
+
+			for (long l = 1; l < L; ++l) {
+				double y  	= m_ts[l - 1]; // l is the next point
+				double dt 	= m_ts[l] - y;
+				double sdt 	= sqrt(dt);
+				double rB 	= IsRN ? a_rateB->r(a_assetB, y) : 0.0;
+				for (int d = 0; d < N; ++d)
+					rAs[d] = IsRN ? a_rateA->r(a_assetsA[d], y) : 0.0;
+
+				for (long j = 0; j < N * PMh; ++j)
+					Z[j] = N01(U);
+
+				// Correlate in place, block by block of paths: Z_d <- Sum_{k<=d}
+				// C[d][k] Z_k; going from the last dim down, the Z_k (k <= d) are
+				// not yet overwritten:
+				for (long p0 = 0; p0 < PMh; p0 += BlockP) {
+					long nb = std::min<long>(BlockP, PMh - p0);
+					for (int d = N - 1; d >= 0; --d) {
+						double const* Cd = m_chol.get() + d * N;
+						double* 			__restrict__ Zd = Z + d * PMh + p0;
+						double 				cdd = Cd[d];
+						for (long j = 0; j < nb; ++j)
+							Zd[j] *= cdd;
+						for (int k = 0; k < d; ++k) {
+							double const* __restrict__ Zk = Z + k * PMh + p0;
+							double 				ck = Cd[k];
+							for (long j = 0; j < nb; ++j)
+								Zd[j] += ck * Zk[j];
+						}
+					}
+				}
+
+				// Euler step of each dim (the 2nd half of paths is antithetic):
+				for (int d = 0; d < N; ++d) {
+					Diffusion1D const* diff = a_diffs[d];
+					double const* Zd 	= Z + d * PMh;
+					double* 			Sd 	= S + d * PM;
+					double 				dr 	= rB - rAs[d];
+
+					for (int h = 0; h < 2; ++h) {
+						double* Sh = Sd + h * PMh;
+						double 	sz = (h == 0) ? sdt : -sdt;
+						for (long p = 0; p < PMh; ++p) {
+							double Sp = Sh[p];
+							double mu = IsRN ? dr * Sp : diff->mu(Sp, y);
+							Sh[p] 		= Sp + mu * dt + diff->sigma(Sp, y) * sz * Zd[p];
+						}
+					}
+				}
+
+				// Store the t-layer: all dims of a path contiguous:
+				for (long p = 0; p < PM; ++p) {
+					double* pt = m_paths.get() + (p * L + l) * N;
+					for (int d = 0; d < N; ++d)
+						pt[d] = S[d * PM + p];
+				}
+			} // end of l-loop
+
+			// Evaluate the in-memory paths
+			(*a_PathEval)(L, PM, m_paths.get(), m_ts.get());
+		} // end of i-loop
+	}
+}
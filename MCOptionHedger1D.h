@@ -19,16 +19,16 @@ namespace SiriusFM {
 	template
 	<
 		typename Diffusion1D, typename AProvider, typename BProvider,
-		typename AssetClassA, typename AssetClassB
+		typename AssetClassA, typename AssetClassB,
+		typename Real = double // of the path points, see "MCEngine1D"
 	>
 	class MCOptionHedger1D {
 		public:
 			using DeltaFunc = 
 				std::function<double(double, double)>; // function (S, t) -> Delta
 
-		private:	
       //--------------------------------------------------------------------//
-      // Path Evaluator for option hedging                                  //
+      // Path Evaluator for option hedging (public, as "OPPathEval")        //
       //--------------------------------------------------------------------//
 			class OHPathEval {
 				private:
@@ -82,9 +82,10 @@ namespace SiriusFM {
 						m_ratesA = nullptr;
 					}
 					
-					// overload operator "()"
+					// overload operator "()" (on double or float paths):
+					template<typename PathReal>
 					void operator() (long a_L, long a_PM,
-									double const* a_paths, double const* a_ts) {
+									PathReal const* a_paths, double const* a_ts) {
 
 						// If rates are not available yet:
 						if (m_ratesA == nullptr) {
@@ -101,7 +102,7 @@ namespace SiriusFM {
 					
 						// Evaluate all stored paths:
 						for (long p = 0; p < a_PM; ++p) {
-							double const* path = a_paths + p * a_L;
+							PathReal const* path = a_paths + p * a_L;
 							
 							// Perform delta-hedging along the path:
 							double M = - m_C0; // we long the option, short C0: curr money
@@ -146,6 +147,10 @@ namespace SiriusFM {
 							m_maxPnL = std::max<double>(m_maxPnL, PnL);
 						}
 						m_P += a_PM;
+						SFM_INSTR(
+							g_instr.m_payoffs 	 += a_PM;
+							g_instr.m_deltaCalls += a_PM * (a_L - 1);
+						)
 					}
 				
 					// GetStats returns E[PnL], StD[PnL], Min[PnL], Max[PnL]
@@ -161,6 +166,7 @@ namespace SiriusFM {
 					}
 			};
 
+		private:
 			//--------------------------------------------------------------------//
 			// Fields:                                                            //
 			//--------------------------------------------------------------------//
@@ -168,7 +174,7 @@ namespace SiriusFM {
     		AProvider                 m_irpA;
     		BProvider                 m_irpB;
     		MCEngine1D<Diffusion1D, AProvider, BProvider, AssetClassA,
-				AssetClassB, OHPathEval>  m_mce;
+				AssetClassB, OHPathEval, Real> m_mce;
     		bool                      m_useTimerSeed;
 
 		public:
@@ -203,6 +209,24 @@ namespace SiriusFM {
 				long 						 a_P = 100'000
 			);
 			
+			//--------------------------------------------------------------------//
+			// The pipelined MC mode (see "MCEngine1D::SetPipeline"): the delta   //
+			// functions make "OHPathEval" heavy, so generating the next paths    //
+			// meanwhile saves most of the generation time:                       //
+			//--------------------------------------------------------------------//
+			void SetPipeline(int a_nProducers, int a_nBufs = 3) {
+				m_mce.SetPipeline(a_nProducers, a_nBufs);
+			}
+
+			MCPipelineStats const& GetPipelineStats() const {
+				return m_mce.GetPipelineStats();
+			}
+
+			// The variance reduction mode (see "MCEngine1D::SetVarRed"):
+			void SetVarRed(VarRedE a_varRed) {
+				m_mce.SetVarRed(a_varRed);
+			}
+
 			//--------------------------------------------------------------------//
 			// Accessors for rates:                                               //
 			//--------------------------------------------------------------------//
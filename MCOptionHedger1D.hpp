@@ -16,11 +16,12 @@ namespace SiriusFM {
 	template
 	<
 		typename Diffusion1D, typename AProvider, typename BProvider,
-		typename AssetClassA, typename AssetClassB	
+		typename AssetClassA, typename AssetClassB,
+		typename Real
 	>
 	std::tuple<double, double, double, double> 
 	MCOptionHedger1D<Diffusion1D, AProvider, BProvider,
-																				AssetClassA, AssetClassB>::
+																				AssetClassA, AssetClassB, Real>::
 	SimulateHedging
 	(
 		Option<AssetClassA, AssetClassB> const* a_option,
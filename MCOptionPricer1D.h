@@ -8,8 +8,10 @@
 #include "IRProviderConst.h"
 #include "MCEngine1D.hpp"
 #include "VanillaOption.h"
+#include "PxCache.h"
 
 #include <iostream>
+#include <string>
 
 namespace SiriusFM {
 
@@ -19,46 +21,131 @@ namespace SiriusFM {
 	template
 	<
 		typename Diffusion1D, typename AProvider, typename BProvider,
-		typename AssetClassA, typename AssetClassB
+		typename AssetClassA, typename AssetClassB,
+		typename Real = double // of the path points, see "MCEngine1D"
 	>
 	class MCOptionPricer1D {
-		private:			
-			// Path Evaluator for option pricing
+		public:
+			// Path Evaluator for option pricing (public, so that it can also be
+			// driven by other path sources, eg in "Bench"):
 			class OPPathEval {
 				private:
 					Option<AssetClassA, AssetClassB> 
 					const* const  m_option;
+					// Control variate (optional): an option of known price:
+					Option<AssetClassA, AssetClassB>
+					const* const  m_cvOption;
 					long 					m_P;   	 // Total path evaluator
 					double 				m_sum; 	 // sum of payoffs
 					double 				m_sum2;  // sum of payoffs^2
 					double				m_minPO; // min PayOff
 					double				m_maxPO; // max PayOff
+					double 				m_sumY;  // sum of control payoffs
+					double 				m_sumY2; // sum of control payoffs^2
+					double 				m_sumXY; // sum of payoff * control payoff
+					// Batch means of the payoffs (for the actual variance of the
+					// price, whatever the path sampling):
+					long 					m_nB;
+					double 				m_sumB;
+					double 				m_sumB2;
+					// Likelihood ratios of the paths (importance sampling):
+					double 				m_sumW;
+					double 				m_sumW2;
+
+					// The payoffs (and the control ones) enter the sums multiplied
+					// by the weights of their paths, if any:
+					template<typename PathReal>
+					void Eval(long a_L, long a_PM, PathReal const* a_paths,
+										double const* a_ts, double const* a_wts)
+					{
+						double sum0 = m_sum;
+						for (long p = 0; p < a_PM; ++p) {
+							PathReal const* path = a_paths + p * a_L;
+							double w 					 = (a_wts != nullptr) ? a_wts[p] : 1.0;
+							double payOff 		 = m_option->Payoff(a_L, path, a_ts);
+							double X 					 = w * payOff;
+							m_sum  += X;
+							m_sum2 += X * X;
+							m_sumW 	+= w;
+							m_sumW2 += w * w;
+							m_minPO = std::min<double>(m_minPO, payOff);
+							m_maxPO = std::max<double>(m_maxPO, payOff);
+
+							if (m_cvOption != nullptr) {
+								double Y = w * m_cvOption->Payoff(a_L, path, a_ts);
+								m_sumY 	+= Y;
+								m_sumY2 += Y * Y;
+								m_sumXY += X * Y;
+							}
+						}
+
+						m_P += a_PM;
+						double mB = (m_sum - sum0) / double(a_PM);
+						++m_nB;
+						m_sumB 	+= mB;
+						m_sumB2 += mB * mB;
+						SFM_INSTR(
+							g_instr.m_payoffs += (m_cvOption != nullptr) ? 2 * a_PM : a_PM;
+						)
+					}
  
 				public:
-					OPPathEval(Option<AssetClassA, AssetClassB> const* a_option)
+					OPPathEval
+					(
+						Option<AssetClassA, AssetClassB> const* a_option,
+						Option<AssetClassA, AssetClassB> const* a_cvOption = nullptr
+					)
 					: m_option(a_option),
+					  m_cvOption(a_cvOption),
 					  m_P		 (0),
 					  m_sum	 (0),
 					  m_sum2 (0),
 					  m_minPO( INFINITY),
-					  m_maxPO(-INFINITY)
+					  m_maxPO(-INFINITY),
+					  m_sumY (0),
+					  m_sumY2(0),
+					  m_sumXY(0),
+					  m_nB 	 (0),
+					  m_sumB (0),
+					  m_sumB2(0),
+					  m_sumW (0),
+					  m_sumW2(0)
 
 					{assert(m_option != nullptr);}
 					
-					// overload operator "()"
+					// overload operator "()" (on double or float paths; the sums are
+					// in double anyway):
+					template<typename PathReal>
 					void operator() (long a_L, long a_PM,
-									double const* a_paths, double const* a_ts) 
+									PathReal const* a_paths, double const* a_ts) 
 					{
-						for (long p = 0; p < a_PM; ++p) {
-							double const* path = a_paths + p * a_L;
-							double payOff 		 = m_option->Payoff(a_L, path, a_ts);
-							m_sum  += payOff;
-							m_sum2 += payOff * payOff;
-							m_minPO = std::min<double>(m_minPO, payOff);
-							m_maxPO = std::max<double>(m_maxPO, payOff);
-						}
+						Eval(a_L, a_PM, a_paths, a_ts, nullptr);
+					}
 
-					m_P += a_PM;
+					// The same on importance-sampled paths, of the likelihood
+					// ratios "a_wts" (see "MCEngine1D::SetImpSampling"):
+					template<typename PathReal>
+					void operator() (long a_L, long a_PM, PathReal const* a_paths,
+													 double const* a_ts, double const* a_wts)
+					{
+						assert(a_wts != nullptr);
+						Eval(a_L, a_PM, a_paths, a_ts, a_wts);
+					}
+
+					// GetPxCV returns E[Px] adjusted by the control variate, whose
+					// exact expected payoff is "a_EY": E[X] - beta (E[Y] - a_EY),
+					// with the optimal beta = Cov[X, Y] / Var[Y]:
+					double GetPxCV(double a_EY) const {
+						if (m_P < 2 || m_cvOption == nullptr)
+							throw std::runtime_error("empty OPPathEval or no CV");
+
+						double n 	= double(m_P);
+						double EX = m_sum  / n;
+						double EY = m_sumY / n;
+						double vY = m_sumY2 / n - EY * EY;
+						double cXY = m_sumXY / n - EX * EY;
+						double beta = (vY > 0) ? cXY / vY : 0.0;
+						return EX - beta * (EY - a_EY);
 					}
 
 					// GetPx return E[Px]
@@ -79,15 +166,80 @@ namespace SiriusFM {
 						assert(var >= 0);
 						return std::make_tuple(sqrt(var), m_minPO, m_maxPO);
 					}
+
+					// GetVarRedStats returns the StdErr of E[Px] from the spread of
+					// the batch means (valid under any variance reduction, which
+					// makes the payoffs of a batch dependent), and the variance
+					// reduction factor achieved: the variance of E[Px] of i.i.d.
+					// paths (Var[PayOff] / P) over that actual one. The batches (of
+					// equal sizes, as in "MCEngine1D") are the only independent
+					// groups of paths: a path and its antithetic one are half a
+					// batch apart, and the strata span the whole batch, so the
+					// means of sub-batches would not do. Hence NaN unless there
+					// have been 2+ batches; an engine holding all the paths in
+					// memory (as the default one of "MCOptionPricer1D" often does)
+					// must be sized down for that, as in "Bench":
+					std::tuple<double, double> GetVarRedStats() const {
+						if (m_nB < 2)
+							return std::make_tuple(NAN, NAN);
+
+						double n 		= double(m_nB);
+						double mB 	= m_sumB / n;
+						double varB = std::max<double>
+													((m_sumB2 - n * mB * mB) / (n - 1.0), 0.0);
+						double px 	= m_sum / double(m_P);
+						double var 	= (m_sum2 - double(m_P) * px * px) / double(m_P - 1);
+						double err2 = varB / n; // Var[E[Px]]
+						return std::make_tuple(sqrt(err2),
+							(err2 > 0) ? var / double(m_P) / err2 : INFINITY);
+					}
+
+					// GetISStats returns the mean likelihood ratio (1 up to the MC
+					// error, as a check of the weights) and the effective sample
+					// size (Sum w)^2 / Sum w^2 as a fraction of the paths (1 for
+					// unweighted paths, small if a few paths dominate):
+					std::tuple<double, double> GetISStats() const {
+						if (m_P < 2)
+							throw std::runtime_error("empty OPPathEval");
+
+						return std::make_tuple(m_sumW / double(m_P),
+							m_sumW * m_sumW / m_sumW2 / double(m_P));
+					}
 			};
-			
+
+		private:
 				Diffusion1D const* const  m_diff;
     		AProvider                 m_irpA;
     		BProvider                 m_irpB;
     		MCEngine1D<Diffusion1D, AProvider, BProvider, AssetClassA,
-																							AssetClassB, OPPathEval>
+																				AssetClassB, OPPathEval, Real>
 																	m_mce;
     		bool                      m_useTimerSeed;
+				PxCache* 									m_cache; 		// optional, not owned
+				std::string 							m_irsFileA; // (for "m_ratesKey")
+				std::string 							m_irsFileB;
+				SpecKey 									m_ratesKey; // of the rate files, once
+																							// a cache is set
+				bool 											m_useIS; 		// importance sampling
+
+				// The importance sampling target of "a_option" (NaN for none):
+				double ISTarget(Option<AssetClassA, AssetClassB> const* a_option)
+				const
+				{
+					return m_useIS ? a_option->GetStrike() : NAN;
+				}
+
+				// The cache key of a pricing call ("a_cvOption" is NULL for "Px");
+				// empty if the result is not to be cached:
+				SpecKey MkKey
+				(
+					Option<AssetClassA, AssetClassB> const* a_option,
+					Option<AssetClassA, AssetClassB> const* a_cvOption,
+					double a_cvPx,
+					time_t a_t0,
+					int 	 a_tauMins,
+					long 	 a_P
+				) const;
 
 		public:
 			// non-default constructor:
@@ -103,8 +255,46 @@ namespace SiriusFM {
 			  m_irpB				(a_irsFileB),
 			  m_mce 				(102'271, 4096),
 																// (5-min points in 1y) * 4k pats in-memory
-			  m_useTimerSeed(a_useTimerSeed)
+			  m_useTimerSeed(a_useTimerSeed),
+				m_cache 			(nullptr),
+				m_irsFileA 		((a_irsFileA != nullptr) ? a_irsFileA : ""),
+				m_irsFileB 		((a_irsFileB != nullptr) ? a_irsFileB : ""),
+				m_ratesKey 		{0, 0},
+				m_useIS 			(false)
 			{}
+
+			// Attaches a result cache (NULL to detach). Only the fixed-seed
+			// prices are cached. The rate files are hashed (once) for the keys
+			// here, not by the Ctor, so a pricer without a cache never reads
+			// them again:
+			void SetCache(PxCache* a_cache) {
+				if (a_cache != nullptr && m_ratesKey.IsEmpty())
+					m_ratesKey = HashRates<AProvider, BProvider>(m_irsFileA.c_str(),
+																											 m_irsFileB.c_str());
+				m_cache = a_cache;
+			}
+
+			// The pipelined MC mode (see "MCEngine1D::SetPipeline"):
+			void SetPipeline(int a_nProducers, int a_nBufs = 3) {
+				m_mce.SetPipeline(a_nProducers, a_nBufs);
+			}
+
+			MCPipelineStats const& GetPipelineStats() const {
+				return m_mce.GetPipelineStats();
+			}
+
+			// The variance reduction mode (see "MCEngine1D::SetVarRed"):
+			void SetVarRed(VarRedE a_varRed) {
+				m_mce.SetVarRed(a_varRed);
+			}
+
+			// Importance sampling towards the strike (see "Option::GetStrike"
+			// and "MCEngine1D::SetImpSampling"), for the deep OTM and digital
+			// options, whose payoffs are mostly 0 otherwise; the options with
+			// no strike are priced as usual:
+			void SetImpSampling(bool a_on) {
+				m_useIS = a_on;
+			}
 			
 			// The pricing function
 			double Px
@@ -117,5 +307,18 @@ namespace SiriusFM {
 				int  	 a_tauMins = 15, // by default
 				long 	 a_P = 100'000
 			);
+
+			// The pricing function with a control variate: "a_cvOption" of the
+			// known price "a_cvPx" (eg a European option priced by a closed
+			// form) is evaluated on the same paths:
+			double PxCV
+			(
+				Option<AssetClassA, AssetClassB> const* a_option,
+				Option<AssetClassA, AssetClassB> const* a_cvOption,
+				double a_cvPx,
+				time_t a_t0,
+				int  	 a_tauMins = 15,
+				long 	 a_P = 100'000
+			);
 	};
 }
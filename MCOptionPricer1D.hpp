@@ -16,10 +16,11 @@ namespace SiriusFM {
 	template
 	<
 		typename Diffusion1D, typename AProvider, typename BProvider,
-		typename AssetClassA, typename AssetClassB	
+		typename AssetClassA, typename AssetClassB,
+		typename Real
 	>
 	double MCOptionPricer1D<Diffusion1D, AProvider, BProvider,
-							AssetClassA, AssetClassB>::
+							AssetClassA, AssetClassB, Real>::
 	Px
 	(
 		// Instrument Spec:
@@ -35,8 +36,14 @@ namespace SiriusFM {
 		if (a_option->m_isAmerican)
 			throw std::invalid_argument("MC cannot price American options");
 		
+		SpecKey key = MkKey(a_option, nullptr, 0.0, a_t0, a_tauMins, a_P);
+		PxVal 	val;
+		if (!key.IsEmpty() && m_cache->Get(key, &val))
+			return val.m_px;
+
 		// Path Evaluator:
 		OPPathEval pathEval(a_option);
+		m_mce.SetImpSampling(ISTarget(a_option));
 
 		// run MC: Option pricing is Risk-Neutral
 		m_mce.template Simulate<true>
@@ -48,6 +55,108 @@ namespace SiriusFM {
 
 		// Apply the discoint factor on B:
 		px *= m_irpB.DF(a_option->m_assetB, a_t0, a_option->m_expirTime);
+
+		if (!key.IsEmpty())
+			m_cache->Put(key, PxVal{px, NAN, NAN, NAN});
 		return px;
 	}
+
+	//------------------------------------------------------------------------//
+	// MCOptionPricer1D::PxCV"                                                //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D, typename AProvider, typename BProvider,
+		typename AssetClassA, typename AssetClassB,
+		typename Real
+	>
+	double MCOptionPricer1D<Diffusion1D, AProvider, BProvider,
+							AssetClassA, AssetClassB, Real>::
+	PxCV
+	(
+		Option<AssetClassA, AssetClassB> const* a_option,
+		Option<AssetClassA, AssetClassB> const* a_cvOption,
+		double a_cvPx,
+		time_t a_t0,
+		int 	 a_tauMins,
+		long 	 a_P
+	)
+	{
+		assert(a_option != nullptr && a_cvOption != nullptr && a_tauMins > 0 &&
+					 a_P > 0);
+
+		if (a_option->m_isAmerican || a_cvOption->m_isAmerican)
+			throw std::invalid_argument("MC cannot price American options");
+
+		if (a_cvOption->m_expirTime != a_option->m_expirTime ||
+				a_cvOption->m_assetA 		!= a_option->m_assetA 		||
+				a_cvOption->m_assetB 		!= a_option->m_assetB)
+			throw std::invalid_argument("control variate on other underlying");
+
+		SpecKey key = MkKey(a_option, a_cvOption, a_cvPx, a_t0, a_tauMins, a_P);
+		PxVal 	val;
+		if (!key.IsEmpty() && m_cache->Get(key, &val))
+			return val.m_px;
+
+		OPPathEval pathEval(a_option, a_cvOption);
+		m_mce.SetImpSampling(ISTarget(a_option));
+
+		m_mce.template Simulate<true>
+		(a_t0, a_option->m_expirTime, a_tauMins, a_P, m_useTimerSeed, m_diff,
+				&m_irpA, &m_irpB, a_option->m_assetA, a_option->m_assetB, &pathEval);
+
+		double df = m_irpB.DF(a_option->m_assetB, a_t0, a_option->m_expirTime);
+		double px = df * pathEval.GetPxCV(a_cvPx / df);
+
+		if (!key.IsEmpty())
+			m_cache->Put(key, PxVal{px, NAN, NAN, NAN});
+		return px;
+	}
+
+	//------------------------------------------------------------------------//
+	// MCOptionPricer1D::MkKey"                                               //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D, typename AProvider, typename BProvider,
+		typename AssetClassA, typename AssetClassB,
+		typename Real
+	>
+	SpecKey MCOptionPricer1D<Diffusion1D, AProvider, BProvider,
+							AssetClassA, AssetClassB, Real>::
+	MkKey
+	(
+		Option<AssetClassA, AssetClassB> const* a_option,
+		Option<AssetClassA, AssetClassB> const* a_cvOption,
+		double a_cvPx,
+		time_t a_t0,
+		int 	 a_tauMins,
+		long 	 a_P
+	)
+	const
+	{
+		// a timer-seeded price is not reproducible, so it is not cached:
+		if (m_cache == nullptr || m_useTimerSeed)
+			return SpecKey{0, 0};
+
+		SpecHasher h;
+		h.Add((a_cvOption == nullptr) ? "MCOptionPricer1D::Px"
+																	: "MCOptionPricer1D::PxCV");
+		if (!a_option->HashSpec(h))
+			return SpecKey{0, 0};
+
+		if (a_cvOption != nullptr) {
+			if (!a_cvOption->HashSpec(h))
+				return SpecKey{0, 0};
+			h.Add(a_cvPx);
+		}
+		if (!HashDiffusion(h, *m_diff))
+			return SpecKey{0, 0};
+		h.Add(m_ratesKey).Add(int64_t(a_t0)).Add(a_tauMins).Add(a_P);
+		// (the pipelined mode draws other paths, which depend on the # of
+		// buffers but not on the # of producers; 1 buffer is the serial mode):
+		h.Add(m_mce.GetNBufs()).Add(int(sizeof(Real))).Add(m_mce.GetVarRed())
+		 .Add(ISTarget(a_option));
+		return h.GetKey();
+	}
 }
@@ -0,0 +1,140 @@
+//==========================================================================//
+//                              "MCOptionPricer2F.h"                        //
+// Declaration of "MCOptionPricer2F" class: MC pricing with the stochastic  //
+// short rate of ccy B ("IRModeE::Stoch"), correlated with the spot         //
+//--------------------------------------------------------------------------//
+// The price is E[DF * Payoff] with the pathwise DF accumulated by          //
+// "MCEngine2F", so any "Option::Payoff" can be used as is                  //
+//==========================================================================//
+
+#pragma once
+
+#include "MCEngine2F.hpp"
+#include "Option.h"
+
+#include <cmath>
+#include <cassert>
+#include <tuple>
+#include <algorithm>
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// "MCOptionPricer2F:"                                                    //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D, typename RateDiffusion, typename AProvider,
+		typename AssetClassA, typename AssetClassB
+	>
+	class MCOptionPricer2F {
+		private:
+			// Path Evaluator for option pricing: accumulates discounted payoffs
+			class OPPathEval {
+				private:
+					Option<AssetClassA, AssetClassB>
+					const* const  m_option;
+					long 					m_P;   	 // Total path evaluator
+					double 				m_sum; 	 // sum of discounted payoffs
+					double 				m_sum2;  // sum of discounted payoffs^2
+					double 				m_sumDF; // sum of DFs
+					double 				m_sumDF2; // sum of DFs^2
+
+				public:
+					OPPathEval(Option<AssetClassA, AssetClassB> const* a_option)
+					: m_option(a_option),
+					  m_P		 (0),
+					  m_sum	 (0),
+					  m_sum2 (0),
+					  m_sumDF(0),
+					  m_sumDF2(0)
+					{assert(m_option != nullptr);}
+
+					void operator() (long a_L, long a_PM, double const* a_paths,
+													 double const* a_ts, double const* a_DFs)
+					{
+						for (long p = 0; p < a_PM; ++p) {
+							double const* path = a_paths + p * a_L;
+							double pv = a_DFs[p] * m_option->Payoff(a_L, path, a_ts);
+							m_sum  	+= pv;
+							m_sum2 	+= pv * pv;
+							m_sumDF += a_DFs[p];
+							m_sumDF2 += a_DFs[p] * a_DFs[p];
+						}
+						m_P += a_PM;
+					}
+
+					// GetPx returns E[DF * Payoff]
+					double GetPx() const {
+						if (m_P < 2)
+							throw std::runtime_error("empty OPPathEval");
+
+						return m_sum / double(m_P);
+					}
+
+					// GetStats returns StD[DF * Payoff], E[DF] (the MC price of the
+					// zero-coupon bond of ccy B to the expiry) and StD[DF]:
+					std::tuple<double, double, double> GetStats() const {
+						if (m_P < 2)
+							throw std::runtime_error("empty OPPathEval");
+
+						double px  = m_sum / double(m_P);
+						double var = (m_sum2 - double(m_P) * px * px) / double(m_P - 1);
+						double zcb = m_sumDF / double(m_P);
+						double varDF =
+							(m_sumDF2 - double(m_P) * zcb * zcb) / double(m_P - 1);
+						return std::make_tuple(sqrt(std::max<double>(var, 0.0)), zcb,
+																	 sqrt(std::max<double>(varDF, 0.0)));
+					}
+			};
+
+			Diffusion1D 	const* const m_diff;
+			RateDiffusion const* const m_rateDiff;
+			double 						 	 const m_rho;
+			AProvider 								 m_irpA;
+			MCEngine2F<Diffusion1D, RateDiffusion, AProvider, AssetClassA,
+								 AssetClassB, OPPathEval>
+																 m_mce;
+			bool 											 m_useTimerSeed;
+
+		public:
+			// non-default constructor ("a_rho": correlation of S and r; the
+			// engine holds "a_maxPM" paths of up to "a_maxL" points in memory):
+			MCOptionPricer2F
+			(
+				Diffusion1D 	const* a_diff,
+				RateDiffusion const* a_rateDiff,
+				double 							 a_rho,
+				const char* 				 a_irsFileA,
+				bool 								 a_useTimerSeed,
+				long 								 a_maxL  = 102'271,
+				long 								 a_maxPM = 4096
+			)
+			: m_diff				(a_diff),
+				m_rateDiff		(a_rateDiff),
+				m_rho 				(a_rho),
+				m_irpA				(a_irsFileA),
+				m_mce 				(a_maxL, a_maxPM),
+																// (5-min points in 1y) * 4k pats by default
+				m_useTimerSeed(a_useTimerSeed)
+			{
+				assert(m_diff != nullptr && m_rateDiff != nullptr);
+				if (!(m_rho >= -1.0 && m_rho <= 1.0))
+					throw std::invalid_argument("invalid correlation");
+			}
+
+			// The pricing function: returns (Px, StD of the discounted payoff,
+			// MC price of the ccy B zero-coupon bond to the expiry, StD of the
+			// pathwise DF):
+			std::tuple<double, double, double, double> Px
+			(
+				// Instrument spec:
+				Option<AssetClassA, AssetClassB> const* a_option,
+				//pricing time
+				time_t a_t0,
+				//MC params
+				int  	 a_tauMins = 15, // by default
+				long 	 a_P = 100'000
+			);
+	};
+}
@@ -0,0 +1,50 @@
+//==========================================================================//
+//                           "MCOptionPricer2F.hpp"                         //
+// Implementation of "Px" method for option pricing with stochastic rates   //
+//==========================================================================//
+
+#pragma once
+
+#include "MCOptionPricer2F.h"
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// MCOptionPricer2F::Px"                                                  //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D, typename RateDiffusion, typename AProvider,
+		typename AssetClassA, typename AssetClassB
+	>
+	std::tuple<double, double, double, double>
+	MCOptionPricer2F<Diffusion1D, RateDiffusion, AProvider,
+									 AssetClassA, AssetClassB>::
+	Px
+	(
+		Option<AssetClassA, AssetClassB> const* a_option,
+		time_t a_t0,
+		int 	 a_tauMins,
+		long 	 a_P
+	)
+	{
+		assert(a_option != nullptr && a_tauMins > 0 && a_P > 0);
+
+		if (a_option->m_isAmerican)
+			throw std::invalid_argument("MC cannot price American options");
+
+		// Path Evaluator:
+		OPPathEval pathEval(a_option);
+
+		// run MC: Option pricing is Risk-Neutral; the payoffs are discounted
+		// pathwise, so no DF is applied here:
+		m_mce.template Simulate<true>
+		(a_t0, a_option->m_expirTime, a_tauMins, a_P, m_useTimerSeed, m_diff,
+		 m_rateDiff, m_rho, &m_irpA, a_option->m_assetA, a_option->m_assetB,
+		 &pathEval);
+
+		double px = pathEval.GetPx();
+		auto [stD, zcb, stDDF] = pathEval.GetStats();
+		return std::make_tuple(px, stD, zcb, stDDF);
+	}
+}
@@ -0,0 +1,124 @@
+//==========================================================================//
+//                              "MCOptionPricerND.h"                        //
+// Declaration of "MCOptionPricerND" class: MC pricing of multi-asset       //
+// (Basket, Spread, Best-Of) options by "MCEngineND"                        //
+//==========================================================================//
+
+#pragma once
+
+#include "MCEngineND.hpp"
+#include "OptionND.h"
+
+#include <cmath>
+#include <cassert>
+#include <tuple>
+#include <algorithm>
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// "MCOptionPricerND:"                                                    //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D, typename AProvider, typename BProvider,
+		typename AssetClassA, typename AssetClassB
+	>
+	class MCOptionPricerND {
+		private:
+			// Path Evaluator for option pricing
+			class OPPathEval {
+				private:
+					OptionND<AssetClassA, AssetClassB>
+					const* const  m_option;
+					long 					m_P;   	 // Total path evaluator
+					double 				m_sum; 	 // sum of payoffs
+					double 				m_sum2;  // sum of payoffs^2
+
+				public:
+					OPPathEval(OptionND<AssetClassA, AssetClassB> const* a_option)
+					: m_option(a_option),
+					  m_P		 (0),
+					  m_sum	 (0),
+					  m_sum2 (0)
+					{assert(m_option != nullptr);}
+
+					void operator() (long a_L, long a_PM,
+													 double const* a_paths, double const* a_ts)
+					{
+						long LN = a_L * m_option->m_N;
+						for (long p = 0; p < a_PM; ++p) {
+							double payOff = m_option->Payoff(a_L, a_paths + p * LN, a_ts);
+							m_sum  += payOff;
+							m_sum2 += payOff * payOff;
+						}
+						m_P += a_PM;
+					}
+
+					// GetPx returns E[PayOff]
+					double GetPx() const {
+						if (m_P < 2)
+							throw std::runtime_error("empty OPPathEval");
+
+						return m_sum / double(m_P);
+					}
+
+					// GetStD returns StD[PayOff]
+					double GetStD() const {
+						if (m_P < 2)
+							throw std::runtime_error("empty OPPathEval");
+
+						double px  = m_sum / double(m_P);
+						double var = (m_sum2 - double(m_P) * px * px) / double(m_P - 1);
+						return sqrt(std::max<double>(var, 0.0));
+					}
+			};
+
+			int 											 const m_N;
+			Diffusion1D const* const*  const m_diffs; // [N]
+			AProvider 											 m_irpA;
+			BProvider 											 m_irpB;
+			MCEngineND<Diffusion1D, AProvider, BProvider, AssetClassA,
+								 AssetClassB, OPPathEval>
+																			 m_mce;
+			bool 														 m_useTimerSeed;
+
+		public:
+			// non-default constructor ("a_diffs": [N], the diffusions are not
+			// owned; "a_corr": N * N correlations of their Brownian motions; the
+			// engine holds "a_maxL" * "a_maxPM" points in memory):
+			MCOptionPricerND
+			(
+				int 												a_N,
+				Diffusion1D const* const* 	a_diffs,
+				double const* 							a_corr,
+				const char* 								a_irsFileA,
+				const char* 								a_irsFileB,
+				bool 												a_useTimerSeed,
+				long 												a_maxL  = 102'271,
+				long 												a_maxPM = 4096
+			)
+			: m_N 					(a_N),
+				m_diffs 			(a_diffs),
+				m_irpA				(a_irsFileA),
+				m_irpB				(a_irsFileB),
+				m_mce 				(a_maxL, a_maxPM, a_N, a_corr),
+																// (5-min points in 1y) * 4k pats by default
+				m_useTimerSeed(a_useTimerSeed)
+			{
+				assert(m_diffs != nullptr);
+			}
+
+			// The pricing function: returns (Px, StD of the discounted payoff):
+			std::tuple<double, double> Px
+			(
+				// Instrument spec:
+				OptionND<AssetClassA, AssetClassB> const* a_option,
+				//pricing time
+				time_t a_t0,
+				//MC params
+				int  	 a_tauMins = 15, // by default
+				long 	 a_P = 100'000
+			);
+	};
+}
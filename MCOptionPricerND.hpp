@@ -0,0 +1,51 @@
+//==========================================================================//
+//                           "MCOptionPricerND.hpp"                         //
+// Implementation of "Px" method for multi-asset option pricing             //
+//==========================================================================//
+
+#pragma once
+
+#include "MCOptionPricerND.h"
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// MCOptionPricerND::Px"                                                  //
+	//------------------------------------------------------------------------//
+	template
+	<
+		typename Diffusion1D, typename AProvider, typename BProvider,
+		typename AssetClassA, typename AssetClassB
+	>
+	std::tuple<double, double>
+	MCOptionPricerND<Diffusion1D, AProvider, BProvider,
+									 AssetClassA, AssetClassB>::
+	Px
+	(
+		OptionND<AssetClassA, AssetClassB> const* a_option,
+		time_t a_t0,
+		int 	 a_tauMins,
+		long 	 a_P
+	)
+	{
+		assert(a_option != nullptr && a_tauMins > 0 && a_P > 0);
+
+		if (a_option->m_isAmerican)
+			throw std::invalid_argument("MC cannot price American options");
+
+		if (a_option->m_N != m_N)
+			throw std::invalid_argument("option dims do not match the model");
+
+		// Path Evaluator:
+		OPPathEval pathEval(a_option);
+
+		// run MC: Option pricing is Risk-Neutral
+		m_mce.template Simulate<true>
+		(a_t0, a_option->m_expirTime, a_tauMins, a_P, m_useTimerSeed, m_diffs,
+		 &m_irpA, &m_irpB, a_option->m_assetsA, a_option->m_assetB, &pathEval);
+
+		// Apply the discount factor on B:
+		double df = m_irpB.DF(a_option->m_assetB, a_t0, a_option->m_expirTime);
+		return std::make_tuple(df * pathEval.GetPx(), df * pathEval.GetStD());
+	}
+}
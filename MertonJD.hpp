@@ -0,0 +1,75 @@
+//==========================================================================//
+//                                "MertonJD.hpp"                            //
+// Merton jump-diffusion prices of vanilla options (Poisson series of BSM)  //
+//--------------------------------------------------------------------------//
+// Given n jumps in [0, T], log S_T is normal with the variance             //
+// sigma^2 T + n sigmaJ^2 and E[S_T | n] = F e^{-lambda k T} (1 + k)^n,     //
+// k = E[e^J] - 1, so                                                       //
+//   px = Sum_n e^{-lambda T} (lambda T)^n / n! *                           //
+//        BSM(S0 e^{-lambda k T} (1 + k)^n, K, T, rA, rB, sigma_n),         //
+//   sigma_n^2 = sigma^2 + n sigmaJ^2 / T.                                  //
+// The series is summed until the remaining Poisson mass is negligible.     //
+// Used as the benchmark and the control variate of MC pricing of jumps     //
+//==========================================================================//
+
+#pragma once
+
+#include "BSM.hpp"
+#include "DiffusionMerton.h"
+
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// "MertonPx": Call or Put:                                               //
+	//------------------------------------------------------------------------//
+	inline double MertonPx(DiffusionMerton const& a_diff, bool a_isCall,
+						double a_K, double a_S0, double a_TTE, double a_rateA,
+						double a_rateB)
+	{
+		assert(a_S0 > 0 && a_K > 0 && a_diff.GetSigma() > 0);
+
+		if (a_TTE <= 0)
+			// return payoff:
+			return a_isCall ? std::max<double>(a_S0 - a_K, 0)
+											: std::max<double>(a_K - a_S0, 0);
+
+		constexpr double Eps 	= 1e-16; // last Poisson weight
+		constexpr int 	 MaxN = 1000;
+
+		double sigma 	= a_diff.GetSigma();
+		double sJ2 		= a_diff.GetSigmaJ() * a_diff.GetSigmaJ();
+		double k 			= a_diff.GetJumpComp();
+		double lT 		= a_diff.GetLambda() * a_TTE;
+		double Sn 		= a_S0 * exp(- lT * k); // "S0" of the n-th term
+		double wn 		= exp(- lT); 						// Poisson weight of n
+		double px 		= 0;
+
+		for (int n = 0; n < MaxN; ++n) {
+			double sn = sqrt(sigma * sigma + n * sJ2 / a_TTE);
+			px += wn * (a_isCall ? BSMPxCall(Sn, a_K, a_TTE, a_rateA, a_rateB, sn)
+													 : BSMPxPut (Sn, a_K, a_TTE, a_rateA, a_rateB, sn));
+			// (beyond 2 lambda T, the remaining mass is below 2 wn):
+			if (n >= 2.0 * lT && wn < Eps)
+				break;
+			wn *= lT / double(n + 1);
+			Sn *= 1.0 + k;
+		}
+		return px;
+	}
+
+	inline double MertonPxCall(DiffusionMerton const& a_diff, double a_K,
+						double a_S0, double a_TTE, double a_rateA, double a_rateB)
+	{
+		return MertonPx(a_diff, true, a_K, a_S0, a_TTE, a_rateA, a_rateB);
+	}
+
+	inline double MertonPxPut(DiffusionMerton const& a_diff, double a_K,
+						double a_S0, double a_TTE, double a_rateA, double a_rateB)
+	{
+		return MertonPx(a_diff, false, a_K, a_S0, a_TTE, a_rateA, a_rateB);
+	}
+}
@@ -0,0 +1,206 @@
+//==========================================================================//
+//                              "MkCurveStore.cpp"                          //
+// Offline converter of text rate files into binary CurveStore snapshots    //
+//--------------------------------------------------------------------------//
+// Accepts both text formats: "CCY rate" lines (const rates, as read by     //
+// IRPConst) and "BASE yyyy-mm-dd" with "CCY tenor rate" lines (zero rates, //
+// as read by IRPFwdCurve). Ccy codes are open-ended (up to 4 chars)        //
+//==========================================================================//
+
+#include "CurveStore.h"
+#include "IRProviderFwdCurve.h"
+#include "Time.h"
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+
+using namespace SiriusFM;
+using namespace std;
+
+int main(int argc, char** argv) {
+	if (argc != 3 && argc != 4) {
+		cerr << "PARAMS:\ntextRatesFile, binCurveStoreFile,\n[bucketDays=1]\n";
+		return 1;
+	}
+
+	char const* inFile 	= 			argv[1];
+	char const* outFile = 			argv[2];
+	double bucketDays 	= (argc == 4) ? atof(argv[3]) : 1.0;
+
+	assert(bucketDays > 0);
+
+	constexpr int BUF_SIZE 		= 128;
+	constexpr int MAX_CCYS 		= 4096;
+	constexpr int MAX_TENORS 	= 128; // per ccy
+
+	//------------------------------------------------------------------------//
+	// Parse the text file:                                                   //
+	//------------------------------------------------------------------------//
+	CcyID*  ccys = new CcyID[MAX_CCYS];
+	double* Ts 	 = new double[MAX_CCYS * MAX_TENORS];
+	double* Rs 	 = new double[MAX_CCYS * MAX_TENORS];
+	int* 		nTs  = new int[MAX_CCYS];
+	int 		nC 	 = 0;
+	double 	t0 	 = EPOCH_BEGIN; // YearFrac of the BASE date
+	bool 		hasBase 	= false;
+	bool 		hasTenors = false;
+
+	FILE* src = fopen(inFile, "r");
+	if (src == nullptr) {
+		cerr << "Cannot open " << inFile << endl;
+		return 1;
+	}
+
+	char buf[BUF_SIZE];
+	int  line = 0;
+
+	while (fgets(buf, BUF_SIZE, src) != nullptr) {
+		++line;
+		if (*buf == '\0' || *buf == '\n' || *buf == '#')
+			continue;
+
+		if (strncmp(buf, "BASE", 4) == 0) {
+			int y = 0, m = 0, d = 0;
+			if (sscanf(buf + 4, "%d-%d-%d", &y, &m, &d) != 3) {
+				cerr << "Line " << line << ": invalid BASE date" << endl;
+				return 1;
+			}
+			t0 			= YearFrac(MkDate(y, m, d));
+			hasBase = true;
+			continue;
+		}
+
+		char 	 code[8];
+		char 	 tenor[16];
+		double rate = 0;
+		double T 		= 1.0; // a const rate is a 1Y zero rate extrapolated flat
+		int 	 nf 	= sscanf(buf, "%7s %15s %lf", code, tenor, &rate);
+
+		if (nf == 3) {
+			int  n 		= 0;
+			char unit = '\0';
+			if (sscanf(tenor, "%d%c", &n, &unit) != 2 || n <= 0 ||
+					(T = TenorYears(n, unit)) <= 0)
+			{
+				cerr << "Line " << line << ": invalid tenor" << endl;
+				return 1;
+			}
+			hasTenors = true;
+		}
+		else if (nf == 2)
+			rate = atof(tenor);
+		else {
+			cerr << "Line " << line << ": invalid format" << endl;
+			return 1;
+		}
+
+		CcyID ccy = CcyID::UNDEFINED;
+		try {
+			ccy = MkCcyID(code);
+		}
+		catch (invalid_argument const& e) {
+			cerr << "Line " << line << ": " << e.what() << endl;
+			return 1;
+		}
+		int c = 0;
+		while (c < nC && ccys[c] != ccy)
+			++c;
+
+		if (c == nC) {
+			if (nC == MAX_CCYS) {
+				cerr << "Too many ccys" << endl;
+				return 1;
+			}
+			ccys[nC] = ccy;
+			nTs[nC++] = 0;
+		}
+		if (nTs[c] == MAX_TENORS) {
+			cerr << "Line " << line << ": too many tenors" << endl;
+			return 1;
+		}
+
+		// Insert in ascending order of tenors:
+		double* Tc = Ts + c * MAX_TENORS;
+		double* Rc = Rs + c * MAX_TENORS;
+		int i = nTs[c]++;
+		for (; i > 0 && Tc[i - 1] > T; --i) {
+			Tc[i] = Tc[i - 1];
+			Rc[i] = Rc[i - 1];
+		}
+		Tc[i] = T;
+		Rc[i] = rate;
+	}
+	fclose(src);
+
+	if (hasTenors && !hasBase) {
+		cerr << "No BASE date for the tenors" << endl;
+		return 1;
+	}
+
+	//------------------------------------------------------------------------//
+	// Build the snapshot:                                                    //
+	//------------------------------------------------------------------------//
+	double dt 	= bucketDays / AVG_DAYS_IN_YEAR;
+	double maxT = 0;
+	for (int c = 0; c < nC; ++c)
+		maxT = std::max<double>(maxT, Ts[c * MAX_TENORS + nTs[c] - 1]);
+
+	CurveStoreHdr hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.m_magic, CurveStoreMagic, sizeof(CurveStoreMagic));
+	hdr.m_nCcys  = uint32_t(nC);
+	hdr.m_nSlots = (nC == 0) ? 0 : 1;
+	while (hdr.m_nSlots < 2 * hdr.m_nCcys)
+		hdr.m_nSlots *= 2;
+	hdr.m_nB = uint32_t(ceil(maxT / dt)) + 1;
+	hdr.m_t0 = t0;
+	hdr.m_dt = dt;
+
+	CurveStoreSlot* slots = new CurveStoreSlot[hdr.m_nSlots];
+	memset(slots, 0, hdr.m_nSlots * sizeof(CurveStoreSlot));
+
+	for (int c = 0; c < nC; ++c) {
+		uint32_t s = CurveStoreHash(ccys[c], hdr.m_nSlots);
+		while (slots[s].m_id != uint32_t(CcyID::UNDEFINED))
+			s = (s + 1) & (hdr.m_nSlots - 1);
+		slots[s].m_id  = uint32_t(ccys[c]);
+		slots[s].m_idx = uint32_t(c);
+	}
+
+	double* curve = new double[2 * hdr.m_nB];
+
+	FILE* dst = fopen(outFile, "wb");
+	if (dst == nullptr) {
+		cerr << "Cannot open " << outFile << endl;
+		return 1;
+	}
+	bool ok = fwrite(&hdr, sizeof(hdr), 1, dst) == 1 &&
+						fwrite(slots, sizeof(CurveStoreSlot), hdr.m_nSlots, dst)
+							== hdr.m_nSlots;
+
+	for (int c = 0; c < nC && ok; ++c) {
+		MkBucketedCurve(Ts + c * MAX_TENORS, Rs + c * MAX_TENORS, nTs[c], dt,
+										int(hdr.m_nB), curve, curve + hdr.m_nB);
+		ok = fwrite(curve, sizeof(double), 2 * hdr.m_nB, dst) == 2 * hdr.m_nB;
+	}
+	ok = (fclose(dst) == 0) && ok;
+
+	if (!ok) {
+		cerr << "Cannot write " << outFile << endl;
+		return 1;
+	}
+	cout << nC << " ccys, " << hdr.m_nB << " buckets -> " << outFile << endl;
+
+	delete[] curve;
+	delete[] slots;
+	delete[] ccys;
+	delete[] Ts;
+	delete[] Rs;
+	delete[] nTs;
+	return 0;
+}
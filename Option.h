@@ -6,8 +6,12 @@
 #pragma once
 
 #include "IRProvider.h"
+#include "SpecHash.h"
 
 #include <ctime>
+#include <cmath>
+#include <algorithm>
+#include <vector>
 
 namespace SiriusFM {
 
@@ -41,7 +45,41 @@ namespace SiriusFM {
 			virtual double Payoff(long a_L, double const* a_path, 
 											double const* a_ts) const = 0;
 
+			// The same on a single-precision path (see "MCEngine1D"); by default,
+			// the path is widened to double first, into a per-thread buffer which
+			// is re-used across the calls (this is called once per MC path):
+			virtual double Payoff(long a_L, float const* a_path,
+														double const* a_ts) const
+			{
+				thread_local std::vector<double> path;
+				if (long(path.size()) < a_L)
+					path.resize(a_L);
+				std::copy(a_path, a_path + a_L, path.data());
+				return Payoff(a_L, path.data(), a_ts);
+			}
+
+			// The strike, around which the payoff is concentrated (the target of
+			// the importance sampling in "MCOptionPricer1D"); NaN if the option
+			// has no single one:
+			virtual double GetStrike() const {
+				return NAN;
+			}
+
+			// Feeds the canonical spec into "a_h" (the keys of "PxCache");
+			// returns false if the option does not support it, so that its
+			// prices are never cached:
+			virtual bool HashSpec(SpecHasher& a_h) const {
+				return false;
+			}
+
 			virtual ~Option() {};
+
+		protected:
+			// The common part of "HashSpec" overrides:
+			void HashBase(SpecHasher& a_h) const {
+				a_h.Add(m_assetA).Add(m_assetB).Add(int64_t(m_expirTime))
+					 .Add(m_isAmerican).Add(m_isAsian);
+			}
 	};
 
   //------------------------------------------------------------------------//
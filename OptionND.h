@@ -0,0 +1,68 @@
+//==========================================================================//
+//                               "OptionND.h"                               //
+// Declaration of fully-generic multi-asset "OptionND" class                //
+//--------------------------------------------------------------------------//
+// The underlyings are "m_N" pairs A_d/B (d = 0..N-1) with a common ccy B;  //
+// the paths of all of them are passed together, the N values at each time  //
+// point being contiguous:  a_paths[l * N + d]                              //
+//==========================================================================//
+
+#pragma once
+
+#include "IRProvider.h"
+
+#include <ctime>
+#include <stdexcept>
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// Fully-Generic "OptionND":                                              //
+	//------------------------------------------------------------------------//
+	template<typename AssetClassA, typename AssetClassB>
+	class OptionND {
+		public:
+			int 				const m_N; 			 // # of underlyings
+			AssetClassA* const m_assetsA; // [m_N]
+			AssetClassB const m_assetB;
+			time_t 			const m_expirTime;
+			bool 				const m_isAmerican;
+
+			OptionND
+			(
+				int 							 a_N,
+				AssetClassA const* a_assetsA,
+				AssetClassB 			 a_assetB,
+				time_t 						 a_expirTime,
+				bool 							 a_isAmerican
+			)
+			: m_N 				(a_N),
+				m_assetsA 	(new AssetClassA[a_N > 0 ? a_N : 1]),
+				m_assetB 		(a_assetB),
+				m_expirTime (a_expirTime),
+				m_isAmerican(a_isAmerican)
+			{
+				if (m_N <= 0 || a_assetsA == nullptr) {
+					delete[] m_assetsA;
+					throw std::invalid_argument("invalid underlyings");
+				}
+				for (int d = 0; d < m_N; ++d)
+					m_assetsA[d] = a_assetsA[d];
+			}
+
+			OptionND(OptionND const&) = delete;
+			OptionND& operator=(OptionND const&) = delete;
+
+			virtual double Payoff(long a_L, double const* a_paths,
+														double const* a_ts) const = 0;
+
+			virtual ~OptionND() {
+				delete[] m_assetsA;
+			}
+	};
+
+	//------------------------------------------------------------------------//
+	// Alias: "OptionNDFX":                                                   //
+	//------------------------------------------------------------------------//
+	using OptionNDFX = OptionND<CcyE, CcyE>;
+}
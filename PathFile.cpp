@@ -0,0 +1,214 @@
+//==========================================================================//
+//                                "PathFile.cpp"                            //
+// Writing of path files by "PathRecorder"; mapping and indexing of them by //
+// "PathReplay"                                                             //
+//==========================================================================//
+
+#include "PathFile.h"
+
+#include <cstring>
+#include <cassert>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace SiriusFM {
+
+	namespace {
+		constexpr size_t RecBufSize = 1 << 20;
+
+		// Size of a batch record, padding incl:
+		inline uint64_t BatchBytes(uint64_t a_L, uint64_t a_PM, uint32_t a_rs) {
+			uint64_t pathBytes = a_L * a_PM * a_rs;
+			return sizeof(PathBatchHdr) + a_L * sizeof(double) +
+						 ((pathBytes + 7) & ~uint64_t(7));
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// "PathRecorder":                                                        //
+	//------------------------------------------------------------------------//
+	PathRecorder::PathRecorder(char const* a_file, SpecKey a_spec)
+	: m_file 		(nullptr),
+		m_buf 		(nullptr),
+		m_realSize(0),
+		m_nBatches(0),
+		m_nPaths 	(0),
+		m_spec 		(a_spec)
+	{
+		if (a_file == nullptr)
+			throw std::invalid_argument("no path file");
+
+		m_file = fopen(a_file, "wb");
+		if (m_file == nullptr)
+			throw std::runtime_error("Cannot create path file");
+
+		m_buf = new char[RecBufSize];
+		setvbuf(m_file, m_buf, _IOFBF, RecBufSize);
+
+		// the header, with 0 batches for now:
+		PathFileHdr hdr{};
+		memcpy(hdr.m_magic, PathFileMagic, sizeof(PathFileMagic));
+		hdr.m_version = PathFileVersion;
+		hdr.m_spec 		= m_spec;
+		if (fwrite(&hdr, sizeof(hdr), 1, m_file) != 1) {
+			fclose(m_file);
+			delete[] m_buf;
+			throw std::runtime_error("Cannot write path file");
+		}
+	}
+
+	PathRecorder::~PathRecorder() {
+		if (m_file != nullptr) {
+			try {
+				Close();
+			}
+			catch (...) {}
+		}
+		delete[] m_buf;
+	}
+
+	void PathRecorder::WriteBatch
+	(
+		long 					a_L,
+		long 					a_PM,
+		void const* 	a_paths,
+		uint32_t 			a_realSize,
+		double const* a_ts
+	)
+	{
+		assert(a_L > 0 && a_PM > 0 && a_paths != nullptr && a_ts != nullptr);
+		if (m_file == nullptr)
+			throw std::runtime_error("PathRecorder is closed");
+		if (m_realSize == 0)
+			m_realSize = a_realSize;
+		else if (a_realSize != m_realSize)
+			throw std::invalid_argument("float and double paths in one file");
+
+		PathBatchHdr bh{a_L, a_PM};
+		size_t nPts 	 = size_t(a_L) * size_t(a_PM);
+		size_t padding = (8 - (nPts * a_realSize) % 8) % 8;
+		char const zeros[8] = {};
+
+		if (fwrite(&bh, sizeof(bh), 1, m_file) != 1 ||
+				fwrite(a_ts, sizeof(double), size_t(a_L), m_file) != size_t(a_L) ||
+				fwrite(a_paths, a_realSize, nPts, m_file) != nPts ||
+				fwrite(zeros, 1, padding, m_file) != padding)
+			throw std::runtime_error("Cannot write path file");
+
+		++m_nBatches;
+		m_nPaths += uint64_t(a_PM);
+	}
+
+	void PathRecorder::Close() {
+		if (m_file == nullptr)
+			return;
+
+		PathFileHdr hdr{};
+		memcpy(hdr.m_magic, PathFileMagic, sizeof(PathFileMagic));
+		hdr.m_version 	= PathFileVersion;
+		hdr.m_realSize 	= (m_realSize != 0) ? m_realSize : uint32_t(sizeof(double));
+		hdr.m_nBatches 	= m_nBatches;
+		hdr.m_nPaths 		= m_nPaths;
+		hdr.m_spec 			= m_spec;
+
+		bool ok = fflush(m_file) == 0 && fseek(m_file, 0, SEEK_SET) == 0 &&
+							fwrite(&hdr, sizeof(hdr), 1, m_file) == 1;
+		ok = (fclose(m_file) == 0) && ok;
+		m_file = nullptr;
+		if (!ok)
+			throw std::runtime_error("Cannot write path file");
+	}
+
+	//------------------------------------------------------------------------//
+	// "PathReplay":                                                          //
+	//------------------------------------------------------------------------//
+	PathReplay::PathReplay(char const* a_file)
+	: m_map (nullptr),
+		m_size(0),
+		m_hdr (nullptr),
+		m_offs(nullptr)
+	{
+		int fd = (a_file == nullptr) ? -1 : open(a_file, O_RDONLY);
+		if (fd < 0)
+			throw std::runtime_error("Cannot open path file");
+
+		struct stat st;
+		if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(PathFileHdr)) {
+			close(fd);
+			throw std::runtime_error("Invalid path file");
+		}
+		m_size = size_t(st.st_size);
+		m_map  = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd); 	// the mapping stays valid
+
+		if (m_map == MAP_FAILED) {
+			m_map = nullptr;
+			throw std::runtime_error("Cannot mmap path file");
+		}
+
+		auto fail = [this]() {
+			munmap(const_cast<void*>(m_map), m_size);
+			delete[] m_offs;
+			throw std::runtime_error("Invalid path file");
+		};
+
+		m_hdr = static_cast<PathFileHdr const*>(m_map);
+		if (memcmp(m_hdr->m_magic, PathFileMagic, sizeof(PathFileMagic)) != 0
+				|| m_hdr->m_version != PathFileVersion
+				|| (m_hdr->m_realSize != 4 && m_hdr->m_realSize != 8)
+				// (a batch takes more than 16 bytes):
+				|| m_hdr->m_nBatches > m_size / 16)
+			fail();
+
+		// index the batches, checking that they exactly fill the file:
+		uint64_t nB = m_hdr->m_nBatches;
+		uint64_t nP = 0;
+		m_offs 			= new uint64_t[nB + 1];
+		m_offs[0] 	= sizeof(PathFileHdr);
+		for (uint64_t i = 0; i < nB; ++i) {
+			uint64_t off = m_offs[i];
+			if (off + sizeof(PathBatchHdr) > m_size)
+				fail();
+			PathBatchHdr const* bh = reinterpret_cast<PathBatchHdr const*>
+				(static_cast<char const*>(m_map) + off);
+			// (a path point takes at least 4 bytes):
+			if (bh->m_L < 2 || bh->m_PM < 1 || uint64_t(bh->m_L) > m_size ||
+					uint64_t(bh->m_PM) > m_size / 4 / uint64_t(bh->m_L))
+				fail();
+			uint64_t len = BatchBytes(uint64_t(bh->m_L), uint64_t(bh->m_PM),
+																m_hdr->m_realSize);
+			if (len > m_size - off)
+				fail();
+			m_offs[i + 1] = off + len;
+			nP += uint64_t(bh->m_PM);
+		}
+		if (m_offs[nB] != m_size || nP != m_hdr->m_nPaths)
+			fail();
+
+		// the batches are read in order, once per "Replay":
+		madvise(const_cast<void*>(m_map), m_size, MADV_SEQUENTIAL);
+	}
+
+	PathReplay::~PathReplay() {
+		if (m_map != nullptr)
+			munmap(const_cast<void*>(m_map), m_size);
+		delete[] m_offs;
+	}
+
+	void PathReplay::CheckRealSize(uint32_t a_realSize) const {
+		if (a_realSize != m_hdr->m_realSize)
+			throw std::invalid_argument("path file of another precision");
+	}
+
+	void PathReplay::Prefetch(long a_i) const {
+		// (madvise needs a page-aligned start):
+		uintptr_t pg 	= uintptr_t(sysconf(_SC_PAGESIZE));
+		uintptr_t beg = uintptr_t(m_map) + m_offs[a_i];
+		uintptr_t end = uintptr_t(m_map) + m_offs[a_i + 1];
+		beg &= ~(pg - 1);
+		madvise(reinterpret_cast<void*>(beg), end - beg, MADV_WILLNEED);
+	}
+}
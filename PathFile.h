@@ -0,0 +1,176 @@
+//==========================================================================//
+//                                 "PathFile.h"                             //
+// Recording of MC path batches to a binary file ("PathRecorder"), and      //
+// their zero-copy replay from a memory mapping of it ("PathReplay")        //
+//--------------------------------------------------------------------------//
+// "PathRecorder" is a "PathEvaluator": run "MCEngine1D::Simulate" with it  //
+// once, and the recorded scenarios can then be fed by "PathReplay" to any  //
+// number of other evaluators (payoffs, hedging policies), each of them     //
+// getting exactly the batches the engine has produced, as pointers into    //
+// the mapped file. Layout (all fields native-endian, 8-byte aligned):      //
+// * PathFileHdr;                                                           //
+// * for each batch: PathBatchHdr, double ts[m_L], Real paths[m_L * m_PM]   //
+//   (as passed to the evaluator), zero-padded to a multiple of 8 bytes     //
+// "m_nBatches" in the header is only written by "PathRecorder::Close", so  //
+// an unfinished recording is rejected by "PathReplay"                      //
+//==========================================================================//
+
+#pragma once
+
+#include "SpecHash.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <tuple>
+
+namespace SiriusFM {
+
+	constexpr char PathFileMagic[8] = {'S', 'F', 'M', 'P', 'T', 'H', '0', '1'};
+
+	constexpr uint32_t PathFileVersion = 1;
+
+	struct PathFileHdr {
+		char 		 m_magic[8];
+		uint32_t m_version;
+		uint32_t m_realSize; 	// of the path points: 4 (float) or 8 (double)
+		uint64_t m_nBatches;
+		uint64_t m_nPaths; 		// over all batches
+		SpecKey  m_spec; 			// of the scenarios (optional, user-defined)
+	};
+
+	struct PathBatchHdr {
+		int64_t m_L; 		// points per path
+		int64_t m_PM; 	// paths in the batch
+	};
+
+	//------------------------------------------------------------------------//
+	// "PathRecorder":                                                        //
+	//------------------------------------------------------------------------//
+	class PathRecorder {
+		private:
+			FILE* 		m_file;
+			char* 		m_buf; 			// of the FILE (large, as writes are sequential)
+			uint32_t 	m_realSize; // 0 until the 1st batch
+			uint64_t 	m_nBatches;
+			uint64_t 	m_nPaths;
+			SpecKey 	m_spec;
+
+			void WriteBatch(long a_L, long a_PM, void const* a_paths,
+											uint32_t a_realSize, double const* a_ts);
+
+		public:
+			// "a_spec" (eg the key of the diffusion, rates, t0 and the engine
+			// params) is stored for the replay to check against:
+			explicit PathRecorder
+			(
+				char const* a_file,
+				SpecKey 		a_spec = SpecKey{0, 0}
+			);
+
+			// Closes the file if "Close" has not been called (ignoring errors):
+			~PathRecorder();
+
+			PathRecorder(PathRecorder const&) = delete;
+			PathRecorder& operator=(PathRecorder const&) = delete;
+
+			// The "PathEvaluator" call, on double or float paths (all batches
+			// of a file must be of the same type):
+			template<typename Real>
+			void operator()(long a_L, long a_PM, Real const* a_paths,
+											double const* a_ts)
+			{
+				static_assert(sizeof(Real) == 4 || sizeof(Real) == 8,
+											"float or double paths only");
+				WriteBatch(a_L, a_PM, a_paths, uint32_t(sizeof(Real)), a_ts);
+			}
+
+			// Completes the header and closes the file:
+			void Close();
+
+			uint64_t GetNBatches() const {
+				return m_nBatches;
+			}
+
+			uint64_t GetNPaths() const {
+				return m_nPaths;
+			}
+	};
+
+	//------------------------------------------------------------------------//
+	// "PathReplay":                                                          //
+	//------------------------------------------------------------------------//
+	// The file is mapped read-only and indexed once (by the batch headers);  //
+	// "Replay" is sequential, with the kernel readahead hinted accordingly,  //
+	// and prefetches the next batch while the current one is evaluated. It   //
+	// is const, so one "PathReplay" can feed several threads at a time:      //
+	//------------------------------------------------------------------------//
+	class PathReplay {
+		private:
+			void const* 				m_map;
+			size_t 							m_size;
+			PathFileHdr const* 	m_hdr;
+			uint64_t* 					m_offs; 	// of the batches, [m_nBatches + 1]
+
+			// Checks that the file is of "Real" paths:
+			void CheckRealSize(uint32_t a_realSize) const;
+
+			// Hints the kernel to read batch "a_i" in:
+			void Prefetch(long a_i) const;
+
+		public:
+			explicit PathReplay(char const* a_file);
+			~PathReplay();
+
+			PathReplay(PathReplay const&) = delete;
+			PathReplay& operator=(PathReplay const&) = delete;
+
+			long GetNBatches() const {
+				return long(m_hdr->m_nBatches);
+			}
+
+			long GetNPaths() const {
+				return long(m_hdr->m_nPaths);
+			}
+
+			int GetRealSize() const {
+				return int(m_hdr->m_realSize);
+			}
+
+			SpecKey GetSpec() const {
+				return m_hdr->m_spec;
+			}
+
+			// Batch "a_i": (L, PM, paths, ts), pointing into the mapping:
+			template<typename Real>
+			std::tuple<long, long, Real const*, double const*> GetBatch(long a_i)
+				const
+			{
+				CheckRealSize(uint32_t(sizeof(Real)));
+				if (a_i < 0 || a_i >= GetNBatches())
+					throw std::invalid_argument("invalid batch #");
+
+				char const* 				p 	= static_cast<char const*>(m_map) +
+																	m_offs[a_i];
+				PathBatchHdr const* bh 	= reinterpret_cast<PathBatchHdr const*>(p);
+				double const* 			ts 	= reinterpret_cast<double const*>(bh + 1);
+				return std::make_tuple(long(bh->m_L), long(bh->m_PM),
+															 reinterpret_cast<Real const*>(ts + bh->m_L), ts);
+			}
+
+			// Feeds all batches, in order, to "a_eval" (which is called as by
+			// "MCEngine1D" of "Real" paths):
+			template<typename Real, typename PathEvaluator>
+			void Replay(PathEvaluator* a_eval) const {
+				CheckRealSize(uint32_t(sizeof(Real)));
+				long nB = GetNBatches();
+				for (long i = 0; i < nB; ++i) {
+					if (i + 1 < nB)
+						Prefetch(i + 1);
+					auto b = GetBatch<Real>(i);
+					(*a_eval)(std::get<0>(b), std::get<1>(b), std::get<2>(b),
+										std::get<3>(b));
+				}
+			}
+	};
+}
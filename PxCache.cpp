@@ -0,0 +1,266 @@
+//==========================================================================//
+//                                 "PxCache.cpp"                            //
+// The LRU list and the memory-mapped store of "PxCache"                    //
+//==========================================================================//
+
+#include "PxCache.h"
+
+#include <stdexcept>
+#include <cstring>
+#include <cassert>
+#include <atomic>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// Ctor: opens or creates the store:                                      //
+	//------------------------------------------------------------------------//
+	PxCache::PxCache
+	(
+		long 				a_maxEntries,
+		char const* a_storeFile,
+		long 				a_storeSlots
+	)
+	: m_maxN 	(a_maxEntries),
+		m_nodes (new Node[(a_maxEntries > 0) ? a_maxEntries : 1]),
+		m_n 		(0),
+		m_head 	(-1),
+		m_tail 	(-1),
+		m_index (),
+		m_fd 		(-1),
+		m_map 	(nullptr),
+		m_size 	(0),
+		m_hdr 	(nullptr),
+		m_slots (nullptr),
+		m_stats {}
+	{
+		if (m_maxN <= 0 || a_storeSlots <= 0 || a_storeSlots > (1L << 31)) {
+			delete[] m_nodes;
+			throw std::invalid_argument("invalid PxCache size");
+		}
+		m_index.reserve(size_t(m_maxN));
+
+		if (a_storeFile == nullptr)
+			return;
+
+		m_fd = open(a_storeFile, O_RDWR | O_CREAT, 0644);
+		if (m_fd < 0) {
+			delete[] m_nodes;
+			throw std::runtime_error("Cannot open PxCache store");
+		}
+
+		auto fail = [this](char const* a_msg) {
+			if (m_map != nullptr)
+				munmap(m_map, m_size);
+			close(m_fd);
+			delete[] m_nodes;
+			throw std::runtime_error(a_msg);
+		};
+
+		if (flock(m_fd, LOCK_EX | LOCK_NB) != 0)
+			fail("PxCache store is in use");
+
+		struct stat st;
+		if (fstat(m_fd, &st) != 0)
+			fail("Cannot stat PxCache store");
+
+		bool isNew = (st.st_size == 0);
+		if (isNew) {
+			uint32_t nSlots = 1;
+			while (long(nSlots) < a_storeSlots)
+				nSlots <<= 1;
+			m_size = sizeof(PxStoreHdr) + size_t(nSlots) * sizeof(PxStoreSlot);
+			// (the new file is all zeros, ie all slots are empty):
+			if (ftruncate(m_fd, off_t(m_size)) != 0)
+				fail("Cannot size PxCache store");
+		}
+		else
+			m_size = size_t(st.st_size);
+
+		if (m_size < sizeof(PxStoreHdr))
+			fail("Invalid PxCache store");
+
+		m_map = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd,
+								 0);
+		if (m_map == MAP_FAILED) {
+			m_map = nullptr;
+			fail("Cannot mmap PxCache store");
+		}
+
+		m_hdr 	= static_cast<PxStoreHdr*>(m_map);
+		m_slots = reinterpret_cast<PxStoreSlot*>(m_hdr + 1);
+
+		if (isNew) {
+			memcpy(m_hdr->m_magic, PxStoreMagic, sizeof(PxStoreMagic));
+			m_hdr->m_nSlots = uint32_t((m_size - sizeof(PxStoreHdr)) /
+																 sizeof(PxStoreSlot));
+			m_hdr->m_nUsed 	= 0;
+		}
+		else if (memcmp(m_hdr->m_magic, PxStoreMagic, sizeof(PxStoreMagic)) != 0
+						 || m_hdr->m_nSlots == 0
+						 || (m_hdr->m_nSlots & (m_hdr->m_nSlots - 1)) != 0
+						 || m_size != sizeof(PxStoreHdr) +
+													size_t(m_hdr->m_nSlots) * sizeof(PxStoreSlot)
+						 || m_hdr->m_nUsed > m_hdr->m_nSlots)
+			fail("Invalid PxCache store");
+	}
+
+	//------------------------------------------------------------------------//
+	// Dtor:                                                                  //
+	//------------------------------------------------------------------------//
+	PxCache::~PxCache() {
+		if (m_map != nullptr) {
+			msync(m_map, m_size, MS_SYNC);
+			munmap(m_map, m_size);
+		}
+		if (m_fd >= 0)
+			close(m_fd); // (which releases the lock)
+		delete[] m_nodes;
+	}
+
+	//------------------------------------------------------------------------//
+	// The LRU list:                                                          //
+	//------------------------------------------------------------------------//
+	void PxCache::Unlink(long a_i) {
+		Node& nd = m_nodes[a_i];
+		if (nd.m_prev >= 0)
+			m_nodes[nd.m_prev].m_next = nd.m_next;
+		else
+			m_head = nd.m_next;
+		if (nd.m_next >= 0)
+			m_nodes[nd.m_next].m_prev = nd.m_prev;
+		else
+			m_tail = nd.m_prev;
+	}
+
+	void PxCache::PushFront(long a_i) {
+		Node& nd = m_nodes[a_i];
+		nd.m_prev = -1;
+		nd.m_next = m_head;
+		if (m_head >= 0)
+			m_nodes[m_head].m_prev = a_i;
+		m_head = a_i;
+		if (m_tail < 0)
+			m_tail = a_i;
+	}
+
+	void PxCache::PutMem(SpecKey const& a_key, PxVal const& a_val) {
+		auto it = m_index.find(a_key);
+		if (it != m_index.end()) {
+			m_nodes[it->second].m_val = a_val;
+			Unlink(it->second);
+			PushFront(it->second);
+			return;
+		}
+
+		long i;
+		if (m_n < m_maxN)
+			i = m_n++;
+		else {
+			// evict the LRU entry and re-use its node:
+			i = m_tail;
+			Unlink(i);
+			m_index.erase(m_nodes[i].m_key);
+			++m_stats.m_evictions;
+		}
+		m_nodes[i].m_key = a_key;
+		m_nodes[i].m_val = a_val;
+		PushFront(i);
+		m_index.emplace(a_key, i);
+	}
+
+	//------------------------------------------------------------------------//
+	// "FindSlot": linear probing (the table is never more than 3/4 full, so  //
+	// there is an empty slot, unless the file has been tampered with: then   //
+	// NULL is returned):                                                     //
+	//------------------------------------------------------------------------//
+	PxStoreSlot* PxCache::FindSlot(SpecKey const& a_key) const {
+		uint32_t mask = m_hdr->m_nSlots - 1;
+		uint32_t s 		= uint32_t(a_key.m_h1) & mask;
+		for (uint32_t n = 0; n < m_hdr->m_nSlots; ++n, s = (s + 1) & mask) {
+			PxStoreSlot* slot = m_slots + s;
+			if (slot->m_key == a_key || slot->m_key.IsEmpty())
+				return slot;
+		}
+		return nullptr;
+	}
+
+	//------------------------------------------------------------------------//
+	// "Get", "Put":                                                          //
+	//------------------------------------------------------------------------//
+	bool PxCache::Get(SpecKey const& a_key, PxVal* a_val) {
+		assert(a_val != nullptr && !a_key.IsEmpty());
+		std::lock_guard<std::mutex> lock(m_mtx);
+
+		auto it = m_index.find(a_key);
+		if (it != m_index.end()) {
+			long i = it->second;
+			*a_val = m_nodes[i].m_val;
+			Unlink(i);
+			PushFront(i);
+			++m_stats.m_memHits;
+			return true;
+		}
+
+		if (m_hdr != nullptr) {
+			PxStoreSlot const* slot = FindSlot(a_key);
+			if (slot != nullptr && !slot->m_key.IsEmpty()) {
+				*a_val = slot->m_val;
+				PutMem(a_key, *a_val);
+				++m_stats.m_storeHits;
+				return true;
+			}
+		}
+		++m_stats.m_misses;
+		return false;
+	}
+
+	void PxCache::Put(SpecKey const& a_key, PxVal const& a_val) {
+		assert(!a_key.IsEmpty());
+		std::lock_guard<std::mutex> lock(m_mtx);
+
+		PutMem(a_key, a_val);
+		++m_stats.m_puts;
+
+		if (m_hdr == nullptr)
+			return;
+
+		PxStoreSlot* slot = FindSlot(a_key);
+		if (slot == nullptr || slot->m_key.IsEmpty()) {
+			if (slot == nullptr ||
+					4 * (m_hdr->m_nUsed + 1) > 3 * uint64_t(m_hdr->m_nSlots))
+			{
+				++m_stats.m_storeFull;
+				return;
+			}
+			++m_hdr->m_nUsed;
+		}
+		// the value goes first, so that a slot with a key is never partially
+		// written (as seen by a later run, should this one be killed):
+		slot->m_val = a_val;
+		std::atomic_signal_fence(std::memory_order_release);
+		slot->m_key = a_key;
+	}
+
+	void PxCache::Sync() {
+		std::lock_guard<std::mutex> lock(m_mtx);
+		if (m_map != nullptr)
+			msync(m_map, m_size, MS_SYNC);
+	}
+
+	PxCacheStats PxCache::GetStats() const {
+		std::lock_guard<std::mutex> lock(m_mtx);
+		return m_stats;
+	}
+
+	void PxCache::ResetStats() {
+		std::lock_guard<std::mutex> lock(m_mtx);
+		m_stats = PxCacheStats{};
+	}
+}
@@ -0,0 +1,197 @@
+//==========================================================================//
+//                                  "PxCache.h"                             //
+// Memoization of pricing results: an in-memory LRU, optionally backed by a //
+// persistent memory-mapped store                                           //
+//--------------------------------------------------------------------------//
+// The results are keyed by "SpecKey"s of all pricing inputs: the option    //
+// spec ("Option::HashSpec"), the diffusion params ("HashDiffusion"), the   //
+// contents of the rate files ("HashRates"), t0 and the engine params. The  //
+// pricers ("MCOptionPricer1D", "GridNOP1D_S3_RKC1::RunBwdBatch") look the  //
+// key up first when a cache is attached to them; MC prices are only cached //
+// with the fixed seed, so that a hit returns exactly what a re-run would.  //
+// "Get" looks in the LRU first, then in the store (a hit there is copied   //
+// into the LRU); "Put" writes to both. The store is an open-addressing     //
+// table of fixed-size slots in a file (see "PxStoreHdr"), mapped shared    //
+// read-write and locked by "flock", so it is used by one process at a time //
+// and survives across runs; it is never evicted from, and once it is 3/4   //
+// full, new results are kept in the LRU only. All methods are thread-safe  //
+//==========================================================================//
+
+#pragma once
+
+#include "SpecHash.h"
+#include "DiffusionTraits.h"
+
+#include <cstdint>
+#include <cmath>
+#include <mutex>
+#include <ostream>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// "PxVal": a cached result (NaN for the fields which do not apply):      //
+	//------------------------------------------------------------------------//
+	struct PxVal {
+		double m_px;
+		double m_delta;
+		double m_gamma;
+		double m_stdErr;
+	};
+
+	//------------------------------------------------------------------------//
+	// The store file: PxStoreHdr, then PxStoreSlot[m_nSlots] (empty slots    //
+	// have the empty key); native-endian, 8-byte aligned:                    //
+	//------------------------------------------------------------------------//
+	constexpr char PxStoreMagic[8] = {'S', 'F', 'M', 'P', 'X', 'C', '0', '1'};
+
+	struct PxStoreHdr {
+		char 		 m_magic[8];
+		uint32_t m_nSlots; 	 // power of 2
+		uint32_t m_reserved;
+		uint64_t m_nUsed;
+	};
+
+	struct PxStoreSlot {
+		SpecKey m_key;
+		PxVal 	m_val;
+	};
+
+	//------------------------------------------------------------------------//
+	// "PxCacheStats":                                                        //
+	//------------------------------------------------------------------------//
+	struct PxCacheStats {
+		uint64_t m_memHits;
+		uint64_t m_storeHits;
+		uint64_t m_misses;
+		uint64_t m_puts;
+		uint64_t m_evictions; 	// from the LRU
+		uint64_t m_storeFull; 	// results not written to the full store
+
+		double HitRate() const {
+			uint64_t n = m_memHits + m_storeHits + m_misses;
+			return (n == 0) ? 0.0 : double(m_memHits + m_storeHits) / double(n);
+		}
+	};
+
+	inline void PrintPxCacheStats(std::ostream& a_os, PxCacheStats const& a_st)
+	{
+		a_os << "PxCache: hit rate " << a_st.HitRate()
+				 << " (mem hits: " 	<< a_st.m_memHits
+				 << ", store hits: " << a_st.m_storeHits
+				 << ", misses: " 		<< a_st.m_misses
+				 << "), puts: " 		<< a_st.m_puts
+				 << ", evictions: " << a_st.m_evictions
+				 << ", store full: " << a_st.m_storeFull << "\n";
+	}
+
+	//------------------------------------------------------------------------//
+	// "PxCache":                                                             //
+	//------------------------------------------------------------------------//
+	class PxCache {
+		private:
+			// LRU entries, in a doubly-linked list from the MRU ("m_head") to
+			// the LRU ("m_tail") one by the indices in "m_nodes":
+			struct Node {
+				SpecKey m_key;
+				PxVal 	m_val;
+				long 		m_prev;
+				long 		m_next;
+			};
+
+			struct KeyHash {
+				size_t operator()(SpecKey const& a_key) const {
+					return size_t(a_key.m_h0);
+				}
+			};
+
+			long const 	m_maxN;
+			Node* const m_nodes;
+			long 				m_n;
+			long 				m_head;
+			long 				m_tail;
+			std::unordered_map<SpecKey, long, KeyHash> m_index;
+
+			// The store (if any):
+			int 					m_fd;
+			void* 				m_map;
+			size_t 				m_size;
+			PxStoreHdr* 	m_hdr;
+			PxStoreSlot* 	m_slots;
+
+			PxCacheStats 	m_stats;
+			mutable std::mutex m_mtx;
+
+			void Unlink(long a_i);
+			void PushFront(long a_i);
+			void PutMem(SpecKey const& a_key, PxVal const& a_val);
+
+			// The store slot of "a_key", or the empty one where it would go:
+			PxStoreSlot* FindSlot(SpecKey const& a_key) const;
+
+		public:
+			// "a_maxEntries" in the LRU; the store is opened (or created with
+			// "a_storeSlots", rounded up to a power of 2) if "a_storeFile" is
+			// not NULL:
+			PxCache
+			(
+				long 				a_maxEntries = 65536,
+				char const* a_storeFile  = nullptr,
+				long 				a_storeSlots = 1L << 20
+			);
+
+			~PxCache();
+
+			PxCache(PxCache const&) = delete;
+			PxCache& operator=(PxCache const&) = delete;
+
+			// Returns true and the result in "a_val" on a hit:
+			bool Get(SpecKey const& a_key, PxVal* a_val);
+
+			void Put(SpecKey const& a_key, PxVal const& a_val);
+
+			// Flushes the store to the file (it is also flushed by the Dtor):
+			void Sync();
+
+			PxCacheStats GetStats() const;
+			void ResetStats();
+	};
+
+	//------------------------------------------------------------------------//
+	// "HashDiffusion": the type and the params of a diffusion which affect   //
+	// RN prices: S0 and the vol params, unless the diffusion provides its    //
+	// own "HashSpec". The rule for the keys is the same either way: a param  //
+	// goes in iff the RN measure keeps it. So a drift rate does not (it is   //
+	// replaced by the RN one), but the speed and level of a mean reversion   //
+	// do, as they are model params rather than rates. Returns false if the   //
+	// diffusion provides neither "HashSpec" nor the vol params: then there   //
+	// is no key, and its prices are not cached:                              //
+	//------------------------------------------------------------------------//
+	template<typename Diffusion1D>
+	inline bool HashDiffusion(SpecHasher& a_h, Diffusion1D const& a_diff) {
+		a_h.Add(typeid(Diffusion1D).name());
+		if constexpr (HasSpecHash<Diffusion1D>::value)
+			a_diff.HashSpec(a_h);
+		else if constexpr (HasVolParams<Diffusion1D>::value) {
+			double ps[Diffusion1D::NVolParams];
+			a_diff.GetVolParams(ps);
+			a_h.Add(ps, Diffusion1D::NVolParams).Add(a_diff.GetS0());
+		}
+		else
+			return false;
+		return true;
+	}
+
+	//------------------------------------------------------------------------//
+	// "HashRates": the providers` types and the contents of their files:     //
+	//------------------------------------------------------------------------//
+	template<typename AProvider, typename BProvider>
+	inline SpecKey HashRates(char const* a_fileA, char const* a_fileB) {
+		SpecHasher h;
+		h.Add(typeid(AProvider).name()).Add(HashFile(a_fileA))
+		 .Add(typeid(BProvider).name()).Add(HashFile(a_fileB));
+		return h.GetKey();
+	}
+}
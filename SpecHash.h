@@ -0,0 +1,172 @@
+//==========================================================================//
+//                                 "SpecHash.h"                             //
+// Canonical 128-bit hashing of pricing inputs (option specs, diffusion     //
+// params, rate files, engine params), used as the keys of "PxCache"        //
+//--------------------------------------------------------------------------//
+// The inputs are fed to "SpecHasher" field by field, each one in its       //
+// canonical form: integers as int64, doubles with -0 mapped to +0 and all  //
+// NaNs to one NaN, strings and byte blocks with their lengths, so equal    //
+// inputs give equal keys however they were produced. The two 64-bit lanes  //
+// are independent multiply-rotate chains with different seeds, finalized   //
+// by the "splitmix64" mixer; it is not a cryptographic hash (the inputs    //
+// are not adversarial), but 128 bits make accidental collisions negligible //
+//==========================================================================//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+namespace SiriusFM {
+
+	//------------------------------------------------------------------------//
+	// "SpecKey": the resulting key ({0, 0} is reserved as "no key"):         //
+	//------------------------------------------------------------------------//
+	struct SpecKey {
+		uint64_t m_h0;
+		uint64_t m_h1;
+
+		bool operator==(SpecKey const& a_right) const {
+			return m_h0 == a_right.m_h0 && m_h1 == a_right.m_h1;
+		}
+
+		bool operator!=(SpecKey const& a_right) const {
+			return !(*this == a_right);
+		}
+
+		bool IsEmpty() const {
+			return m_h0 == 0 && m_h1 == 0;
+		}
+	};
+
+	//------------------------------------------------------------------------//
+	// "SpecHasher":                                                          //
+	//------------------------------------------------------------------------//
+	class SpecHasher {
+		private:
+			static constexpr uint64_t K0 = 0x9E3779B97F4A7C15ULL;
+			static constexpr uint64_t K1 = 0xC2B2AE3D27D4EB4FULL;
+
+			uint64_t m_h0;
+			uint64_t m_h1;
+			uint64_t m_n; 	// # of words fed in
+
+			static uint64_t Rotl(uint64_t a_x, int a_r) {
+				return (a_x << a_r) | (a_x >> (64 - a_r));
+			}
+
+			static uint64_t Mix(uint64_t a_x) { // "splitmix64" finalizer
+				a_x ^= a_x >> 30;
+				a_x *= 0xBF58476D1CE4E5B9ULL;
+				a_x ^= a_x >> 27;
+				a_x *= 0x94D049BB133111EBULL;
+				a_x ^= a_x >> 31;
+				return a_x;
+			}
+
+			void AddWord(uint64_t a_w) {
+				m_h0 = Rotl(m_h0 ^ (a_w * K0), 31) * K1;
+				m_h1 = Rotl(m_h1 ^ (a_w * K1), 29) * K0 + 0x165667B19E3779F9ULL;
+				++m_n;
+			}
+
+		public:
+			SpecHasher()
+			: m_h0(0x243F6A8885A308D3ULL),
+				m_h1(0x13198A2E03707344ULL),
+				m_n (0)
+			{}
+
+			// Any integer or enum (eg an asset class):
+			template
+			<
+				typename I,
+				typename = std::enable_if_t<std::is_integral_v<I> || std::is_enum_v<I>>
+			>
+			SpecHasher& Add(I a_x) {
+				AddWord(uint64_t(int64_t(a_x)));
+				return *this;
+			}
+
+			SpecHasher& Add(double a_x) {
+				if (a_x == 0)
+					a_x = 0.0; 	// -0 -> +0
+				else if (std::isnan(a_x))
+					a_x = NAN;
+				uint64_t w;
+				memcpy(&w, &a_x, sizeof(w));
+				AddWord(w);
+				return *this;
+			}
+
+			SpecHasher& Add(char const* a_str) {
+				return AddBytes(a_str, (a_str == nullptr) ? 0 : strlen(a_str));
+			}
+
+			SpecHasher& AddBytes(void const* a_data, size_t a_n) {
+				AddWord(uint64_t(a_n));
+				unsigned char const* p = static_cast<unsigned char const*>(a_data);
+				size_t i = 0;
+				for (; i + 8 <= a_n; i += 8) {
+					uint64_t w;
+					memcpy(&w, p + i, 8);
+					AddWord(w);
+				}
+				if (i < a_n) {
+					uint64_t w = 0;
+					memcpy(&w, p + i, a_n - i);
+					AddWord(w);
+				}
+				return *this;
+			}
+
+			// A key of other inputs (eg of a file):
+			SpecHasher& Add(SpecKey const& a_key) {
+				AddWord(a_key.m_h0);
+				AddWord(a_key.m_h1);
+				return *this;
+			}
+
+			// Doubles one by one (so each of them is canonical):
+			SpecHasher& Add(double const* a_xs, long a_n) {
+				Add(int64_t(a_n));
+				for (long i = 0; i < a_n; ++i)
+					Add(a_xs[i]);
+				return *this;
+			}
+
+			SpecKey GetKey() const {
+				SpecKey key{Mix(m_h0 ^ m_n), Mix(m_h1 + Rotl(m_n, 32))};
+				if (key.IsEmpty())
+					key.m_h1 = 1;
+				return key;
+			}
+	};
+
+	//------------------------------------------------------------------------//
+	// "HashFile": the key of the contents of a file (eg of the rates; NULL   //
+	// or "" is an empty file, as some IRProviders accept it):                //
+	//------------------------------------------------------------------------//
+	inline SpecKey HashFile(char const* a_file) {
+		SpecHasher h;
+		if (a_file == nullptr || *a_file == '\0')
+			return h.AddBytes(nullptr, 0).GetKey();
+
+		FILE* src = fopen(a_file, "rb");
+		if (src == nullptr)
+			throw std::runtime_error("Cannot open file");
+
+		constexpr size_t BUF_SIZE = 65536;
+		char* 	buf = new char[BUF_SIZE];
+		size_t 	n 	= 0;
+		while ((n = fread(buf, 1, BUF_SIZE, src)) > 0)
+			h.AddBytes(buf, n);
+		delete[] buf;
+		fclose(src);
+		return h.GetKey();
+	}
+}
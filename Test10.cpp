@@ -0,0 +1,116 @@
+//==========================================================================//
+//                               "Test10.cpp"                               //
+// Testing "MkDupireLVs" and "DiffusionLocalVol": local vols from implied   //
+// vols, and the MC prices of the quotes on them against BSM                //
+//--------------------------------------------------------------------------//
+// The quotes are USD/RUB IVs of 3 expiries (T/4, T/2, T) x 9 strikes (60%  //
+// to 140% of S0), IV(K) = IV0 + skew * log(K / S0). With no skew, all the  //
+// local vols must be IV0 exactly; either way the MC Calls of the last      //
+// expiry (80%, 100% and 120% strikes) must reproduce the BSM prices of     //
+// their implied vols                                                       //
+//==========================================================================//
+
+#include "DiffusionLocalVol.h"
+#include "DupireLV.hpp"
+#include "VanillaOption.h"
+#include "MCOptionPricer1D.hpp"
+#include "IRProviderConst.h"
+#include "BSM.hpp"
+
+#include <iostream>
+#include <vector>
+
+using namespace SiriusFM;
+using namespace std;
+
+int main(int argc, char** argv) {
+
+	if (argc != 8) {
+		cerr << "PARAMS:\nIV0, skew,\nS0, Tdays,\ntauMins, P,\nratesFile\n";
+		return 1;
+	}
+
+	double 			IV0 			= atof(argv[1]);
+	double 			skew 			= atof(argv[2]);
+	double 			S0 				= atof(argv[3]);
+	long 				Tdays 		= atol(argv[4]);
+	int 				tauMins 	= atoi(argv[5]);
+	long 				P 				= atol(argv[6]);
+	char const* ratesFile = 			argv[7];
+
+	if (IV0 <= 0 || S0 <= 0 || Tdays < 4 || tauMins <= 0 || P <= 0)
+		throw invalid_argument("invalid params");
+
+	CcyE 	 ccyA = CcyE::USD;
+	CcyE 	 ccyB = CcyE::RUB;
+	time_t t0 	= MkDate(2024, 1, 1);
+	time_t T 		= t0 + SEC_IN_DAY * Tdays;
+	double TTE 	= YearFracInt(T - t0);
+	IRPConst irp(ratesFile);
+	double rA 	= irp.r(ccyA, 0.0);
+	double rB 	= irp.r(ccyB, 0.0);
+	bool 	 ok 	= true;
+	cout.precision(10);
+
+	// The IV quotes:
+	constexpr int NK = 9;
+	constexpr int NT = 3;
+	double Ks[NK], TTEs[NT], IVs[NT * NK];
+	for (int i = 0; i < NK; ++i)
+		Ks[i] = S0 * (0.6 + 0.1 * i);
+	for (int j = 0; j < NT; ++j) {
+		TTEs[j] = TTE * double(1 << j) / 4.0;
+		for (int i = 0; i < NK; ++i)
+			IVs[j * NK + i] = IV0 + skew * log(Ks[i] / S0);
+	}
+
+	// The local vol table:
+	constexpr int NX = 200;
+	constexpr int NTL = 50;
+	double SMin = S0 / 5.0;
+	double SMax = S0 * 5.0;
+	vector<double> lvs(NX * NTL);
+	MkDupireLVs(S0, rA, rB, NK, Ks, NT, TTEs, IVs, SMin, SMax, NX, TTE, NTL,
+							lvs.data());
+
+	if (skew == 0) {
+		double maxErr = 0;
+		for (double lv: lvs)
+			maxErr = max<double>(maxErr, fabs(lv - IV0));
+		bool okF = maxErr <= 1e-12;
+		cout << "Flat IV: max |LV - IV0| = " << maxErr << (okF ? "" : "  FAIL")
+				 << endl;
+		ok = ok && okF;
+	}
+
+	// MC on the local vols (the engine holds just the paths of this test):
+	DiffusionLocalVol diff(0.0, S0, t0, SMin, SMax, NX, TTE, NTL, lvs.data());
+	using Eval = MCOptionPricer1D<DiffusionLocalVol, IRPConst, IRPConst, CcyE,
+																CcyE>::OPPathEval;
+	long L = (SEC_IN_DAY * Tdays) / (SEC_IN_MIN * tauMins) + 2;
+	MCEngine1D<DiffusionLocalVol, IRPConst, IRPConst, CcyE, CcyE, Eval>
+		mce(L, 8192);
+	double df = irp.DF(ccyB, t0, T);
+
+	for (int i = 2; i <= 6; i += 2) {
+		CallOptionFX call(ccyA, ccyB, Ks[i], T, false);
+		Eval eval(&call);
+		mce.Simulate<true>(t0, T, tauMins, P, false, &diff, &irp, &irp, ccyA,
+											 ccyB, &eval);
+
+		// (the StdErr is of i.i.d. paths, which is conservative with the
+		// antithetic ones):
+		double px 		= df * eval.GetPx();
+		double stdErr = df * get<0>(eval.GetStats()) / sqrt(2.0 * double(P));
+		double ref 		= BSMPxCall(S0, Ks[i], TTE, rA, rB, IVs[(NT - 1) * NK + i]);
+		double d 			= px - ref;
+		bool 	 okK 		= fabs(d) <= 4.0 * stdErr;
+		cout << "K = " << Ks[i] << ": MC = " << px << ", BSM = " << ref
+				 << ", diff = " << d << " (" << d / stdErr << " StdErr)"
+				 << (okK ? "" : "  FAIL") << endl;
+		ok = ok && okK;
+	}
+
+	cout << (ok ? "OK" : "FAILED") << endl;
+	return ok ? 0 : 1;
+}
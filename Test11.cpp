@@ -0,0 +1,90 @@
+//==========================================================================//
+//                               "Test11.cpp"                               //
+// Testing "MertonJD.hpp" and the jumps of "MCEngine1D": the series prices  //
+// of Merton jump-diffusion options against the MC ones                     //
+//--------------------------------------------------------------------------//
+// The options are USD/RUB (at the rates of the IRs file): the 80% Put and  //
+// the 100% and 120% Calls. With lambda = 0 the series is BSM, so a run     //
+// without jumps checks the continuous part on its own                      //
+//==========================================================================//
+
+#include "DiffusionMerton.h"
+#include "MertonJD.hpp"
+#include "VanillaOption.h"
+#include "MCOptionPricer1D.hpp"
+#include "IRProviderConst.h"
+
+#include <iostream>
+
+using namespace SiriusFM;
+using namespace std;
+
+int main(int argc, char** argv) {
+
+	if (argc != 10) {
+		cerr << "PARAMS:\nsigma, lambda, muJ, sigmaJ,\nS0, Tdays,\ntauMins, P,"
+						"\nratesFile\n";
+		return 1;
+	}
+
+	double 			sigma 		= atof(argv[1]);
+	double 			lambda 		= atof(argv[2]);
+	double 			muJ 			= atof(argv[3]);
+	double 			sigmaJ 		= atof(argv[4]);
+	double 			S0 				= atof(argv[5]);
+	long 				Tdays 		= atol(argv[6]);
+	int 				tauMins 	= atoi(argv[7]);
+	long 				P 				= atol(argv[8]);
+	char const* ratesFile = 			argv[9];
+
+	if (sigma <= 0 || S0 <= 0 || Tdays <= 0 || tauMins <= 0 || P <= 0)
+		throw invalid_argument("invalid params");
+
+	// (the trend is irrelevant here):
+	DiffusionMerton diff(0.0, sigma, lambda, muJ, sigmaJ, S0);
+	IRPConst 				irp(ratesFile);
+	CcyE 						ccyA = CcyE::USD;
+	CcyE 						ccyB = CcyE::RUB;
+	time_t 					t0 	 = MkDate(2024, 1, 1);
+	time_t 					T 	 = t0 + SEC_IN_DAY * Tdays;
+	double 					TTE  = YearFracInt(T - t0);
+	double 					rA 	 = irp.r(ccyA, 0.0);
+	double 					rB 	 = irp.r(ccyB, 0.0);
+	double 					df 	 = irp.DF(ccyB, t0, T);
+
+	// the engine holds just the paths of this test:
+	using Eval = MCOptionPricer1D<DiffusionMerton, IRPConst, IRPConst, CcyE,
+																CcyE>::OPPathEval;
+	long L = (SEC_IN_DAY * Tdays) / (SEC_IN_MIN * tauMins) + 2;
+	MCEngine1D<DiffusionMerton, IRPConst, IRPConst, CcyE, CcyE, Eval>
+		mce(L, 8192);
+
+	constexpr int NK 		 = 3;
+	double 				Ks[NK] = {0.8 * S0, S0, 1.2 * S0};
+	bool 					isCall[NK] = {false, true, true};
+	bool 					ok = true;
+	cout.precision(10);
+
+	for (int j = 0; j < NK; ++j) {
+		CallOptionFX call(ccyA, ccyB, Ks[j], T, false);
+		PutOptionFX  put (ccyA, ccyB, Ks[j], T, false);
+		Eval eval(isCall[j] ? static_cast<OptionFX const*>(&call) : &put);
+		mce.Simulate<true>(t0, T, tauMins, P, false, &diff, &irp, &irp, ccyA,
+											 ccyB, &eval);
+
+		// (the StdErr is of i.i.d. paths, which is conservative with the
+		// antithetic ones):
+		double px 		= df * eval.GetPx();
+		double stdErr = df * get<0>(eval.GetStats()) / sqrt(2.0 * double(P));
+		double ref 		= MertonPx(diff, isCall[j], Ks[j], S0, TTE, rA, rB);
+		double d 			= px - ref;
+		bool 	 okK 		= fabs(d) <= 4.0 * stdErr;
+		cout << (isCall[j] ? "Call" : "Put ") << " K = " << Ks[j] << ": MC = "
+				 << px << ", series = " << ref << ", diff = " << d << " ("
+				 << d / stdErr << " StdErr)" << (okK ? "" : "  FAIL") << endl;
+		ok = ok && okK;
+	}
+
+	cout << (ok ? "OK" : "FAILED") << endl;
+	return ok ? 0 : 1;
+}
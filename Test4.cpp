@@ -11,9 +11,9 @@ using namespace SiriusFM;
 using namespace std;
 
 int main(int argc, char** argv) {
-	if(argc != 10) {
+	if(argc != 10 && argc != 11) {
 		cerr << "params: mu, sigma, S0,\nCall/Put, K, Tdays,\ndeltaAcc" 
-																													"\ntau_mins, P\n";
+											"\ntau_mins, P\n[nProducers (0: not pipelined)]\n";
 		return 1;
 	}
 
@@ -26,6 +26,7 @@ int main(int argc, char** argv) {
 	double 			deltaAcc = atof(argv[7]);
 	int 				tau_mins = atoi(argv[8]);
 	long 				P 			 = atol(argv[9]);
+	int 				nProd 	 = (argc == 11) ? atoi(argv[10]) : 0;
 
 	assert(sigma > 0 && S0 > 0 && T_days > 0 
 						&& tau_mins > 0 && P > 0 && K > 0);
@@ -42,6 +43,7 @@ int main(int argc, char** argv) {
 	// The following Hedger is for FX (CcyE / CcyE):
 	MCOptionHedger1D<decltype(diff), IRPConst, IRPConst, CcyE, CcyE> 
 		hedger(&diff, ratesFileA, ratesFileB, useTimerSeed);
+	hedger.SetPipeline(nProd);
 
 	// Create the Option spec:
 	time_t t0 = time(nullptr);   		  		// abs start time
@@ -104,6 +106,7 @@ int main(int argc, char** argv) {
   
 	cout << "E[PnL] = " << EPnL << ", StD[PnL] = " << StDPnL << ", Max[Pnl] = " 
 									<< maxPnL << ", Min[PnL] = " << minPnL << endl; 
+	PrintMCPipelineStats(cout, hedger.GetPipelineStats());
 	delete opt;
 	return 0;
 }
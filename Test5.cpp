@@ -32,7 +32,7 @@ int main(int argc, char** argv) {
 	int tauMins 					= 		 atoi(argv[9]);
 
 	assert(sigma > 0 && S0 > 0 && Tdays > 0 
-						&& tau_mins > 0 && NS > 0);
+						&& tauMins > 0 && NS > 0);
 
 	CcyE ccyA = CcyE::USD;
 	CcyE ccyB = CcyE::RUB;
@@ -0,0 +1,137 @@
+//==========================================================================//
+//                               "Test6.cpp"                                //
+// Testing "MCOptionPricer2F": the MC zero-coupon bond of ccy B against the //
+// Vasicek / CIR closed forms, and the discounted spot against its forward  //
+//--------------------------------------------------------------------------//
+// The spot is GBM (20% vol) from 100, ccy A is USD at the rate of the IRs  //
+// file; a Call struck far below the spot pays DF * (S_T - K) on all paths, //
+// so E[DF S_T] = Px + K * ZCB(MC), which must be S0 exp(-rA T) for any rho //
+//==========================================================================//
+
+#include "DiffusionGBM.h"
+#include "DiffusionVasicek.h"
+#include "DiffusionCIR.h"
+#include "VanillaOption.h"
+#include "MCOptionPricer2F.hpp"
+#include "IRProviderConst.h"
+
+#include <iostream>
+#include <cstring>
+
+using namespace SiriusFM;
+using namespace std;
+
+namespace {
+	//------------------------------------------------------------------------//
+	// Closed-form ZCB prices (maturity "a_T" in years):                      //
+	//------------------------------------------------------------------------//
+	double ZCBVasicek(double a_kappa, double a_theta, double a_sigma,
+										double a_r0, double a_T)
+	{
+		double B 	 = (1.0 - exp(-a_kappa * a_T)) / a_kappa;
+		double s2  = a_sigma * a_sigma;
+		double lnA = (a_theta - 0.5 * s2 / (a_kappa * a_kappa)) * (B - a_T)
+								 - 0.25 * s2 * B * B / a_kappa;
+		return exp(lnA - B * a_r0);
+	}
+
+	double ZCBCIR(double a_kappa, double a_theta, double a_sigma, double a_r0,
+								double a_T)
+	{
+		double h 	 = sqrt(a_kappa * a_kappa + 2.0 * a_sigma * a_sigma);
+		double e 	 = exp(h * a_T) - 1.0;
+		double den = (h + a_kappa) * e + 2.0 * h;
+		double B 	 = 2.0 * e / den;
+		double A 	 = pow(2.0 * h * exp(0.5 * (a_kappa + h) * a_T) / den,
+									 2.0 * a_kappa * a_theta / (a_sigma * a_sigma));
+		return A * exp(-B * a_r0);
+	}
+
+	//------------------------------------------------------------------------//
+	// "Check": prints the MC and reference values; true if they agree to     //
+	// "a_nErr" StdErrs:                                                      //
+	//------------------------------------------------------------------------//
+	bool Check(char const* a_name, double a_mc, double a_ref, double a_stdErr,
+						 double a_nErr)
+	{
+		double diff = a_mc - a_ref;
+		bool 	 ok 	= fabs(diff) <= a_nErr * a_stdErr;
+		cout << a_name << ": MC = " << a_mc << ", ref = " << a_ref
+				 << ", diff = " << diff << " (" << diff / a_stdErr << " StdErr)"
+				 << (ok ? "" : "  FAIL") << endl;
+		return ok;
+	}
+
+	template<typename RateDiffusion>
+	bool Run(RateDiffusion const& a_rateDiff, double a_zcbRef, double a_rho,
+					 char const* a_ratesFile, long a_Tdays, int a_tauMins, long a_P)
+	{
+		constexpr double S0 = 100.0;
+		constexpr double K 	= 1.0; // (S_T < K has a negligible probability)
+		DiffusionGBM diff(0.0, 0.2, S0); // (the trend is irrelevant here)
+
+		time_t t0 = MkDate(2024, 1, 1);
+		time_t T 	= t0 + SEC_IN_DAY * a_Tdays;
+		CallOptionFX call(CcyE::USD, CcyE::RUB, K, T, false);
+
+		// the engine holds just the paths of this test:
+		long L = (SEC_IN_DAY * a_Tdays) / (SEC_IN_MIN * a_tauMins) + 2;
+		MCOptionPricer2F<DiffusionGBM, RateDiffusion, IRPConst, CcyE, CcyE>
+			pricer(&diff, &a_rateDiff, a_rho, a_ratesFile, false, L, 4096);
+
+		auto [px, stD, zcb, stDDF] = pricer.Px(&call, t0, a_tauMins, a_P);
+
+		// (the StdErrs are of i.i.d. paths, which is conservative with the
+		// antithetic ones):
+		double sqrtP = sqrt(2.0 * double(a_P));
+		IRPConst irp(a_ratesFile);
+		double 	 fwd = S0 * exp(-irp.r(CcyE::USD, 0.0) * YearFracInt(T - t0));
+
+		bool ok = Check("ZCB", zcb, a_zcbRef, stDDF / sqrtP, 4.0);
+		ok 			= Check("DF * S_T", px + K * zcb, fwd, stD / sqrtP, 4.0) && ok;
+		return ok;
+	}
+}
+
+int main(int argc, char** argv) {
+
+	if (argc != 11) {
+		cerr << "PARAMS:\n{Vasicek/CIR}, kappa, theta, sigmaR, r0,\nrho, Tdays, "
+						"tauMins, P,\nratesFile\n";
+		return 1;
+	}
+
+	char const* model 		= 			argv[1];
+	double 			kappa 		= atof(argv[2]);
+	double 			theta 		= atof(argv[3]);
+	double 			sigmaR 		= atof(argv[4]);
+	double 			r0 				= atof(argv[5]);
+	double 			rho 			= atof(argv[6]);
+	long 				Tdays 		= atol(argv[7]);
+	int 				tauMins 	= atoi(argv[8]);
+	long 				P 				= atol(argv[9]);
+	char const* ratesFile = 			argv[10];
+
+	if (kappa <= 0 || sigmaR <= 0 || Tdays <= 0 || tauMins <= 0 || P <= 0)
+		throw invalid_argument("invalid params");
+
+	cout.precision(8);
+	double T  = YearFracInt(SEC_IN_DAY * Tdays);
+	bool 	 ok = false;
+
+	if (strcmp(model, "Vasicek") == 0)
+		ok = Run(DiffusionVasicek(kappa, theta, sigmaR, r0),
+						 ZCBVasicek(kappa, theta, sigmaR, r0, T), rho, ratesFile, Tdays,
+						 tauMins, P);
+
+	else if (strcmp(model, "CIR") == 0)
+		ok = Run(DiffusionCIR(kappa, theta, sigmaR, r0),
+						 ZCBCIR(kappa, theta, sigmaR, r0, T), rho, ratesFile, Tdays,
+						 tauMins, P);
+
+	else
+		throw invalid_argument("Bad rate model");
+
+	cout << (ok ? "OK" : "FAILED") << endl;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+//==========================================================================//
+//                               "Test7.cpp"                                //
+// Testing "MCOptionPricerND": the exchange option (a Spread Call with K=0) //
+// on 2 correlated GBMs against the Margrabe formula                        //
+//--------------------------------------------------------------------------//
+// The assets are USD/RUB and EUR/RUB (at the rates of the IRs file); with  //
+// S_1 as the numeraire, Margrabe is the BSM Call on S_0 / S_1 with K = 1,  //
+// the ccy A rates of the two assets and the vol of the ratio               //
+//==========================================================================//
+
+#include "DiffusionGBM.h"
+#include "BasketOptions.h"
+#include "MCOptionPricerND.hpp"
+#include "IRProviderConst.h"
+#include "BSM.hpp"
+
+#include <iostream>
+
+using namespace SiriusFM;
+using namespace std;
+
+int main(int argc, char** argv) {
+
+	if (argc != 10) {
+		cerr << "PARAMS:\nsigma0, sigma1, rho,\nS0_0, S0_1, Tdays,\ntauMins, P,"
+						"\nratesFile\n";
+		return 1;
+	}
+
+	double 			sigma0 		= atof(argv[1]);
+	double 			sigma1 		= atof(argv[2]);
+	double 			rho 			= atof(argv[3]);
+	double 			S00 			= atof(argv[4]);
+	double 			S01 			= atof(argv[5]);
+	long 				Tdays 		= atol(argv[6]);
+	int 				tauMins 	= atoi(argv[7]);
+	long 				P 				= atol(argv[8]);
+	char const* ratesFile = 			argv[9];
+
+	if (sigma0 <= 0 || sigma1 <= 0 || !(rho > -1.0 && rho < 1.0) || S00 <= 0
+			|| S01 <= 0 || Tdays <= 0 || tauMins <= 0 || P <= 0)
+		throw invalid_argument("invalid params");
+
+	CcyE ccysA[2] = {CcyE::USD, CcyE::EUR};
+	CcyE ccyB 		= CcyE::RUB;
+
+	// (the trends are irrelevant here):
+	DiffusionGBM diff0(0.0, sigma0, S00);
+	DiffusionGBM diff1(0.0, sigma1, S01);
+	DiffusionGBM const* diffs[2] = {&diff0, &diff1};
+	double corr[4] = {1.0, rho, rho, 1.0};
+
+	time_t t0 = MkDate(2024, 1, 1);
+	time_t T 	= t0 + SEC_IN_DAY * Tdays;
+	SpreadOptionFX exch(ccysA, ccyB, 0.0, true, T);
+
+	// the engine holds just the paths of this test:
+	long L = (SEC_IN_DAY * Tdays) / (SEC_IN_MIN * tauMins) + 2;
+	MCOptionPricerND<DiffusionGBM, IRPConst, IRPConst, CcyE, CcyE>
+		pricer(2, diffs, corr, ratesFile, ratesFile, false, L, 4096);
+
+	auto [px, stD] = pricer.Px(&exch, t0, tauMins, P);
+
+	IRPConst irp(ratesFile);
+	double 	 TTE 	 = YearFracInt(T - t0);
+	double 	 sigma = sqrt(sigma0 * sigma0 + sigma1 * sigma1
+											- 2.0 * rho * sigma0 * sigma1);
+	double 	 ref 	 = BSMPxCall(S00, S01, TTE, irp.r(ccysA[0], 0.0),
+														 irp.r(ccysA[1], 0.0), sigma);
+
+	// (the StdErr is of i.i.d. paths, which is conservative with the
+	// antithetic ones):
+	double stdErr = stD / sqrt(2.0 * double(P));
+	double diff 	= px - ref;
+	bool 	 ok 		= fabs(diff) <= 4.0 * stdErr;
+
+	cout.precision(8);
+	cout << "Exchange: MC = " << px << ", Margrabe = " << ref << ", diff = "
+			 << diff << " (" << diff / stdErr << " StdErr)" << endl;
+	cout << (ok ? "OK" : "FAILED") << endl;
+	return ok ? 0 : 1;
+}
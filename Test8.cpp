@@ -0,0 +1,106 @@
+//==========================================================================//
+//                               "Test8.cpp"                                //
+// Testing "HestonCF" and the QE stepping of "DiffusionHeston": the CF      //
+// price of a published reference case, and the CF prices of a strike       //
+// ladder against the MC ones of "MCEngine1D"                               //
+//--------------------------------------------------------------------------//
+// The reference is the ATM 1y Call of Fang & Oosterlee (2008), at zero     //
+// rates: kappa 1.5768, theta 0.0398, xi 0.5751, rho -0.5711, v0 0.0175,    //
+// S0 = K = 100: 5.785155450. The ladder (K = 80%, 100%, 120% of S0) is of  //
+// the USD/RUB Calls, at the rates of the IRs file                          //
+//==========================================================================//
+
+#include "DiffusionHeston.h"
+#include "HestonCF.hpp"
+#include "VanillaOption.h"
+#include "MCOptionPricer1D.hpp"
+#include "IRProviderConst.h"
+
+#include <iostream>
+
+using namespace SiriusFM;
+using namespace std;
+
+int main(int argc, char** argv) {
+
+	if (argc != 11) {
+		cerr << "PARAMS:\nkappa, theta, xi, rho, v0,\nS0, Tdays,\ntauMins, P,"
+						"\nratesFile\n";
+		return 1;
+	}
+
+	double 			kappa 		= atof(argv[1]);
+	double 			theta 		= atof(argv[2]);
+	double 			xi 				= atof(argv[3]);
+	double 			rho 			= atof(argv[4]);
+	double 			v0 				= atof(argv[5]);
+	double 			S0 				= atof(argv[6]);
+	long 				Tdays 		= atol(argv[7]);
+	int 				tauMins 	= atoi(argv[8]);
+	long 				P 				= atol(argv[9]);
+	char const* ratesFile = 			argv[10];
+
+	if (S0 <= 0 || Tdays <= 0 || tauMins <= 0 || P <= 0)
+		throw invalid_argument("invalid params");
+
+	cout.precision(10);
+	bool ok = true;
+
+	// The published reference (the quadrature is not exact to all its
+	// digits, so to 1e-7):
+	{
+		DiffusionHeston ref(0.0, 1.5768, 0.0398, 0.5751, -0.5711, 0.0175, 100.0);
+		double px 	= HestonPx(ref, true, 100.0, 100.0, 1.0, 0.0, 0.0);
+		double diff = px - 5.785155450;
+		bool 	 okR 	= fabs(diff) <= 1e-7;
+		cout << "CF reference: Px = " << px << ", ref = 5.785155450, diff = "
+				 << diff << (okR ? "" : "  FAIL") << endl;
+		ok = ok && okR;
+	}
+
+	// The ladder, by the CF and by MC:
+	DiffusionHeston diff(0.0, kappa, theta, xi, rho, v0, S0);
+	IRPConst 				irp(ratesFile);
+	CcyE 						ccyA = CcyE::USD;
+	CcyE 						ccyB = CcyE::RUB;
+	time_t 					t0 	 = MkDate(2024, 1, 1);
+	time_t 					T 	 = t0 + SEC_IN_DAY * Tdays;
+	double 					TTE  = YearFracInt(T - t0);
+	double 					rA 	 = irp.r(ccyA, 0.0);
+	double 					rB 	 = irp.r(ccyB, 0.0);
+	double 					df 	 = irp.DF(ccyB, t0, T);
+
+	constexpr int NK 		 = 3;
+	double 				Ks[NK] = {0.8 * S0, S0, 1.2 * S0};
+	bool 					isCall[NK] = {true, true, true};
+	double 				pxsCF[NK];
+	HestonPxBatch(diff, NK, isCall, Ks, S0, TTE, rA, rB, pxsCF);
+
+	// the engine holds just the paths of this test:
+	using Eval = MCOptionPricer1D<DiffusionHeston, IRPConst, IRPConst, CcyE,
+																CcyE>::OPPathEval;
+	long L = (SEC_IN_DAY * Tdays) / (SEC_IN_MIN * tauMins) + 2;
+	MCEngine1D<DiffusionHeston, IRPConst, IRPConst, CcyE, CcyE, Eval>
+		mce(L, 8192);
+
+	for (int j = 0; j < NK; ++j) {
+		CallOptionFX call(ccyA, ccyB, Ks[j], T, false);
+		Eval eval(&call);
+		mce.Simulate<true>(t0, T, tauMins, P, false, &diff, &irp, &irp, ccyA,
+											 ccyB, &eval);
+
+		// (the StdErr is of i.i.d. paths, which is conservative with the
+		// antithetic ones):
+		double px 		= df * eval.GetPx();
+		double stdErr = df * get<0>(eval.GetStats()) / sqrt(2.0 * double(P));
+		double d 			= px - pxsCF[j];
+		bool 	 okK 		= fabs(d) <= 4.0 * stdErr;
+		cout << "K = " << Ks[j] << ": MC = " << px << ", CF = " << pxsCF[j]
+				 << ", diff = " << d << " (" << d / stdErr << " StdErr)"
+				 << (okK ? "" : "  FAIL") << endl;
+		ok = ok && okK;
+	}
+
+	cout << (ok ? "OK" : "FAILED") << endl;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+//==========================================================================//
+//                               "Test9.cpp"                                //
+// Testing "Calibrator1D": recovering known GBM and CEV params from         //
+// synthetic implied vols                                                   //
+//--------------------------------------------------------------------------//
+// The quotes are USD/RUB OTM options of 3 expiries (3m, 6m, 1y) x 5        //
+// strikes (80% to 120% of S0). The GBM ones are the flat vol itself; the   //
+// CEV ones are the implied vols of the CEV prices of a Fwd grid run twice  //
+// as fine as the calibration one. The fits start from params 30% off       //
+//==========================================================================//
+
+#include "DiffusionGBM.h"
+#include "DiffusionCEV.h"
+#include "Calibrator1D.hpp"
+#include "IRProviderConst.h"
+
+#include <iostream>
+
+using namespace SiriusFM;
+using namespace std;
+
+namespace {
+	constexpr int NE = 3;
+	constexpr int NK = 5;
+	constexpr int NQ = NE * NK;
+
+	//------------------------------------------------------------------------//
+	// "MkQuotes": the strikes and expiries of the quotes, with the vol       //
+	// "a_vol" (to be overwritten, if not flat):                              //
+	//------------------------------------------------------------------------//
+	void MkQuotes(double a_S0, time_t a_t0, double a_vol, VolQuote* a_quotes,
+								time_t* a_expirs)
+	{
+		long days[NE] = {91, 182, 365};
+		for (int e = 0; e < NE; ++e) {
+			a_expirs[e] = a_t0 + SEC_IN_DAY * days[e];
+			for (int k = 0; k < NK; ++k)
+				a_quotes[e * NK + k] =
+					VolQuote{a_S0 * (0.8 + 0.1 * k), a_expirs[e], a_vol, 1.0};
+		}
+	}
+
+	//------------------------------------------------------------------------//
+	// "Check": prints the fitted and true params; true if they agree to      //
+	// "a_relTol":                                                            //
+	//------------------------------------------------------------------------//
+	bool Check(char const* a_name, int a_n, double const* a_fit,
+						 double const* a_true, double a_rmse, int a_iters,
+						 double a_relTol)
+	{
+		bool ok = true;
+		cout << a_name << ": " << a_iters << " iters, RMS vol error " << a_rmse;
+		for (int k = 0; k < a_n; ++k) {
+			double rel = fabs(a_fit[k] / a_true[k] - 1.0);
+			ok = ok && rel <= a_relTol;
+			cout << ", p" << k << " = " << a_fit[k] << " (true " << a_true[k]
+					 << ")";
+		}
+		cout << (ok ? "" : "  FAIL") << endl;
+		return ok;
+	}
+}
+
+int main(int argc, char** argv) {
+
+	if (argc != 6) {
+		cerr << "PARAMS:\nsigmaGBM,\nsigmaCEV, betaCEV,\nS0, ratesFile\n";
+		return 1;
+	}
+
+	double 			sigmaGBM 	= atof(argv[1]);
+	double 			sigmaCEV 	= atof(argv[2]);
+	double 			betaCEV 	= atof(argv[3]);
+	double 			S0 				= atof(argv[4]);
+	char const* ratesFile = 			argv[5];
+
+	if (sigmaGBM <= 0 || sigmaCEV <= 0 || betaCEV <= 0 || S0 <= 0)
+		throw invalid_argument("invalid params");
+
+	CcyE 		ccyA = CcyE::USD;
+	CcyE 		ccyB = CcyE::RUB;
+	time_t 	t0 	 = MkDate(2024, 1, 1);
+	VolQuote quotes[NQ];
+	time_t 	 expirs[NE];
+	bool 		 ok = true;
+	cout.precision(8);
+
+	//------------------------------------------------------------------------//
+	// GBM: the model vol is the flat one, up to the grid error:              //
+	//------------------------------------------------------------------------//
+	{
+		MkQuotes(S0, t0, sigmaGBM, quotes, expirs);
+		Calibrator1D<DiffusionGBM, IRPConst, IRPConst, CcyE, CcyE>
+			calib(ratesFile, ratesFile, ccyA, ccyB);
+
+		DiffusionGBM init(0.0, 1.3 * sigmaGBM, S0);
+		auto [fit, rmse, iters] = calib.Calibrate(init, quotes, NQ, S0, t0);
+
+		double pFit, pTrue = sigmaGBM;
+		fit.GetVolParams(&pFit);
+		ok = Check("GBM", 1, &pFit, &pTrue, rmse, iters, 1e-3) && ok;
+	}
+
+	//------------------------------------------------------------------------//
+	// CEV: the "market" vols are from a finer grid than the calibration one: //
+	//------------------------------------------------------------------------//
+	{
+		MkQuotes(S0, t0, 0.0, quotes, expirs);
+		DiffusionCEV cev(0.0, sigmaCEV, betaCEV, S0);
+		IRPConst 		 irp(ratesFile);
+
+		GridNOP1D_S3_RKC1<DiffusionCEV, IRPConst, IRPConst, CcyE, CcyE>
+			grid(ratesFile, ratesFile, 1024, 100'000);
+		CallOptionFX opt(ccyA, ccyB, S0, expirs[NE - 1], false);
+		grid.Run<true>(&opt, &cev, S0, t0, 600, 30, 4.5, 1.0, expirs, NE);
+
+		int 					M 	= grid.GetM();
+		double const* ts 	= grid.GetTs();
+		for (int e = 0; e < NE; ++e) {
+			double Ks[NK], calls[NK], puts[NK], pxs[NK], IVs[NK];
+			double S0s[NK], TTEs[NK], rAs[NK], rBs[NK];
+			bool 	 isCall[NK];
+			int j = int(lower_bound(ts, ts + M, YearFrac(expirs[e])) - ts);
+			for (int k = 0; k < NK; ++k) {
+				Ks[k] 	= quotes[e * NK + k].m_K;
+				S0s[k] 	= S0;
+				TTEs[k] = YearFracInt(expirs[e] - t0);
+				rAs[k] 	= irp.r(ccyA, 0.0);
+				rBs[k] 	= irp.r(ccyB, 0.0);
+			}
+			grid.GetEurPxsFwd(j, Ks, NK, calls, puts);
+			for (int k = 0; k < NK; ++k) {
+				isCall[k] = (Ks[k] >= S0 * exp((rBs[k] - rAs[k]) * TTEs[k]));
+				pxs[k] 		= isCall[k] ? calls[k] : puts[k];
+			}
+			BSMImplVolBatch(NK, isCall, pxs, S0s, Ks, TTEs, rAs, rBs, IVs);
+			for (int k = 0; k < NK; ++k)
+				quotes[e * NK + k].m_vol = IVs[k];
+		}
+
+		Calibrator1D<DiffusionCEV, IRPConst, IRPConst, CcyE, CcyE>
+			calib(ratesFile, ratesFile, ccyA, ccyB);
+
+		DiffusionCEV init(0.0, 1.3 * sigmaCEV, 0.7 * betaCEV, S0);
+		auto [fit, rmse, iters] = calib.Calibrate(init, quotes, NQ, S0, t0);
+
+		double pFit[2], pTrue[2] = {sigmaCEV, betaCEV};
+		fit.GetVolParams(pFit);
+		ok = Check("CEV", 2, pFit, pTrue, rmse, iters, 1e-2) && ok;
+	}
+
+	cout << (ok ? "OK" : "FAILED") << endl;
+	return ok ? 0 : 1;
+}
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <ctime>
+
 namespace SiriusFM {
 
 	constexpr int SEC_IN_MIN 		  		= 60;
@@ -20,4 +22,13 @@ namespace SiriusFM {
 	inline double YearFracInt(time_t a_t) {
 		return double(a_t) / AVG_SEC_IN_YEAR;
 	}
+
+	// Abs time (UTC) of the start of the day "a_year"-"a_month"-"a_day":
+	inline time_t MkDate(int a_year, int a_month, int a_day) {
+		struct tm tm = {};
+		tm.tm_year = a_year  - 1900;
+		tm.tm_mon  = a_month - 1;
+		tm.tm_mday = a_day;
+		return timegm(&tm);
+	}
 }
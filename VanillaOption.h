@@ -1,6 +1,7 @@
 //==========================================================================//
 //                             "VanillaOption.h"                            //
-// Declaration of Call- and Put-options (European/American but not Asian)   //
+// Declaration of Call- and Put-options (European/American but not Asian),  //
+// and of European Digital (cash-or-nothing) Calls and Puts                 //
 //==========================================================================//
 
 #pragma once
@@ -45,6 +46,23 @@ namespace SiriusFM {
 				assert(a_L > 0 && a_path != nullptr);
 				return std::max<double>(a_path[a_L - 1] - m_K, 0.0);
 			}
+
+			double Payoff(long a_L, float const* a_path,
+										double const* a_ts = nullptr) const override
+			{
+				assert(a_L > 0 && a_path != nullptr);
+				return std::max<double>(double(a_path[a_L - 1]) - m_K, 0.0);
+			}
+
+			double GetStrike() const override {
+				return m_K;
+			}
+
+			bool HashSpec(SpecHasher& a_h) const override {
+				this->HashBase(a_h);
+				a_h.Add("Call").Add(m_K);
+				return true;
+			}
 	};
 
 	//------------------------------------------------------------------------//
@@ -79,6 +97,123 @@ namespace SiriusFM {
 				assert(a_L > 0 && a_path != nullptr);
 				return std::max<double>(m_K - a_path[a_L - 1], 0.0);
 			}
+
+			double Payoff(long a_L, float const* a_path,
+										double const* a_ts = nullptr) const override
+			{
+				assert(a_L > 0 && a_path != nullptr);
+				return std::max<double>(m_K - double(a_path[a_L - 1]), 0.0);
+			}
+
+			double GetStrike() const override {
+				return m_K;
+			}
+
+			bool HashSpec(SpecHasher& a_h) const override {
+				this->HashBase(a_h);
+				a_h.Add("Put").Add(m_K);
+				return true;
+			}
+	};
+
+	//------------------------------------------------------------------------//
+	// European Digital Call: pays 1 (in B) if S(T) > K:                      //
+	//------------------------------------------------------------------------//
+	template<typename AssetClassA, typename AssetClassB>
+	class DigitalCallOption final: public Option<AssetClassA, AssetClassB> {
+		private:
+			double const m_K;
+		public:
+			DigitalCallOption
+			(
+				AssetClassA a_assetA,
+				AssetClassB a_assetB,
+				double a_K,
+				time_t a_expirTime
+			)
+			: Option<AssetClassA, AssetClassB>(a_assetA, a_assetB,
+						a_expirTime, false, false), // European, not Asian
+			  m_K(a_K)
+			{
+				if (m_K <= 0)
+					throw std::invalid_argument("K must be positive");
+			}
+
+			~DigitalCallOption() override {}
+
+			double Payoff(long a_L, double const* a_path,
+										double const* a_ts = nullptr) const override
+			{
+				assert(a_L > 0 && a_path != nullptr);
+				return (a_path[a_L - 1] > m_K) ? 1.0 : 0.0;
+			}
+
+			double Payoff(long a_L, float const* a_path,
+										double const* a_ts = nullptr) const override
+			{
+				assert(a_L > 0 && a_path != nullptr);
+				return (double(a_path[a_L - 1]) > m_K) ? 1.0 : 0.0;
+			}
+
+			double GetStrike() const override {
+				return m_K;
+			}
+
+			bool HashSpec(SpecHasher& a_h) const override {
+				this->HashBase(a_h);
+				a_h.Add("DigitalCall").Add(m_K);
+				return true;
+			}
+	};
+
+	//------------------------------------------------------------------------//
+	// European Digital Put: pays 1 (in B) if S(T) < K:                       //
+	//------------------------------------------------------------------------//
+	template<typename AssetClassA, typename AssetClassB>
+	class DigitalPutOption final: public Option<AssetClassA, AssetClassB> {
+		private:
+			double const m_K;
+		public:
+			DigitalPutOption
+			(
+				AssetClassA a_assetA,
+				AssetClassB a_assetB,
+				double a_K,
+				time_t a_expirTime
+			)
+			: Option<AssetClassA, AssetClassB>(a_assetA, a_assetB,
+						a_expirTime, false, false), // European, not Asian
+			  m_K(a_K)
+			{
+				if (m_K <= 0)
+					throw std::invalid_argument("K must be positive");
+			}
+
+			~DigitalPutOption() override {}
+
+			double Payoff(long a_L, double const* a_path,
+										double const* a_ts = nullptr) const override
+			{
+				assert(a_L > 0 && a_path != nullptr);
+				return (a_path[a_L - 1] < m_K) ? 1.0 : 0.0;
+			}
+
+			double Payoff(long a_L, float const* a_path,
+										double const* a_ts = nullptr) const override
+			{
+				assert(a_L > 0 && a_path != nullptr);
+				return (double(a_path[a_L - 1]) < m_K) ? 1.0 : 0.0;
+			}
+
+			double GetStrike() const override {
+				return m_K;
+			}
+
+			bool HashSpec(SpecHasher& a_h) const override {
+				this->HashBase(a_h);
+				a_h.Add("DigitalPut").Add(m_K);
+				return true;
+			}
 	};
 
 	//-----------------------------------------------------------------------//
@@ -87,4 +222,7 @@ namespace SiriusFM {
 	using CallOptionFX = CallOption<CcyE, CcyE>;
 	using PutOptionFX  = PutOption <CcyE, CcyE>;
 
+	using DigitalCallOptionFX = DigitalCallOption<CcyE, CcyE>;
+	using DigitalPutOptionFX 	= DigitalPutOption <CcyE, CcyE>;
+
 }
@@ -0,0 +1,187 @@
+//==========================================================================//
+//                            "WorkStealingPool.h"                          //
+// Thread pool running a batch of independent tasks of known (estimated)    //
+// costs, with per-worker deques and work stealing                          //
+//--------------------------------------------------------------------------//
+// The tasks are ordered by decreasing cost (LPT: Longest Processing Time   //
+// first) and dealt out to the deques of the workers, each task going to    //
+// the deque with the least total cost so far. A worker takes the tasks     //
+// from the front of its own deque; once it is empty, it steals the front   //
+// (ie the longest) task of the deque with the most cost left. So the long  //
+// tasks are always started first, and only the short ones remain for the   //
+// tail of the batch. Every deque has its own mutex: the tasks are coarse   //
+// (a whole MC or grid run each), so there is little contention on them     //
+//==========================================================================//
+
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <cassert>
+
+namespace SiriusFM {
+
+	class WorkStealingPool {
+		private:
+			//--------------------------------------------------------------------//
+			// Deque of task indices of a worker:                                 //
+			//--------------------------------------------------------------------//
+			struct WorkerQ {
+				std::mutex 			m_mtx;
+				std::deque<int> m_tasks; 	// by decreasing cost
+				double 					m_cost; 	// total cost of "m_tasks"
+			};
+
+			int const m_nThreads;
+
+		public:
+			// "a_nThreads" <= 0 means all hardware threads:
+			explicit WorkStealingPool(int a_nThreads)
+			: m_nThreads((a_nThreads > 0)
+					? a_nThreads
+					: std::max<int>(1, int(std::thread::hardware_concurrency())))
+			{}
+
+			int GetNThreads() const {
+				return m_nThreads;
+			}
+
+			//--------------------------------------------------------------------//
+			// "Run": runs "a_f(task, worker)" for all tasks in [0, "a_n") of the //
+			// costs "a_costs" and returns once all of them are done. The worker  //
+			// index in [0, GetNThreads()) allows "a_f" to keep per-thread state. //
+			// The first exception thrown by a task is re-thrown (the remaining   //
+			// tasks are then skipped):                                           //
+			//--------------------------------------------------------------------//
+			template<typename F>
+			void Run(int a_n, double const* a_costs, F const& a_f) const;
+
+		private:
+			// Pops a task of worker "a_w" (or steals one); -1 if none is left:
+			static int NextTask(WorkerQ* a_qs, int a_nQ, int a_w,
+													double const* a_costs);
+	};
+
+	//------------------------------------------------------------------------//
+	// "Run":                                                                 //
+	//------------------------------------------------------------------------//
+	template<typename F>
+	inline void WorkStealingPool::Run
+		(int a_n, double const* a_costs, F const& a_f) const
+	{
+		assert(a_n >= 0 && (a_n == 0 || a_costs != nullptr));
+		if (a_n == 0)
+			return;
+
+		int nW = std::min<int>(m_nThreads, a_n);
+
+		// LPT order, and the deal-out to the least-loaded deque:
+		std::vector<int> order(a_n);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(),
+			[a_costs](int a_i, int a_j) { return a_costs[a_i] > a_costs[a_j]; });
+
+		WorkerQ* qs = new WorkerQ[nW];
+		for (int w = 0; w < nW; ++w)
+			qs[w].m_cost = 0;
+
+		for (int i: order) {
+			int w = 0;
+			for (int v = 1; v < nW; ++v)
+				if (qs[v].m_cost < qs[w].m_cost)
+					w = v;
+			qs[w].m_tasks.push_back(i);
+			qs[w].m_cost += a_costs[i];
+		}
+
+		std::exception_ptr err 		= nullptr;
+		bool 							 failed = false;
+		std::mutex 				 errMtx;
+
+		auto work = [&](int a_w) {
+			for (int i; (i = NextTask(qs, nW, a_w, a_costs)) >= 0; ) {
+				{
+					std::lock_guard<std::mutex> lock(errMtx);
+					if (failed)
+						return;
+				}
+				try {
+					a_f(i, a_w);
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> lock(errMtx);
+					if (!failed) {
+						failed = true;
+						err 	 = std::current_exception();
+					}
+					return;
+				}
+			}
+		};
+
+		// the calling thread is worker 0:
+		std::vector<std::thread> threads;
+		threads.reserve(nW - 1);
+		for (int w = 1; w < nW; ++w)
+			threads.emplace_back(work, w);
+		work(0);
+		for (std::thread& th: threads)
+			th.join();
+
+		delete[] qs;
+		if (err != nullptr)
+			std::rethrow_exception(err);
+	}
+
+	//------------------------------------------------------------------------//
+	// "NextTask":                                                            //
+	//------------------------------------------------------------------------//
+	inline int WorkStealingPool::NextTask
+		(WorkerQ* a_qs, int a_nQ, int a_w, double const* a_costs)
+	{
+		// own deque first:
+		{
+			WorkerQ& q = a_qs[a_w];
+			std::lock_guard<std::mutex> lock(q.m_mtx);
+			if (!q.m_tasks.empty()) {
+				int i = q.m_tasks.front();
+				q.m_tasks.pop_front();
+				q.m_cost -= a_costs[i];
+				return i;
+			}
+		}
+		// steal: the victim is the deque with the most cost left; it may have
+		// changed by the time it is locked again, so it is re-checked then:
+		while (true) {
+			int 	 v 		= -1;
+			double maxC = 0;
+			for (int u = 0; u < a_nQ; ++u) {
+				if (u == a_w)
+					continue;
+				std::lock_guard<std::mutex> lock(a_qs[u].m_mtx);
+				if (!a_qs[u].m_tasks.empty() && (v < 0 || a_qs[u].m_cost > maxC)) {
+					v 	 = u;
+					maxC = a_qs[u].m_cost;
+				}
+			}
+			if (v < 0)
+				return -1; // all deques are empty: no new tasks can appear
+
+			WorkerQ& q = a_qs[v];
+			std::lock_guard<std::mutex> lock(q.m_mtx);
+			if (!q.m_tasks.empty()) {
+				int i = q.m_tasks.front();
+				q.m_tasks.pop_front();
+				q.m_cost -= a_costs[i];
+				return i;
+			}
+			// (the victim has been emptied meanwhile: look again)
+		}
+	}
+}